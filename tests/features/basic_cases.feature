@@ -76,7 +76,7 @@ Feature: Basic Request Tests
 
         Examples:
             | host       | default  |
-            | noone.com  | one.com  |
-            | notwo.com  | two.com  |
-            | notree.com | tree.com |
+            | noone.com  | cgi.com  |
+            | notwo.com  | cgi.com  |
+            | notree.com | cgi.com  |
 
@@ -0,0 +1,78 @@
+Feature: Chunked request bodies
+
+    Scenario Outline: Chunk extensions and trailers are accepted and skipped
+        Given open a raw connection to port "8183" with host "<host>"
+        When send a chunked "POST" of "lorem_ipsum.txt" named "chunked_<name>.txt" to "/" on the raw connection
+            | param_name | value      |
+            | chunk_size | <size>     |
+            | extension  | <ext>      |
+            | trailer    | <trailer>  |
+        Then read a raw response with status code "201"
+        Given set connection and headers for ip "127.0.0.1" port "8183" and domain "<host>"
+        When send a "GET" request to "/chunked_<name>.txt" using set up domain and headers and status code "200"
+        And I save html response as "posted_file"
+        And open "lorem_ipsum.txt" file and save its content in context with key "sent_file"
+            | param_name | value |
+            | read_mode  | read  |
+        Then the content of "posted_file" and "sent_file" context keys are equal
+        And send a "DELETE" request to "/chunked_<name>.txt" using set up domain and headers and status code "204"
+
+        Examples:
+            | host         | name      | size | ext                   | trailer                       |
+            | localhost    | extension | 100  | ;name=value           | X-Trailer: none               |
+            | fivehost.com | quoted    | 7    | ;a=1;b="quoted;value" | X-Checksum: 1234              |
+            | localhost    | trailers  | 4096 | ;last                 | X-One: 1\r\nX-Two: 2          |
+
+    Scenario Outline: A small body encoded in many more bytes than client_max_body_size is answered at once
+        Given open a raw connection to port "8182" with host "localhost"
+        When send a chunked "POST" of "lorem_short.txt" named "chunked_<name>.txt" to "/" on the raw connection
+            | param_name      | value     |
+            | chunk_size      | <size>    |
+            | extension       | ;n=1      |
+            | extension_bytes | <padding> |
+        Then read a raw response with status code "201"
+        Given set connection and headers for ip "127.0.0.1" port "8182" and domain "localhost"
+        When send a "GET" request to "/chunked_<name>.txt" using set up domain and headers and status code "200"
+        And I save html response as "posted_file"
+        And open "lorem_short.txt" file and save its content in context with key "sent_file"
+            | param_name | value |
+            | read_mode  | read  |
+        Then the content of "posted_file" and "sent_file" context keys are equal
+        And send a "DELETE" request to "/chunked_<name>.txt" using set up domain and headers and status code "204"
+
+        Examples:
+            | name     | size | padding |
+            | bytes    | 1    | 40      |
+            | padded   | 1    | 200     |
+            | extended | 4    | 1000    |
+
+    Scenario Outline: A chunked body over client_max_body_size gets a 413
+        Given open a raw connection to port "8182" with host "<host>"
+        When send chunks of "<sizes>" bytes as a chunked "POST" to "/" on the raw connection
+        Then read a raw response with status code "413"
+        And the raw response closes the connection
+
+        Examples:
+            | host         | sizes         |
+            | localhost    | 2048          |
+            | localhost    | 512,512,1     |
+            | fivehost.com | 100,1000      |
+
+    Scenario: A chunk size over the limit is refused before its data arrives
+        Given open a raw connection to port "8182" with host "localhost"
+        When send the chunked body "801\r\n" as a "POST" to "/" on the raw connection
+        Then read a raw response with status code "413"
+
+    Scenario Outline: A malformed chunked body gets a 400
+        Given open a raw connection to port "8183" with host "localhost"
+        When send the chunked body "<body>" as a "POST" to "/" on the raw connection
+        Then read a raw response with status code "400"
+        And the raw response closes the connection
+
+        Examples:
+            | body                          |
+            | zz\r\nhello\r\n0\r\n\r\n      |
+            | -5\r\nhello\r\n0\r\n\r\n      |
+            | 5\nhello\r\n0\r\n\r\n         |
+            | 5\r\nhelloX\r\n0\r\n\r\n      |
+            | \r\nhello\r\n0\r\n\r\n        |
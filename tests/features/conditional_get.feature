@@ -0,0 +1,68 @@
+Feature: Conditional GET requests
+
+    Scenario Outline: A resource sent again with its ETag gets a 304 without body
+        Given set connection and headers for ip "127.0.0.1" port "<port>" and domain "localhost"
+        And send a "GET" request to "/basic_request" using set up domain and headers and status code "200"
+        And I save the response header "ETag" as "etag"
+        And I save the response header "Last-Modified" as "last_modified"
+        When set the request header "If-None-Match" from the saved "etag"
+        And send a "GET" request to "/basic_request" using set up domain and headers and status code "304"
+        Then the response body is empty
+        And the response header "ETag" is the saved "etag"
+
+        Examples:
+            | port  |
+            | 8080  |
+            | 8081  |
+            | 9090  |
+
+    Scenario Outline: A resource not modified since its Last-Modified date gets a 304
+        Given set connection and headers for ip "127.0.0.1" port "<port>" and domain "localhost"
+        And send a "GET" request to "/basic_request" using set up domain and headers and status code "200"
+        And I save the response header "Last-Modified" as "last_modified"
+        When set the request header "If-Modified-Since" from the saved "last_modified"
+        And send a "GET" request to "/basic_request" using set up domain and headers and status code "304"
+        Then the response body is empty
+
+        Examples:
+            | port  |
+            | 8080  |
+            | 8081  |
+            | 9090  |
+
+    Scenario: A different ETag or an old date get the whole resource
+        Given set connection and headers for ip "127.0.0.1" port "8080" and domain "localhost"
+        When set the request header "If-None-Match" to ""not-the-etag""
+        And send a "GET" request to "/basic_request" using set up domain and headers and status code "200"
+        And I parse html response body
+        Then The response body content includes "h1" with content "This is a styled homepage to test from port 8080"
+        When remove the request header "If-None-Match"
+        And set the request header "If-Modified-Since" to "Thu, 01 Jan 1970 00:00:00 GMT"
+        Then send a "GET" request to "/basic_request" using set up domain and headers and status code "200"
+
+    Scenario: If-None-Match takes precedence over If-Modified-Since
+        Given set connection and headers for ip "127.0.0.1" port "8080" and domain "localhost"
+        And send a "GET" request to "/basic_request" using set up domain and headers and status code "200"
+        And I save the response header "Last-Modified" as "last_modified"
+        When set the request header "If-Modified-Since" from the saved "last_modified"
+        And set the request header "If-None-Match" to ""not-the-etag""
+        Then send a "GET" request to "/basic_request" using set up domain and headers and status code "200"
+
+    Scenario Outline: A changed file gets a 200 with the ETag saved before it changed
+        Given set connection and headers for ip "127.0.0.1" port "8183" and domain "<host>"
+        And send a "POST" of "lorem_ipsum.txt" named "conditional.txt" to "/" using set up domain and headers and status code "201"
+        And send a "GET" request to "/conditional.txt" using set up domain and headers and status code "200"
+        And I save the response header "ETag" as "etag"
+        And set the request header "If-None-Match" from the saved "etag"
+        And send a "GET" request to "/conditional.txt" using set up domain and headers and status code "304"
+        # Replace the file with different content under the same name
+        When send a "DELETE" request to "/conditional.txt" using set up domain and headers and status code "204"
+        And send a "POST" of "party.gif" named "conditional.txt" to "/" using set up domain and headers and status code "201"
+        Then send a "GET" request to "/conditional.txt" using set up domain and headers and status code "200"
+        And remove the request header "If-None-Match"
+        And send a "DELETE" request to "/conditional.txt" using set up domain and headers and status code "204"
+
+        Examples:
+            | host         |
+            | localhost    |
+            | fivehost.com |
@@ -0,0 +1,78 @@
+Feature: Pipelined requests
+
+    Scenario Outline: Requests sent in a single write are answered in order
+        Given open a raw connection to port "<port>" with host "localhost"
+        When send these requests in a single write on the raw connection
+            | method | location                  |
+            | GET    | /basic_request            |
+            | GET    | /not_found_pipelined.html |
+            | GET    | /basic_request/index.html |
+            | GET    | /autoindex                |
+            | GET    | /basic_request            |
+        Then the raw responses match the same requests sent one by one
+
+        Examples:
+            | port |
+            | 8080 |
+            | 8081 |
+            | 9090 |
+
+    Scenario Outline: Requests split across reads are answered in order
+        Given open a raw connection to port "8080" with host "localhost"
+        When send these requests in pieces of "<size>" bytes on the raw connection
+            | method | location                  |
+            | GET    | /basic_request            |
+            | GET    | /basic_request/index.html |
+            | GET    | /autoindex                |
+            | GET    | /basic_request            |
+        Then the raw responses match the same requests sent one by one
+
+        Examples:
+            | size |
+            | 1    |
+            | 7    |
+            | 50   |
+
+    Scenario: More requests than one batch are all answered
+        Given open a raw connection to port "8080" with host "localhost"
+        When send "40" "GET" requests to "/basic_request" in a single write on the raw connection
+        Then read "40" raw responses with status code "200"
+
+    Scenario: Responses over the byte budget of a batch are all answered
+        Given open a raw connection to port "8080" with host "localhost"
+        When send "6" "GET" requests to "/basic_request/img/party.gif" in a single write on the raw connection
+        Then read "6" raw responses with status code "200"
+
+    Scenario Outline: A request whose end is unknown closes the connection instead of reading its body as a new request
+        Given open a raw connection to port "8080" with host "localhost"
+        When send a "POST" to "/" with the header "<header>" and a pipelined "GET" of "/basic_request" on the raw connection
+        Then read a raw response with status code "<status_code>"
+        And the raw response closes the connection
+
+        Examples:
+            | header                                                     | status_code |
+            | Content-Length: 5x                                         | 400         |
+            | Content-Length: 1 0                                        | 400         |
+            | Content-Length: 99999999999999999999999                    | 400         |
+            | Content-Length:                                            | 400         |
+            | Content-Length: 0\r\nContent-Length: [PIPELINED_LENGTH]    | 400         |
+            | Content-Length: [PIPELINED_LENGTH]\r\nContent-Length: 0    | 400         |
+            | Content-Length: 0\r\nTransfer-Encoding: chunked            | 400         |
+            | Transfer-Encoding: chunked\r\nTransfer-Encoding: chunked   | 400         |
+            | Transfer-Encoding: xchunked                                | 501         |
+
+    Scenario: A request line that fails to parse closes a kept-alive connection
+        Given open a raw connection to port "8080" with host "localhost"
+        When send these requests in a single write on the raw connection
+            | method | location       |
+            | GET    | /basic_request |
+        Then read "1" raw responses with status code "200"
+        When send a "FOO" to "/" with the header "Content-Length: [PIPELINED_LENGTH]" and a pipelined "GET" of "/basic_request" on the raw connection
+        Then read a raw response with status code "400"
+        And the raw response closes the connection
+
+    Scenario: A failed request without a body keeps the next pipelined request
+        Given open a raw connection to port "8080" with host "localhost"
+        When send a "POST" to "/" with the header "Content-Length: 0" and a pipelined "GET" of "/basic_request" on the raw connection
+        Then read a raw response with status code "405"
+        And read a raw response with status code "200"
@@ -1,10 +1,13 @@
 
 import requests
+import socket
+import codecs
 import string
 import json
 import random
 import os
 import uuid
+import time
 from behave import step
 from bs4 import BeautifulSoup
 import warnings
@@ -42,6 +45,7 @@ def send_request_using_host(context, method, location, status_code):
     else:
         response = context.session.request(method.upper(), url)
     assert response.status_code == int(status_code), f"Wrong status code: {response.status_code}"
+    context.response = response
     context.html_content = response.text
     context.logger.debug(f"Response Body: {context.html_content}")
 
@@ -49,8 +53,9 @@ def send_request_using_host(context, method, location, status_code):
 def save_html_response(context, key):
     context.storage[key] = context.html_content
 
-def generate_chunks(file_path, boundary, mimetype="application/octet-stream", chunk_size=1024):
-    file_name = file_path.split("/")[-1]
+def generate_chunks(file_path, boundary, mimetype="application/octet-stream", chunk_size=1024, file_name=None):
+    if not file_name:
+        file_name = file_path.split("/")[-1]
 
     yield f"--{boundary}\r\n".encode()
     yield f"Content-Disposition: form-data; name=\"file\"; filename=\"{file_name}\"\r\n".encode()
@@ -127,3 +132,197 @@ def compare_context_keys(context, key1, key2):
     print(f"{context.storage[key1].strip()} \n---\n {context.storage[key2].strip()}")
     assert context.storage[key1].strip() == context.storage[key2].strip(), f"The content of {key1} and {key2} are not equal"
     context.logger.debug(f"Context keys {key1} and {key2} are equal")
+
+@step('send a "POST" of "{resource}" named "{name}" to "{location}" using set up domain and headers and status code "{status_code}"')
+def post_resource_with_name(context, resource, name, location, status_code):
+    url = f"{context.base_url}{location}"
+    with open(os.path.join(os.path.dirname(__file__), f"../../resources/{resource}"), "rb") as f:
+        response = context.session.request("POST", url, files={"file": (name, f)})
+    assert response.status_code == int(status_code), f"Wrong status code: {response.status_code}"
+    context.response = response
+    context.html_content = response.text
+
+@step('I save the response header "{header}" as "{key}"')
+def save_response_header(context, header, key):
+    value = context.response.headers.get(header)
+    assert value, f"Response header {header} not found"
+    context.storage[key] = value
+    context.logger.debug(f"Response header {header}: {value} saved as {key}")
+
+@step('set the request header "{header}" from the saved "{key}"')
+def set_request_header_from_storage(context, header, key):
+    context.session.headers.update({header: context.storage[key]})
+
+@step('set the request header "{header}" to "{value}"')
+def set_request_header(context, header, value):
+    context.session.headers.update({header: value})
+
+@step('remove the request header "{header}"')
+def remove_request_header(context, header):
+    context.session.headers.pop(header, None)
+
+@step('the response header "{header}" is the saved "{key}"')
+def compare_response_header(context, header, key):
+    value = context.response.headers.get(header)
+    assert value == context.storage[key], f"Response header {header} is {value}, expected {context.storage[key]}"
+
+@step('the response body is empty')
+def assert_empty_body(context):
+    assert context.response.content == b"", f"Unexpected body: {context.response.content[:80]}"
+
+def read_raw_response(context, method="GET"):
+    """Reads one HTTP response from the raw connection: status, headers and body."""
+    status_line = context.raw_file.readline()
+    assert status_line, "Connection closed before a response"
+    headers = {}
+    while True:
+        line = context.raw_file.readline().decode().rstrip("\r\n")
+        if not line:
+            break
+        name, value = line.split(":", 1)
+        headers[name.strip().lower()] = value.strip()
+    body = b""
+    if method != "HEAD":
+        if headers.get("transfer-encoding", "").lower() == "chunked":
+            while True:
+                size = int(context.raw_file.readline().split(b";")[0], 16)
+                if size == 0:
+                    context.raw_file.readline()
+                    break
+                body += context.raw_file.read(size)
+                context.raw_file.readline()
+        elif "content-length" in headers:
+            body = context.raw_file.read(int(headers["content-length"]))
+    response = {"status": int(status_line.split()[1]), "headers": headers, "body": body}
+    context.logger.debug(f"Raw response: {status_line} {headers}")
+    return response
+
+def send_raw(context, data):
+    try:
+        context.raw.sendall(data)
+    except OSError as e:
+        # The server may answer and close before the whole request is sent (413, 400).
+        context.logger.debug(f"Raw connection closed while sending: {e}")
+
+def chunked_head(context, method, location):
+    return (f"{method} {location} HTTP/1.1\r\nHost: {context.raw_host}\r\n"
+            f"Transfer-Encoding: chunked\r\n").encode()
+
+@step('open a raw connection to port "{port}" with host "{host}"')
+def open_raw_connection(context, port, host):
+    context.raw = socket.create_connection(("127.0.0.1", int(port)), timeout=10)
+    context.raw_file = context.raw.makefile("rb")
+    context.raw_host = host
+    context.logger.debug(f"Raw connection to port {port} and host {host}.")
+
+@step('send a chunked "{method}" of "{resource}" named "{name}" to "{location}" on the raw connection')
+def send_raw_chunked_file(context, method, resource, name, location):
+    params = map_table(context.table)
+    chunk_size = int(params.get("chunk_size", "1024"))
+    extension = params.get("extension", "")
+    if "extension_bytes" in params:
+        # Pads every size line, so the encoded body is far larger than the decoded one.
+        extension += ";pad=" + "x" * int(params["extension_bytes"])
+    boundary = f"------------------------{uuid.uuid4().hex}"
+    body = b"".join(generate_chunks(os.path.join(os.path.dirname(__file__), f"../../resources/{resource}"),
+                                    boundary, params.get("mimetype", "text/plain"), file_name=name))
+    data = chunked_head(context, method, location)
+    data += f"Content-Type: multipart/form-data; boundary={boundary}\r\n\r\n".encode()
+    for i in range(0, len(body), chunk_size):
+        chunk = body[i:i + chunk_size]
+        data += f"{len(chunk):x}{extension}\r\n".encode() + chunk + b"\r\n"
+    data += f"0{extension}\r\n".encode()
+    if "trailer" in params:
+        data += codecs.decode(params["trailer"], "unicode_escape").encode("latin-1") + b"\r\n"
+    data += b"\r\n"
+    send_raw(context, data)
+
+@step('send the chunked body "{body}" as a "{method}" to "{location}" on the raw connection')
+def send_raw_chunked_body(context, body, method, location):
+    data = chunked_head(context, method, location) + b"Content-Type: text/plain\r\n\r\n"
+    send_raw(context, data + codecs.decode(body, "unicode_escape").encode("latin-1"))
+
+@step('send chunks of "{sizes}" bytes as a chunked "{method}" to "{location}" on the raw connection')
+def send_raw_chunk_sizes(context, sizes, method, location):
+    data = chunked_head(context, method, location) + b"Content-Type: text/plain\r\n\r\n"
+    for size in sizes.split(","):
+        data += f"{int(size):x}\r\n".encode() + b"a" * int(size) + b"\r\n"
+    send_raw(context, data + b"0\r\n\r\n")
+
+@step('read a raw response with status code "{status_code}"')
+def read_raw_response_status(context, status_code):
+    context.raw_response = read_raw_response(context)
+    status = context.raw_response["status"]
+    assert status == int(status_code), f"Wrong status code: {status}"
+    context.html_content = context.raw_response["body"].decode("utf-8", "replace")
+
+@step('the raw response closes the connection')
+def raw_response_closes(context):
+    connection = context.raw_response["headers"].get("connection", "")
+    assert connection.lower() == "close", f"Connection header is {connection}"
+    assert context.raw_file.read(1) == b"", "The connection is still open"
+
+def raw_request(context, method, location, connection="keep-alive"):
+    # The server only keeps a connection open when asked to.
+    return (f"{method} {location} HTTP/1.1\r\nHost: {context.raw_host}\r\n"
+            f"Connection: {connection}\r\n\r\n").encode()
+
+def send_pipelined(context, requests_list, piece_size=None):
+    context.raw_requests = requests_list
+    data = b"".join(raw_request(context, method, location) for method, location in requests_list)
+    if not piece_size:
+        context.raw.sendall(data)
+        return
+    # Pieces are sent apart, so requests (and request lines) are split across reads.
+    context.raw.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    for i in range(0, len(data), piece_size):
+        context.raw.sendall(data[i:i + piece_size])
+        time.sleep(0.002)
+
+@step('send these requests in a single write on the raw connection')
+def send_requests_single_write(context):
+    send_pipelined(context, [(row["method"], row["location"]) for row in context.table])
+
+@step('send these requests in pieces of "{size}" bytes on the raw connection')
+def send_requests_in_pieces(context, size):
+    send_pipelined(context, [(row["method"], row["location"]) for row in context.table], int(size))
+
+@step('send "{count}" "{method}" requests to "{location}" in a single write on the raw connection')
+def send_repeated_requests(context, count, method, location):
+    send_pipelined(context, [(method, location)] * int(count))
+
+@step('the raw responses match the same requests sent one by one')
+def compare_pipelined_responses(context):
+    raw, raw_file = context.raw, context.raw_file
+    for index, (method, location) in enumerate(context.raw_requests):
+        pipelined = read_raw_response(context, method)
+        context.raw = socket.create_connection(raw.getpeername(), timeout=10)
+        context.raw_file = context.raw.makefile("rb")
+        context.raw.sendall(raw_request(context, method, location, "close"))
+        alone = read_raw_response(context, method)
+        context.raw.close()
+        context.raw, context.raw_file = raw, raw_file
+        assert pipelined["status"] == alone["status"], \
+            f"Response {index} ({method} {location}): {pipelined['status']} instead of {alone['status']}"
+        assert pipelined["body"] == alone["body"], f"Response {index} ({method} {location}): different body"
+        assert pipelined["headers"].get("content-length") == alone["headers"].get("content-length"), \
+            f"Response {index} ({method} {location}): different Content-Length"
+
+@step('read "{count}" raw responses with status code "{status_code}"')
+def read_raw_responses(context, count, status_code):
+    for index in range(int(count)):
+        method, location = context.raw_requests[index]
+        response = read_raw_response(context, method)
+        assert response["status"] == int(status_code), f"Response {index}: wrong status code {response['status']}"
+        if index > 0:
+            assert response["body"] == context.raw_response["body"], f"Response {index}: different body"
+        context.raw_response = response
+
+@step('send a "{method}" to "{location}" with the header "{header}" and a pipelined "GET" of "{pipelined}" on the raw connection')
+def send_request_smuggling(context, method, location, header, pipelined):
+    # The pipelined GET is the body of the first request, or the next request if its end is misread.
+    smuggled = raw_request(context, "GET", pipelined)
+    header = codecs.decode(header, "unicode_escape").replace("[PIPELINED_LENGTH]", str(len(smuggled)))
+    first = (f"{method} {location} HTTP/1.1\r\nHost: {context.raw_host}\r\n"
+             f"Connection: keep-alive\r\n{header}\r\n\r\n").encode("latin-1")
+    send_raw(context, first + smuggled)
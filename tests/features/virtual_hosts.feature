@@ -0,0 +1,51 @@
+Feature: Virtual Hosts
+
+    Scenario Outline: A wildcard name serves any subdomain
+        Given set connection and headers for ip "127.0.0.1" port "8181" and domain "<host>"
+        And send a "GET" request to "/" using set up domain and headers and status code "200"
+        When I parse html response body
+        Then The response body content includes "h1" with content "This is a styled homepage to test from port 8181 and host *.wild.com"
+
+        Examples:
+            | host                |
+            | a.wild.com          |
+            | deep.sub.wild.com   |
+            | A.Wild.COM          |
+            | a.wild.com:8181     |
+            | a.wild.com.         |
+
+    Scenario Outline: An exact name wins over a wildcard matching it
+        Given set connection and headers for ip "127.0.0.1" port "8181" and domain "<host>"
+        And send a "GET" request to "/" using set up domain and headers and status code "200"
+        When I parse html response body
+        Then The response body content includes "h1" with content "This is a styled homepage to test from port 8181 and host exact.wild.com"
+
+        Examples:
+            | host                |
+            | exact.wild.com      |
+            | EXACT.wild.com:8181 |
+
+    Scenario Outline: A host is served by the most specific name matching it
+        Given set connection and headers for ip "127.0.0.1" port "8181" and domain "<host>"
+        And send a "GET" request to "/" using set up domain and headers and status code "200"
+        When I parse html response body
+        Then The response body content includes "h1" with content "This is a styled homepage to test from port 8181 and host <served>"
+
+        Examples:
+            | host                 | served     |
+            | sub.exact.wild.com   | *.wild.com |
+            | one.com              | one.com    |
+
+    Scenario Outline: An unknown host is served by the default server of the port
+        Given set connection and headers for ip "127.0.0.1" port "8181" and domain "<host>"
+        And send a "GET" request to "/" using set up domain and headers and status code "200"
+        When I parse html response body
+        Then The response body content includes "h1" with content "This is a styled homepage to test from port 8181 and host cgi.com"
+
+        Examples:
+            | host        |
+            | unknown.org |
+            | wild.com    |
+            | noone.com   |
+            | one.com.org |
+            | localhost   |
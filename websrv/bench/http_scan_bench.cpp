@@ -0,0 +1,160 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   http_scan_bench.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 21:40:12 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 21:40:12 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "http_scan.hpp"
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+
+/**
+ * @brief Microbenchmark of the request scanning kernels (`make bench`).
+ *
+ * Each case times the `std::string` search the request parser used before
+ * `http_scan` against the kernel that replaced it, on the same buffer, and
+ * checks that both find the same offsets:
+ * - `header, 64-byte reads`: the header arrives in small reads. The old reader
+ *   searched the whole buffer after every read; `ws_find_header_end` resumes.
+ * - `header, one shot`: end of a header already complete.
+ * - `LF + colon walk`: every line feed and colon of the header block, as
+ *   `HttpHeaderIndex::index` walks it.
+ *
+ * Usage: `./http_scan_bench [header bytes] [rounds]` (8192 and 2000 by default).
+ */
+
+static volatile size_t g_sink = 0;
+
+static double now_usec() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3);
+}
+
+/**
+ * @brief Request header of about `size` bytes, ended by "\r\n\r\n".
+ */
+static std::string build_header(size_t size) {
+	std::ostringstream header;
+	header << "GET /index.html HTTP/1.1\r\nHost: localhost:8080\r\n";
+	for (int line = 0; header.str().size() + 64 < size; line++) {
+		header << "X-Bench-Header-" << line << ": value-" << line
+			   << "; token=abcdefghijklmnopqrstuvwxyz\r\n";
+	}
+	header << "\r\n";
+	return (header.str());
+}
+
+static size_t incremental_find(const std::string& header, size_t step) {
+	std::string buffer;
+	size_t found = std::string::npos;
+	for (size_t i = 0; i < header.size() && found == std::string::npos; i += step) {
+		buffer.append(header, i, step);
+		found = buffer.find("\r\n\r\n");
+	}
+	return (found);
+}
+
+static size_t incremental_scan(const std::string& header, size_t step) {
+	std::string buffer;
+	size_t resume = 0;
+	size_t found = std::string::npos;
+	for (size_t i = 0; i < header.size() && found == std::string::npos; i += step) {
+		buffer.append(header, i, step);
+		found = ws_find_header_end(buffer.data(), buffer.size(), resume);
+	}
+	return (found);
+}
+
+static size_t walk_find(const std::string& header) {
+	size_t sum = 0;
+	size_t pos = header.find_first_of("\n:");
+	while (pos != std::string::npos) {
+		sum += pos;
+		pos = header.find_first_of("\n:", pos + 1);
+	}
+	return (sum);
+}
+
+static size_t walk_scan(const std::string& header) {
+	static const t_scan_set separators = ws_scan_set("\n:");
+	const char* base = header.data();
+	size_t size = header.size();
+	size_t sum = 0;
+	size_t pos = ws_scan(base, size, separators);
+	while (pos < size) {
+		sum += pos;
+		pos += 1 + ws_scan(base + pos + 1, size - pos - 1, separators);
+	}
+	return (sum);
+}
+
+/**
+ * @brief Times `rounds` calls of both variants and prints them side by side.
+ *
+ * @return `false` if the variants disagree.
+ */
+static bool run_case(const char* name, size_t (*old_fn)(const std::string&),
+					 size_t (*new_fn)(const std::string&),
+					 const std::string& header, int rounds) {
+	size_t expected = old_fn(header);
+	size_t result = new_fn(header);
+	double start = now_usec();
+	for (int i = 0; i < rounds; i++) {
+		g_sink += old_fn(header);
+	}
+	double old_time = (now_usec() - start) / rounds;
+	start = now_usec();
+	for (int i = 0; i < rounds; i++) {
+		g_sink += new_fn(header);
+	}
+	double new_time = (now_usec() - start) / rounds;
+	std::printf("%-24s %10.2f us %10.2f us %8.1fx%s\n", name, old_time, new_time,
+				new_time > 0 ? old_time / new_time : 0.0,
+				expected == result ? "" : "  MISMATCH");
+	return (expected == result);
+}
+
+static size_t split_find(const std::string& header) {
+	return (incremental_find(header, 64));
+}
+
+static size_t split_scan(const std::string& header) {
+	return (incremental_scan(header, 64));
+}
+
+static size_t once_find(const std::string& header) {
+	return (header.find("\r\n\r\n"));
+}
+
+static size_t once_scan(const std::string& header) {
+	size_t resume = 0;
+	return (ws_find_header_end(header.data(), header.size(), resume));
+}
+
+int main(int argc, char** argv) {
+	size_t size = argc > 1 ? (size_t)std::atol(argv[1]) : 8192;
+	int rounds = argc > 2 ? std::atoi(argv[2]) : 2000;
+	if (size < 128 || rounds < 1) {
+		std::fprintf(stderr, "Usage: %s [header bytes >= 128] [rounds >= 1]\n", argv[0]);
+		return (1);
+	}
+	std::string header = build_header(size);
+	std::printf("kernel: %s, header: %lu bytes, rounds: %d\n\n", ws_scan_kernel(),
+				(unsigned long)header.size(), rounds);
+	std::printf("%-24s %13s %13s %9s\n", "case", "std::string", "http_scan", "speedup");
+	bool same = true;
+	same = run_case("header, 64-byte reads", split_find, split_scan, header, rounds) && same;
+	same = run_case("header, one shot", once_find, once_scan, header, rounds) && same;
+	same = run_case("LF + colon walk", walk_find, walk_scan, header, rounds) && same;
+	return (same ? 0 : 1);
+}
@@ -0,0 +1,82 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BinaryUpgrade.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 18:05:37 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 18:05:37 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _BINARY_UPGRADE_HPP_
+#define _BINARY_UPGRADE_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <csignal>
+#include <sys/types.h>
+#include "webserver.hpp"
+#include "Logger.hpp"
+
+#define BU_NAME "BinaryUpgrade"
+// Listening sockets handed to the new binary: "port:fd,port:fd".
+#define BU_LISTENERS_ENV "WEBSERVER_LISTENERS"
+// Pid of the process to drain once the new binary is ready.
+#define BU_PARENT_ENV "WEBSERVER_UPGRADE_FROM"
+
+/**
+ * @class BinaryUpgrade
+ * @brief Zero-downtime binary upgrade: hands the listening sockets to a new executable.
+ *
+ * On `SIGUSR2` the running server (the master, with `worker_processes`) forks
+ * and executes its binary again, with the same arguments. The listening
+ * sockets are inherited by the new process: their descriptors are listed in
+ * `WEBSERVER_LISTENERS`, and the pid of the old process in
+ * `WEBSERVER_UPGRADE_FROM`.
+ *
+ * The new process adopts the sockets of the ports it still serves
+ * (`ServerConfig::listen_fd`) instead of binding them, so no connection is
+ * refused meanwhile. Once its servers are built, it sends `SIGQUIT` to the old
+ * process, which drains: it stops accepting, closes its idle keep-alive
+ * connections, answers the requests in progress with `Connection: close` and
+ * exits when no client is left.
+ *
+ * @details
+ * - Everything `start` needs (paths, arguments, environment) is prepared
+ *   beforehand by `prepare`: `start` runs inside the signal handler and only
+ *   makes async-signal-safe calls.
+ * - A new binary that fails to start never signals the old process, which
+ *   keeps serving. A second `SIGUSR2` is ignored while the previous new
+ *   process runs, and once the old process is draining.
+ */
+class BinaryUpgrade {
+	private:
+		const Logger*               _log;
+		std::vector<std::string>    _args;
+		std::vector<std::string>    _env;
+		std::vector<char*>          _argv;
+		std::vector<char*>          _envp;
+		std::vector<int>            _fds;
+		pid_t                       _parent;
+		volatile pid_t              _child;
+		volatile sig_atomic_t       _disabled;
+
+		static bool is_listener(int fd, int port);
+
+		BinaryUpgrade(const BinaryUpgrade&);
+		BinaryUpgrade& operator=(const BinaryUpgrade&);
+	public:
+		BinaryUpgrade(int argc, char** argv, const Logger* logger);
+		~BinaryUpgrade();
+		void inherit(std::vector<ServerConfig>& configs);
+		void release_inherited(std::vector<ServerConfig>& configs);
+		void prepare(const std::map<int, int>& listeners);
+		void notify_parent();
+		void start();
+		void disable();
+};
+
+#endif
@@ -0,0 +1,93 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ChunkedDecoder.hpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 22:10:36 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 22:10:36 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _CHUNKED_DECODER_HPP_
+#define _CHUNKED_DECODER_HPP_
+
+#include <string>
+#include <cstddef>
+
+// Longest chunk size line (size and extensions) accepted.
+#define CHUNK_LINE_MAX 4096
+// Longest trailer section accepted.
+#define CHUNK_TRAILER_MAX 16384
+
+/**
+ * @brief Result of feeding bytes to a ChunkedDecoder.
+ *
+ * - `CHUNK_MORE`: every byte was consumed, the body is not complete yet.
+ * - `CHUNK_DONE`: the last chunk and the trailers were read.
+ * - `CHUNK_BAD`: the stream is not valid chunked encoding.
+ * - `CHUNK_TOO_LARGE`: the body goes beyond the allowed size.
+ */
+typedef enum e_chunk_status {
+	CHUNK_MORE=0,
+	CHUNK_DONE=1,
+	CHUNK_BAD=2,
+	CHUNK_TOO_LARGE=3
+} t_chunk_status;
+
+/**
+ * @brief Position of the decoder inside the chunked stream.
+ */
+typedef enum e_chunk_state {
+	CK_SIZE=0,
+	CK_EXTENSION,
+	CK_SIZE_LF,
+	CK_DATA,
+	CK_DATA_CR,
+	CK_DATA_LF,
+	CK_TRAILER,
+	CK_TRAILER_LINE,
+	CK_TRAILER_LF,
+	CK_END_LF,
+	CK_DONE,
+	CK_ERROR
+} t_chunk_state;
+
+/**
+ * @class ChunkedDecoder
+ * @brief Incremental decoder of the chunked transfer coding (RFC 9112, 7.1).
+ *
+ * Bytes are fed as they arrive, in pieces of any size. The decoder keeps its
+ * position in the stream between calls, appends chunk payloads to the body as
+ * soon as they are received and consumes everything it was given, so the read
+ * buffer never holds more than the last read. Each byte is looked at once:
+ * time and memory are linear in the body size.
+ *
+ * @details
+ * - Chunk extensions are skipped. Trailer fields are read and discarded.
+ * - The body limit is checked against each announced chunk size, before its
+ *   payload arrives.
+ * - Size lines and the trailer section have fixed bounds (CHUNK_LINE_MAX,
+ *   CHUNK_TRAILER_MAX).
+ * - Once `CHUNK_DONE` is returned, bytes past the end of the body are left
+ *   unconsumed (they belong to the next request).
+ */
+class ChunkedDecoder {
+	private:
+		t_chunk_state   _state;
+		size_t          _max_body;
+		size_t          _chunk_left;
+		size_t          _digits;
+		size_t          _line;
+		size_t          _trailer;
+
+		t_chunk_status fail(t_chunk_status status);
+	public:
+		ChunkedDecoder();
+		void reset(size_t max_body);
+		t_chunk_status feed(const char* data, size_t length, size_t& consumed, std::string& body);
+		bool done() const;
+};
+
+#endif
@@ -15,6 +15,10 @@
 
 #include "SocketHandler.hpp"
 #include "Logger.hpp"
+#include "EventBackend.hpp"
+#include "TimerWheel.hpp"
+#include "OutputQueue.hpp"
+#include "ChunkedDecoder.hpp"
 #include <poll.h>
 #include <unistd.h>
 #include <ctime>
@@ -22,6 +26,29 @@
 # define CD_MODULE "ClientData"
 # define TIMEOUT_REQUEST 10
 # define TIMEOUT_CLIENT 10
+// Deadlines of each connection phase, in milliseconds.
+# define TIMEOUT_HEADER_MS 10000
+# define TIMEOUT_BODY_MS 10000
+# define TIMEOUT_KEEPALIVE_MS 10000
+# define TIMEOUT_SEND_MS 10000
+# define TIMEOUT_IO_MS 30000
+
+/**
+ * @brief Phase a connection's timer is guarding.
+ *
+ * - `DEADLINE_HEADER`: from connection (or first byte of a new request) until the header is complete.
+ * - `DEADLINE_BODY`: while the request body is being received.
+ * - `DEADLINE_KEEPALIVE`: idle time between requests of a persistent connection.
+ * - `DEADLINE_SEND`: while a response is waiting to be written.
+ * - `DEADLINE_IO`: while the response waits for an `IoTask` of the I/O pool.
+ */
+typedef enum e_deadline {
+	DEADLINE_HEADER=0,
+	DEADLINE_BODY=1,
+	DEADLINE_KEEPALIVE=2,
+	DEADLINE_SEND=3,
+	DEADLINE_IO=4
+} t_deadline;
 
 /**
  * @class ClientData
@@ -39,17 +66,29 @@ class ClientData {
 		const Logger*           _log;
 	    bool                    _active;
 		bool                    _alive;
-		struct pollfd           _client_fd;
+		int                     _client_fd;
+		t_event_tag             _event_tag;
+		int                     _interest;
+		t_timer_node            _timer;
 	    std::time_t             _timestamp;
 		s_request               _request;
+		std::string             _read_buffer;
+		OutputQueue             _output;
+		ChunkedDecoder          _chunked;
 		short                   _state;
+		bool                    _read_pending;
+		IoTask*                 _io_task;
 
 	public:
 		ClientData(SocketHandler* server, const Logger* log, int fd);
 	    ~ClientData();
 		void close_fd();
 		SocketHandler* get_server();
-		struct pollfd get_fd();
+		int get_fd() const;
+		t_event_tag* event_tag();
+		t_timer_node* timer();
+		t_deadline deadline_kind() const;
+		static t_msec deadline_span(t_deadline kind);
 		bool chronos_request();
 		void chronos_reset();
 		bool chronos_connection();
@@ -59,8 +98,18 @@ class ClientData {
 		bool is_active() const;
 		void keep_active();
 		s_request& client_request();
+		std::string& read_buffer();
+		bool read_pending() const;
+		void set_read_pending(bool pending);
+		OutputQueue& output();
+		ChunkedDecoder& chunk_decoder();
+		int interest() const;
+		void set_interest(int events);
 		void set_state(short state);
 		short get_state() const;
+		void suspend(IoTask* task);
+		void resume();
+		IoTask* io_task() const;
 };
 
 #endif
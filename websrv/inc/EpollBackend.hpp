@@ -0,0 +1,56 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EpollBackend.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:58:13 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 10:58:13 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _EPOLL_BACKEND_HPP_
+#define _EPOLL_BACKEND_HPP_
+
+#include "EventBackend.hpp"
+
+#ifdef __linux__
+# include <sys/epoll.h>
+# define WS_HAS_EPOLL 1
+
+# define EP_NAME "EpollBackend"
+# define EP_MAX_EVENTS 1024
+
+/**
+ * @class EpollBackend
+ * @brief Edge-triggered EventBackend built on epoll(7). Linux only.
+ *
+ * The registered t_event_tag pointer travels in `epoll_event.data.ptr`, so
+ * the kernel returns the owner of every ready descriptor directly. Readiness
+ * is O(ready) instead of O(registered), and with EPOLLET each transition is
+ * reported once, so the loop is not woken again for a socket that is still
+ * writable or still holds data the caller already decided to leave for later.
+ */
+class EpollBackend : public EventBackend {
+	private:
+		int                             _epoll_fd;
+		std::vector<struct epoll_event> _events;
+		const Logger*                   _log;
+
+		static uint32_t to_epoll(int events);
+		bool control(int op, int fd, int events, t_event_tag* tag);
+	public:
+		EpollBackend(const Logger* log);
+		~EpollBackend();
+		bool add(int fd, int events, t_event_tag* tag);
+		bool modify(int fd, int events, t_event_tag* tag);
+		bool remove(int fd);
+		int wait(std::vector<t_event>& ready, int timeout_ms);
+		bool edge_triggered() const;
+		const char* name() const;
+};
+
+#endif
+
+#endif
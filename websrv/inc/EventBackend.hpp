@@ -0,0 +1,88 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventBackend.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:31:07 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 10:31:07 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _EVENT_BACKEND_HPP_
+#define _EVENT_BACKEND_HPP_
+
+#include <vector>
+#include "webserver.hpp"
+#include "Logger.hpp"
+
+#define EB_NAME "EventBackend"
+#define WS_EV_READ  0x01
+#define WS_EV_WRITE 0x02
+#define WS_EV_HUP   0x04
+#define WS_EV_ERROR 0x08
+
+/**
+ * @brief Kind of object that owns a file descriptor registered in the event loop.
+ */
+typedef enum e_event_source {
+	EV_LISTENER=0,
+	EV_CLIENT=1,
+	EV_WAKEUP=2,
+	EV_WATCHER=3,
+	EV_IO=4
+} t_event_source;
+
+/**
+ * @brief Data attached to every registered file descriptor.
+ *
+ * Each owner (SocketHandler, ClientData...) keeps its own tag, and the backend
+ * hands the very same pointer back on every event. This way the event loop
+ * resolves the owner of a ready fd with a single dereference, without any
+ * fd->index or fd->owner lookup.
+ */
+typedef struct s_event_tag {
+	t_event_source  source;
+	void*           owner;
+	s_event_tag(t_event_source s, void* o): source(s), owner(o) {};
+} t_event_tag;
+
+/**
+ * @brief A ready file descriptor, as reported by EventBackend::wait.
+ *
+ * `events` is a combination of WS_EV_* flags.
+ */
+typedef struct s_event {
+	int             events;
+	t_event_tag*    tag;
+} t_event;
+
+/**
+ * @class EventBackend
+ * @brief Readiness notification interface used by ServerManager.
+ *
+ * Implementations wrap a kernel multiplexing facility (poll, epoll...). The
+ * backend is chosen once at startup through EventBackend::create, using the
+ * `event_backend` global directive.
+ *
+ * @details
+ * - Interest is expressed with WS_EV_READ / WS_EV_WRITE flags.
+ * - Hang-up and error conditions are always reported, even if not requested.
+ * - Edge-triggered backends report a condition once per transition. A caller
+ *   that stops reading before EAGAIN must re-arm the descriptor with `modify`,
+ *   which makes the backend re-evaluate its readiness.
+ */
+class EventBackend {
+	public:
+		virtual ~EventBackend() {};
+		virtual bool add(int fd, int events, t_event_tag* tag) = 0;
+		virtual bool modify(int fd, int events, t_event_tag* tag) = 0;
+		virtual bool remove(int fd) = 0;
+		virtual int wait(std::vector<t_event>& ready, int timeout_ms) = 0;
+		virtual bool edge_triggered() const = 0;
+		virtual const char* name() const = 0;
+		static EventBackend* create(t_event_backend kind, const Logger* log);
+};
+
+#endif
@@ -0,0 +1,109 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   FileWatcher.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 23:05:12 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 23:05:12 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _FILE_WATCHER_HPP_
+#define _FILE_WATCHER_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "webserver.hpp"
+#include "Logger.hpp"
+
+#define FW_NAME "FileWatcher"
+// Directories watched at most by a worker. Deeper trees rely on the cache validity alone.
+#define FW_MAX_WATCHES 8192
+// Bytes read from the inotify descriptor at once.
+#define FW_READ_BUFFER 16384
+
+/**
+ * @brief What happened to a path reported by `FileWatcher`.
+ *
+ * - `CHANGE_CONTENT`: a file was written, or its attributes changed.
+ * - `CHANGE_NAME`: an entry was created, deleted or moved, in or out.
+ * - `CHANGE_RESET`: events were lost, or a watched directory was moved:
+ *   any cached path may be stale. `path` is empty.
+ */
+typedef enum e_file_change {
+	CHANGE_CONTENT=0,
+	CHANGE_NAME=1,
+	CHANGE_RESET=2
+} t_file_change;
+
+typedef struct s_file_event {
+	t_file_change   change;
+	std::string     path;
+	s_file_event(t_file_change c, const std::string& p): change(c), path(p) {};
+} t_file_event;
+
+/**
+ * @brief A watched directory: its path and the generation of its last entry change.
+ */
+typedef struct s_watch {
+	std::string     path;
+	uint64_t        generation;
+	s_watch(): path(), generation(0) {};
+} t_watch;
+
+/**
+ * @class FileWatcher
+ * @brief Reports changes below the served trees, through inotify.
+ *
+ * Each worker owns one watcher, registered in its event loop. Every directory
+ * of the watched trees gets an inotify watch; directories created later are
+ * watched as soon as they are reported, and the entries they already hold are
+ * reported as created, so none is missed.
+ *
+ * Cached routes depend on the entries of a directory: each watch carries a
+ * generation, renewed whenever an entry of the directory is created, deleted
+ * or moved. A cache entry keeps the `t_watch_stamp` of the directory it was
+ * resolved from, and is current while the generation did not move.
+ *
+ * @details
+ * - Paths are cleaned (`clean_path`) so they match the cache keys.
+ * - Symbolic links are not followed into.
+ * - Past FW_MAX_WATCHES directories, or where inotify is not available, paths
+ *   get no stamp and caches fall back to their validity time.
+ * - Not thread safe: used by the worker owning it only.
+ */
+class FileWatcher {
+	private:
+		int                             _fd;
+		const Logger*                   _log;
+		std::map<int, t_watch>          _watches;
+		std::map<std::string, int>      _paths;
+		uint64_t                        _generation;
+		bool                            _full;
+
+		void watch_dir(const std::string& path, std::vector<t_file_event>* found);
+		void unwatch_tree(const std::string& path);
+		void forget(int wd);
+		void bump(int wd);
+
+		FileWatcher(const FileWatcher&);
+		FileWatcher& operator=(const FileWatcher&);
+	public:
+		explicit FileWatcher(const Logger* log);
+		~FileWatcher();
+		bool start();
+		bool active() const;
+		int get_fd() const;
+		void watch_tree(const std::string& root);
+		bool read_events(std::vector<t_file_event>& events);
+		t_watch_stamp stamp(const std::string& dir) const;
+		bool current(const t_watch_stamp& stamp) const;
+		void invalidate_all();
+		size_t size() const;
+};
+
+#endif
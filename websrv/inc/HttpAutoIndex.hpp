@@ -24,11 +24,14 @@
  * a response that contains a directory index when requested.
  * It includes methods for reading the content of a directory and generating
  * the appropriate response.
+ *
+ * The directory is read by an `IoListDir` task, offloaded to the worker's I/O
+ * pool: the page is built in `resume`, from the listed entries.
  */
 class HttpAutoIndex : public WsResponseHandler {
 	private:
 		virtual void get_file_content(int pid, int (&fd)[2]);
-		virtual void get_file_content(std::string& path);
+		void build_index(const IoListDir& listing);
 	public:
 		HttpAutoIndex (const LocationConfig *location,
 					   const Logger *log,
@@ -36,6 +39,7 @@ class HttpAutoIndex : public WsResponseHandler {
 					   s_request& request,
 					   int fd);
 		bool handle_request();
+		bool resume(IoTask* task);
 };
 
 #endif
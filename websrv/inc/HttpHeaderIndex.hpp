@@ -0,0 +1,87 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   HttpHeaderIndex.hpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 20:14:03 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 20:14:03 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _HTTP_HEADER_INDEX_HPP_
+#define _HTTP_HEADER_INDEX_HPP_
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief Request headers the server looks at, used as index of HttpHeaderIndex.
+ */
+typedef enum e_header_id {
+	HDR_HOST=0,
+	HDR_CONTENT_LENGTH,
+	HDR_CONTENT_TYPE,
+	HDR_TRANSFER_ENCODING,
+	HDR_RANGE,
+	HDR_CONNECTION,
+	HDR_COOKIE,
+	HDR_REFERER,
+	HDR_IF_NONE_MATCH,
+	HDR_IF_MODIFIED_SINCE,
+	HDR_COUNT,
+	HDR_UNKNOWN=HDR_COUNT
+} t_header_id;
+
+/**
+ * @brief Position of a header value inside the header block.
+ */
+typedef struct s_header_field {
+	size_t  offset;
+	size_t  length;
+	bool    present;
+	bool    repeated;
+	s_header_field(): offset(0), length(0), present(false), repeated(false) {};
+} t_header_field;
+
+/**
+ * @class HttpHeaderIndex
+ * @brief Single pass index of the known fields of a request header block.
+ *
+ * `index` walks the header block once, line by line. Each field name is
+ * matched, case-insensitively and as a whole name, against the known headers
+ * (`t_header_id`); for known ones the offset and length of the value, without
+ * surrounding whitespace, are recorded. Lookups are then array accesses that
+ * copy nothing, until the caller asks for a `std::string`.
+ *
+ * @details
+ * - The request line (first line) is skipped.
+ * - Lines may end with CRLF or a bare LF.
+ * - When a header is repeated, the first occurrence wins, and `repeated`
+ *   reports it (a repeated `Content-Length` makes the body length ambiguous).
+ * - The indexed block must not change while the index is used.
+ */
+class HttpHeaderIndex {
+	private:
+		const std::string*  _block;
+		t_header_field      _fields[HDR_COUNT];
+
+		void record(const char* base, const char* line, const char* colon, const char* end);
+
+		HttpHeaderIndex(const HttpHeaderIndex&);
+		HttpHeaderIndex& operator=(const HttpHeaderIndex&);
+	public:
+		HttpHeaderIndex();
+		void index(const std::string& block);
+		void clear();
+		static t_header_id lookup(const char* name, size_t length);
+		bool has(t_header_id id) const;
+		bool repeated(t_header_id id) const;
+		const char* data(t_header_id id) const;
+		size_t length(t_header_id id) const;
+		std::string value(t_header_id id) const;
+		bool equals(t_header_id id, const char* expected) const;
+};
+
+#endif
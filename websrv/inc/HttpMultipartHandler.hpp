@@ -62,6 +62,7 @@ struct s_multi_part {
  *   and payload requirements.
  * - `parse_multipart_data()`: Splits and processes each multipart section, extracting
  *   headers and content.
+ * - `resume()`: Answers once the file parts were written by the offloaded `IoSaveFiles`.
  *
  */
 class HttpMultipartHandler : public WsResponseHandler {
@@ -78,6 +79,7 @@ public:
 						 s_request& request,
 						 int fd);
 	bool handle_request();
+	bool resume(IoTask* task);
 };
 
 #endif
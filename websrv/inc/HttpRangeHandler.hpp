@@ -14,6 +14,7 @@
 #define _HTTP_RANGE_HANDLER_HPP_
 
 #include "WebServerResponseHandler.hpp"
+#include "OpenFileCache.hpp"
 #define RRH_NAME "HttpRangeHandler"
 
 /**
@@ -25,18 +26,20 @@
  *
  * @details
  * - `HttpRangeHandler` processes requests with range headers, validates content range,
- *   and reads file content based on the specified range.
+ *   and sends that range straight from the file, taken from the listener's `OpenFileCache`.
+ *   The range is not read into memory: it is queued as a file segment of the shared
+ *   descriptor, sent with `sendfile`.
  * - Supports GET requests with range validation for files and manages content responses.
  * - Relies on configuration from `LocationConfig` and logs actions via `Logger`.
  *
  * ### Public Methods
  * - `HttpRangeHandler(const LocationConfig *location, const Logger *log, ClientData* client_data, s_request& request, int fd)`: Constructor initializing the range handler with configuration, logger, and client data.
- * - `~HttpRangeHandler()`: Destructor to clean up resources, particularly file descriptors.
+ * - `~HttpRangeHandler()`: Destructor, releases the open file.
  * - `bool handle_request()`: Processes the HTTP request, validating the range and retrieving file content.
  *
  * ### Private Methods
  * - `bool handle_get()`: Handles GET requests, validating and serving the requested content range.
- * - `void get_file_content(std::string& path)`: Reads the specified file content for the range.
+ * - `void get_file_content(std::string& path)`: Opens the file and validates the range against its size.
  * - `bool validate_content_range(size_t file_size)`: Ensures the specified content range is valid within the file's total size.
  * - `void parse_content_range()`: Parses the range header to determine the requested content range.
  * - `void get_file_content(int pid, int (&fd)[2])`: Reads file content within a child process for specific cases, managing pipes.
@@ -49,8 +52,11 @@ class HttpRangeHandler : public WsResponseHandler {
 	                     ClientData* client_data,
 	                     s_request& request,
 	                     int fd);
+		~HttpRangeHandler();
 		bool handle_request();
 	private:
+		OpenFile*   _file;
+
 		bool handle_get();
 		void get_file_content(int pid, int (&fd)[2]);
 		void get_file_content(std::string& path);
@@ -24,6 +24,8 @@
 #include "HttpRangeHandler.hpp"
 #include "HttpMultipartHandler.hpp"
 #include "HttpAutoIndex.hpp"
+#include "HttpHeaderIndex.hpp"
+#include "http_scan.hpp"
 #include "WebserverCache.hpp"
 // Libraries
 #include <string>
@@ -56,15 +58,21 @@ typedef struct e_chunk {
  * The class utilizes a series of private validation and parsing steps, executed in sequence through
  * `request_workflow`. If any step detects an invalid state, it halts the process and sends an error response.
  *
+ * Reading never blocks: each event consumes what the socket has and the progress is kept in
+ * `s_request::read_phase`, so a new handler built on the next event resumes where the last one stopped.
+ * Responses waiting for an offloaded `IoTask` are resumed the same way, by `resume_request`.
+ *
  * ## Attributes
  * - `_config`: Reference to the server configuration.
  * - `_log`: Pointer to the logging utility for logging events and errors.
  * - `_client_data`: Manages client-specific information, including connection state and timing.
- * - `_cache`: Pointer to the server cache to leverage cached responses.
+ * - `_cache`: Route cache of the listening socket: routing outcomes of GET and HEAD requests.
+ * - `_missing`: Negative cache of the listening socket: GET and HEAD paths found missing.
+ * - `_watcher`: File watcher of the worker, or NULL. Its stamps tell if a cached route is current.
  * - `_location`: Configuration for the specific URL location being requested.
  * - `_fd`: File descriptor associated with the client request.
  * - `_max_request`: Maximum allowed size for request data.
- * - `_request`: Raw request data.
+ * - `_request`: Raw request data. It is the client's read buffer, so a partial request survives between events.
  * - `_factory`: Determines the handler type (standard, CGI, range, etc.).
  * - `_request_data`: Stores parsed request details, including headers, method, path, and body.
  *
@@ -85,18 +93,31 @@ class HttpRequestHandler {
 		const LocationConfig*           _location;
 		int                             _fd;
 		size_t 					        _max_request;
-		std::string                     _request;
+		std::string&                    _request;
 		s_request&                      _request_data;
-		CacheRequest                    _cache_data;
+		HttpHeaderIndex                 _header_index;
+		CacheHandle<CacheRequest>       _cache_data;
 		WebServerCache<CacheRequest>*   _cache;
+		CacheHandle<CacheMiss>          _miss_data;
+		WebServerCache<CacheMiss>*      _missing;
+		const FileWatcher*              _watcher;
 
+		bool receive_available();
 		void read_request_header();
 		void parse_header();
 		void parse_method_and_path();
 		void parse_path_type();
 		void load_header_data();
+		void load_body_framing();
 		void load_host_config();
 		void solver_resource();
+		std::string route_key() const;
+		bool load_cached_route();
+		void cache_route();
+		void forget_failed_route();
+		bool load_missing_route();
+		void cache_missing_route();
+		bool missing_dir(std::string& dir, FileStamp& stamp) const;
 		void resolve_relative_path();
 		void get_location_config();
 		void cgi_normalize_path();
@@ -104,7 +125,6 @@ class HttpRequestHandler {
 		void load_content();
 		void load_content_normal();
 		void load_content_chunks();
-		bool parse_chunks();
 		void validate_request();
 	    void turn_off_sanity(e_http_sts status, std::string detail);
 
@@ -114,6 +134,7 @@ class HttpRequestHandler {
 	    ~HttpRequestHandler();
 		void request_workflow();
 		void handle_request();
+		void resume_request(IoTask* task);
 };
 
 #endif
@@ -15,8 +15,17 @@
 
 #include "WebServerResponseHandler.hpp"
 #include "WebserverCache.hpp"
+#include "OpenFileCache.hpp"
 
 #define RHB_NAME "HttpResponseHandler"
+// Files from this size on are streamed with sendfile(), never loaded nor cached.
+#define SENDFILE_THRESHOLD 65536
+#define RHB_STR(x) #x
+#define RHB_XSTR(x) RHB_STR(x)
+// Fixed lines of a cached 200 response, as `WsResponseHandler::header` writes them.
+#define RHB_STATUS_OK "HTTP/1.1 200 OK\r\nHost: "
+#define RHB_KEEP_ALIVE "Connection: keep-alive\r\nKeep-Alive: timeout=" RHB_XSTR(TIMEOUT_CLIENT) "\r\n"
+#define RHB_CLOSE "Connection: close\r\n"
 
 /**
  * @class HttpResponseHandler
@@ -26,16 +35,50 @@
  * utilizing a caching mechanism to optimize retrieval of static files.
  * It checks for content in the cache before loading from disk, reducing redundant
  * I/O operations and improving response times for frequently requested resources.
+ * Cached bodies are queued by reference, a cache hit copies no file byte.
+ * Cached entries also keep their header lines serialized (`CacheEntry::head`):
+ * a hit queues the status and `Host` line, the cached lines, a static
+ * `Connection` line and the body, sent in one gathered write, with no
+ * formatting.
+ * Entries are checked against the file (FileStamp) at most once per
+ * `file_cache_valid` milliseconds, so edited files are never served stale
+ * for longer than that. The same stamps give the `ETag` and `Last-Modified`
+ * validators, and answer conditional GETs with a 304 without opening the file.
+ *
+ * Files of SENDFILE_THRESHOLD bytes or more skip the cache: the header is queued
+ * followed by a file segment, and the body goes from the page cache to the socket
+ * with `sendfile()`, so memory use does not depend on the file size.
+ *
+ * Files are opened through the listener's `OpenFileCache`: the descriptor and
+ * its `fstat` are reused across requests, the body is read with `pread()` or
+ * sent with `sendfile()` from the shared descriptor.
  */
 class HttpResponseHandler : public WsResponseHandler {
 	private:
 		WebServerCache<CacheEntry>& _cache;
+		OpenFileCache&              _open_files;
+		OpenFile*                   _file;
+		size_t                      _cache_valid;
+		FileStamp                   _file_stamp;
+		bool                        _stamped;
+
+		bool stream_file(const std::string& path);
+		bool send_cached(const CacheHandle<CacheEntry>& entry);
+		void set_validators(const FileStamp& stamp);
+		bool not_modified(const FileStamp& stamp) const;
+		bool send_not_modified(const std::string& path, size_t size);
+		std::string content_type(const std::string& path) const;
+		std::string cached_head(size_t size, const std::string& mime, size_t& split) const;
+		void read_open_file();
+	protected:
+		bool handle_get();
 	public:
 		HttpResponseHandler(const LocationConfig *location,
 							const Logger *log,
 							ClientData* client_data,
 							s_request& request,
 							int fd);
+		~HttpResponseHandler();
 	void get_file_content(std::string& path);
 	void get_file_content(int pid, int (&fd)[2]);
 };
@@ -0,0 +1,78 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IoPool.hpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 02:10:26 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 02:10:26 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _IO_POOL_HPP_
+#define _IO_POOL_HPP_
+
+#include <deque>
+#include <vector>
+#include <pthread.h>
+#include "IoTask.hpp"
+#include "Logger.hpp"
+
+#define IP_NAME "IoPool"
+// Threads of each worker's pool, by default and at most (`io_threads`).
+#define IO_POOL_THREADS 4
+#define IO_POOL_MAX_THREADS 64
+// Tasks waiting for a thread. Past it, handlers run their task inline.
+#define IO_POOL_MAX_QUEUE 1024
+
+/**
+ * @class IoPool
+ * @brief Bounded pool of threads running blocking file system work for one event loop.
+ *
+ * Each worker (`ServerManager`) owns one. Handlers `submit` an `IoTask` and
+ * suspend their client; a pool thread runs it, moves it to the completed list
+ * and signals the notification descriptor, registered in the event loop as
+ * `EV_IO`. The loop `collect`s the completed tasks and resumes their clients.
+ *
+ * @details
+ * - The notification descriptor is an `eventfd` on Linux, a pipe elsewhere.
+ *   It is only signaled when the completed list stops being empty, and
+ *   `collect` drains it, as an edge-triggered backend requires.
+ * - At most IO_POOL_MAX_QUEUE tasks wait for a thread: `submit` refuses the
+ *   rest, and the caller runs them inline.
+ * - Pool threads block every signal, they are delivered to the main thread.
+ * - Tasks never touch state owned by the event loop; the pool's lists are the
+ *   only shared data, behind one mutex.
+ */
+class IoPool {
+	private:
+		const Logger*               _log;
+		std::vector<pthread_t>      _threads;
+		pthread_mutex_t             _lock;
+		pthread_cond_t              _wake;
+		std::deque<IoTask*>         _queue;
+		std::vector<IoTask*>        _done;
+		bool                        _stopping;
+		int                         _notify_read;
+		int                         _notify_write;
+
+		static void* thread_routine(void* pool);
+		void work();
+		void notify();
+		void drain_notify();
+		void stop();
+
+		IoPool(const IoPool&);
+		IoPool& operator=(const IoPool&);
+	public:
+		explicit IoPool(const Logger* log);
+		~IoPool();
+		bool start(size_t threads);
+		bool active() const;
+		int get_fd() const;
+		bool submit(IoTask* task);
+		void collect(std::vector<IoTask*>& done);
+};
+
+#endif
@@ -0,0 +1,117 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IoTask.hpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 02:10:26 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 02:10:26 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _IO_TASK_HPP_
+#define _IO_TASK_HPP_
+
+#include <string>
+#include <vector>
+#include <ctime>
+#include <sys/types.h>
+
+/**
+ * @brief Blocking operation an `IoTask` performs, used to resume the right response.
+ */
+typedef enum e_io_kind {
+	IO_LIST_DIR=0,
+	IO_SAVE_FILES=1,
+	IO_REMOVE_FILE=2
+} t_io_kind;
+
+/**
+ * @class IoTask
+ * @brief Blocking file system work taken out of the event loop.
+ *
+ * A response handler builds a task with everything the operation needs
+ * (paths, contents), and `WsResponseHandler::offload` hands it to the
+ * worker's `IoPool`. `run` is called on a pool thread: it only touches the
+ * task's own members, never the client, the caches nor the logger. Results
+ * are left in the task, and the response is built from them back on the event
+ * loop (`WsResponseHandler::resume`).
+ *
+ * `client_fd` tells the event loop which client waits for the task.
+ */
+class IoTask {
+	private:
+		IoTask(const IoTask&);
+		IoTask& operator=(const IoTask&);
+	public:
+		const t_io_kind     kind;
+		int                 client_fd;
+
+		explicit IoTask(t_io_kind task_kind);
+		virtual ~IoTask();
+		virtual void run() = 0;
+};
+
+/**
+ * @brief An entry of a listed directory.
+ */
+typedef struct s_dir_item {
+	std::string     name;
+	bool            is_dir;
+	off_t           size;
+	time_t          mtime;
+} t_dir_item;
+
+/**
+ * @brief Lists a directory, with the `stat()` of each entry (autoindex).
+ *
+ * - `opened` is `false` if the directory could not be opened.
+ * - Entries that can not be `stat()`ed are left out and counted in `skipped`.
+ */
+class IoListDir : public IoTask {
+	public:
+		const std::string           path;
+		bool                        opened;
+		size_t                      skipped;
+		std::vector<t_dir_item>     items;
+
+		explicit IoListDir(const std::string& dir_path);
+		void run();
+};
+
+/**
+ * @brief Writes new files (uploads), stopping at the first failure.
+ *
+ * Contents are moved in with `add`, not copied. An existing file is never
+ * overwritten: `error` is `EEXIST` then. `saved` counts the files written.
+ */
+class IoSaveFiles : public IoTask {
+	public:
+		std::vector<std::string>    paths;
+		std::vector<std::string>    contents;
+		size_t                      saved;
+		int                         error;
+
+		IoSaveFiles();
+		void add(const std::string& path, std::string& content);
+		void run();
+};
+
+/**
+ * @brief Removes a file (DELETE).
+ *
+ * `found` is `false` if the file could not be opened; otherwise `error` holds
+ * the `errno` of a failed removal, `0` on success.
+ */
+class IoRemoveFile : public IoTask {
+	public:
+		const std::string   path;
+		bool                found;
+		int                 error;
+
+		explicit IoRemoveFile(const std::string& file_path);
+		void run();
+};
+
+#endif
@@ -48,6 +48,7 @@ private:
 	std::ofstream               _out_file;
 	std::ostream*               _log_out;
 	std::string 				_log_level[4];
+	bool                        _fatal_throws;
 
 public:
 	Logger(int level, bool log_to_file);
@@ -61,11 +62,21 @@ public:
 	void log_info(const std::string& module, const std::string& message) const;
 	void log_warning(const std::string& module, const std::string& message) const;
 	void log_error(const std::string& module, const std::string& message) const;
+	void throw_on_fatal(bool enabled);
 
 	class NoLoggerPointer : public std::exception {
 		public:
 			virtual const char *what() const throw();
     };
+
+	class FatalError : public std::exception {
+		private:
+			std::string _message;
+		public:
+			explicit FatalError(const std::string& message);
+			virtual ~FatalError() throw();
+			virtual const char *what() const throw();
+	};
 };
 
 #endif
@@ -0,0 +1,97 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OpenFileCache.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 23:58:40 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 23:58:40 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _OPEN_FILE_CACHE_HPP_
+#define _OPEN_FILE_CACHE_HPP_
+
+#include <list>
+#include <map>
+#include <string>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "WebserverCache.hpp"
+#include "webserver.hpp"
+
+/**
+ * @brief An open regular file, with the `fstat` taken when it was opened.
+ *
+ * Reference counted like any cache block: the cache holds one reference while
+ * the file is indexed, every response using it another (an `OutputQueue` file
+ * segment, for instance). The descriptor is closed by the last `release`, so
+ * a file evicted or replaced while it is being sent stays open until the
+ * response is done. Reads must use explicit offsets (`pread`, `sendfile`):
+ * the descriptor is shared.
+ *
+ * `validated` is the last `TimerWheel::now_msec` time `stamp` was checked
+ * against the path.
+ */
+class OpenFile : public CacheBlock {
+	private:
+		OpenFile(const OpenFile&);
+		OpenFile& operator=(const OpenFile&);
+	protected:
+		~OpenFile();
+	public:
+		const std::string   path;
+		const int           fd;
+		const size_t        size;
+		const FileStamp     stamp;
+		uint64_t            validated;
+
+		OpenFile(const std::string& file_path, int file_fd,
+				 const struct stat& info, uint64_t now);
+};
+
+/**
+ * @class OpenFileCache
+ * @brief Bounded cache of open file descriptors and their metadata, keyed by path.
+ *
+ * Each listener (`SocketHandler`) owns one. `acquire` answers a known
+ * path without any system call while its entry is younger than
+ * `file_cache_valid` milliseconds; an older entry costs one `stat()`, and is
+ * reopened if the file changed (FileStamp). Least recently used files are
+ * closed past `open_file_cache` entries.
+ *
+ * @details
+ * - Only regular files are cached; `acquire` fails with `EISDIR` for anything
+ *   else, which the caller handles as it did before.
+ * - Paths are expected clean (`clean_path`), as the other cache keys.
+ * - With `open_file_cache 0`, files are opened on each `acquire` and closed
+ *   when released, as if nothing was cached.
+ * - Not thread safe: used by the worker owning it only.
+ */
+class OpenFileCache {
+	private:
+		typedef std::list<OpenFile*>                        t_lru;
+		typedef std::map<std::string, t_lru::iterator>      t_index;
+
+		t_lru       _lru;
+		t_index     _index;
+		size_t      _max;
+		size_t      _valid;
+
+		OpenFile* open_file(const std::string& path, uint64_t now);
+		void drop(t_index::iterator it);
+
+		OpenFileCache(const OpenFileCache&);
+		OpenFileCache& operator=(const OpenFileCache&);
+	public:
+		OpenFileCache(size_t max, size_t valid);
+		~OpenFileCache();
+		OpenFile* acquire(const std::string& path);
+		void remove(const std::string& path);
+		void clear();
+		void swap(OpenFileCache& other);
+		size_t size() const;
+};
+
+#endif
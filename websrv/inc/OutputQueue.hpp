@@ -0,0 +1,117 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OutputQueue.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 17:12:41 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 17:12:41 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _OUTPUT_QUEUE_HPP_
+#define _OUTPUT_QUEUE_HPP_
+
+#include <deque>
+#include <string>
+#include <cstddef>
+#include <sys/types.h>
+#include "WebserverCache.hpp"
+
+#define OQ_NAME "OutputQueue"
+// Segments handed to a single sendmsg() call.
+#define OQ_IOV_MAX 64
+// Read size of the file fallback, where sendfile() is not available.
+#define OQ_FILE_CHUNK 65536
+
+/**
+ * @brief Result of an attempt to write the queue to a socket.
+ *
+ * - `FLUSH_DONE`: every queued byte was written.
+ * - `FLUSH_PENDING`: the socket buffer is full, wait for write readiness.
+ * - `FLUSH_ERROR`: the socket failed (peer gone, reset...).
+ */
+typedef enum e_flush_status {
+	FLUSH_DONE=0,
+	FLUSH_PENDING=1,
+	FLUSH_ERROR=2
+} t_flush_status;
+
+/**
+ * @brief A queued buffer, or file range, and how much of it has already been written.
+ *
+ * Memory segments use `data` and `offset`. Shared segments (`shared` set)
+ * point to `shared_size` bytes owned by a cache block, which the queue keeps
+ * a reference to until they are sent, or by nobody (`keep` NULL) for static
+ * bytes. File segments (`file_fd` >= 0) are
+ * sent straight from the file: `file_offset` is the next byte to send and
+ * `file_left` the bytes still to go. The queue owns and closes `file_fd`,
+ * unless `keep` is set: the descriptor then belongs to that block.
+ */
+typedef struct s_out_segment {
+	std::string     data;
+	size_t          offset;
+	const char*     shared;
+	size_t          shared_size;
+	CacheBlock*     keep;
+	int             file_fd;
+	off_t           file_offset;
+	size_t          file_left;
+	s_out_segment(): data(), offset(0), shared(NULL), shared_size(0), keep(NULL),
+					 file_fd(-1), file_offset(0), file_left(0) {};
+	const char* bytes() const {
+		return (shared ? shared : data.data());
+	};
+	size_t size() const {
+		return (shared ? shared_size : data.size());
+	};
+} t_out_segment;
+
+/**
+ * @class OutputQueue
+ * @brief Per-connection queue of bytes waiting to be written to the client.
+ *
+ * Response handlers enqueue their header and body and return at once; the
+ * event loop writes the queue when the socket is writable. Each `flush`
+ * writes as much as the socket accepts in one gathered `sendmsg()` per
+ * OQ_IOV_MAX segments, and remembers where a partial write stopped, so the
+ * next write readiness resumes from that byte.
+ *
+ * @details
+ * - Segments are written in order and dropped once fully sent.
+ * - Cached bodies are queued by reference (`enqueue_shared`), not copied.
+ * - File segments go from the page cache to the socket with `sendfile()`
+ *   (a bounded read/send loop elsewhere), so a file body is never held in
+ *   memory, whatever its size.
+ * - `flush` never waits: a full socket buffer returns `FLUSH_PENDING`.
+ * - Writes use `MSG_NOSIGNAL`, a closed peer is reported as `FLUSH_ERROR`
+ *   instead of raising SIGPIPE.
+ */
+class OutputQueue {
+	private:
+		std::deque<t_out_segment>   _segments;
+		size_t                      _pending;
+
+		void consume(size_t bytes);
+		t_flush_status flush_file(int fd, t_out_segment& segment);
+		void release_front();
+
+		OutputQueue(const OutputQueue&);
+		OutputQueue& operator=(const OutputQueue&);
+	public:
+		OutputQueue();
+		~OutputQueue();
+		void enqueue(const std::string& data);
+		void enqueue_swap(std::string& data);
+		void enqueue_shared(const char* data, size_t size, CacheBlock* keep);
+		void enqueue_static(const char* data, size_t size);
+		void enqueue_file(int file_fd, off_t offset, size_t length);
+		void enqueue_shared_file(int file_fd, off_t offset, size_t length, CacheBlock* keep);
+		t_flush_status flush(int fd);
+		bool empty() const;
+		size_t pending() const;
+		void clear();
+};
+
+#endif
@@ -0,0 +1,48 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PollBackend.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:44:52 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 10:44:52 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _POLL_BACKEND_HPP_
+#define _POLL_BACKEND_HPP_
+
+#include <poll.h>
+#include "EventBackend.hpp"
+
+#define PB_NAME "PollBackend"
+
+/**
+ * @class PollBackend
+ * @brief Level-triggered EventBackend built on poll(2).
+ *
+ * Portable fallback. `_poll_fds` is the array handed to poll(); `_tags` runs
+ * parallel to it, and `_slots` maps a fd to its position in both vectors, so
+ * add/modify/remove are O(1) (removal swaps with the last element).
+ */
+class PollBackend : public EventBackend {
+	private:
+		std::vector<struct pollfd>  _poll_fds;
+		std::vector<t_event_tag*>   _tags;
+		std::vector<int>            _slots;
+		const Logger*               _log;
+
+		static short to_poll(int events);
+	public:
+		PollBackend(const Logger* log);
+		~PollBackend();
+		bool add(int fd, int events, t_event_tag* tag);
+		bool modify(int fd, int events, t_event_tag* tag);
+		bool remove(int fd);
+		int wait(std::vector<t_event>& ready, int timeout_ms);
+		bool edge_triggered() const;
+		const char* name() const;
+};
+
+#endif
@@ -0,0 +1,114 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ProcessSupervisor.hpp                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 16:20:14 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 16:20:14 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _PROCESS_SUPERVISOR_HPP_
+#define _PROCESS_SUPERVISOR_HPP_
+
+#include <map>
+#include <vector>
+#include <csignal>
+#include <sys/types.h>
+#include "ServerCluster.hpp"
+#include "TimerWheel.hpp"
+#include "webserver.hpp"
+#include "Logger.hpp"
+
+#define PS_NAME "ProcessSupervisor"
+// A worker process ending sooner than this after its start failed to start.
+#define PS_MIN_UPTIME_MS 1000
+// Failed starts in a row after which a worker process is not started again.
+#define PS_MAX_FAILED_STARTS 5
+// Returned by `run` in the master when the configuration has to be reloaded.
+#define PS_RELOAD -1
+
+/**
+ * @brief A worker process of the master, and its restart history.
+ *
+ * `pid` is `-1` while no process runs in the slot. `retired` slots are not
+ * started again.
+ */
+typedef struct s_worker_slot {
+	pid_t       pid;
+	t_msec      started;
+	size_t      failed_starts;
+	bool        retired;
+} t_worker_slot;
+
+/**
+ * @class ProcessSupervisor
+ * @brief Prefork master: binds the listeners once and keeps `worker_processes` workers running.
+ *
+ * The master serves nothing, and parses only on a reload. It opens one listening socket
+ * per configured port, stores it in the configs (`listen_fd`) and forks the
+ * workers. Each worker inherits the sockets and builds its own `ServerCluster`
+ * from its copy of the configs, so it serves exactly as a single process
+ * would: `workers` event loops, their caches, watcher and I/O pool.
+ *
+ * A worker that ends while the master is not stopping is started again in the
+ * same slot. A slot whose worker fails `PS_MAX_FAILED_STARTS` times in a row
+ * within `PS_MIN_UPTIME_MS` of its start is retired; the master ends when no
+ * slot is left.
+ *
+ * @details
+ * - Connections queued on a listener survive a worker crash: the socket
+ *   belongs to the master and every worker, not to the process that died.
+ * - With `worker_cpu_affinity on`, slot `i` is pinned to the `i`-th CPU the
+ *   server may use (modulo their number). Linux only.
+ * - `stop` is async-signal-safe. In the master it forwards `SIGTERM` to the
+ *   workers; in a worker it stops its cluster. Signals are blocked while a
+ *   worker is forked, so no worker misses the request.
+ * - `drain` (SIGQUIT) is the graceful variant of `stop`: the workers receive
+ *   `SIGQUIT` and finish once their clients are served. Upgrades (SIGUSR2)
+ *   are driven by the master, workers ignore that signal.
+ * - `run` returns in the worker processes too, once their cluster finished,
+ *   so they unwind and release everything as a single process does.
+ * - A configuration reload (SIGHUP) rolls the workers: `run` returns
+ *   `PS_RELOAD`, the caller parses the file again and hands it to `reload`,
+ *   and the next `run` starts a new worker in every slot before sending
+ *   `SIGQUIT` to the previous ones, which drain. Workers ignore SIGHUP.
+ */
+class ProcessSupervisor {
+	private:
+		std::vector<ServerConfig>&  _configs;
+		const Logger*               _log;
+		std::map<int, int>          _listeners;
+		std::vector<t_worker_slot>  _slots;
+		std::vector<pid_t>          _retiring;
+		ServerCluster*              _cluster;
+		bool                        _is_worker;
+		volatile sig_atomic_t       _stopping;
+		volatile sig_atomic_t       _reload;
+
+		void open_listeners();
+		void close_listeners();
+		bool update_listeners(std::vector<ServerConfig>& configs);
+		bool spawn(size_t slot);
+		int run_worker(size_t slot);
+		void pin_cpu(size_t slot);
+		void worker_ended(pid_t pid, int status);
+		size_t running() const;
+		void signal_workers(int sig);
+
+		ProcessSupervisor(const ProcessSupervisor&);
+		ProcessSupervisor& operator=(const ProcessSupervisor&);
+	public:
+		ProcessSupervisor(std::vector<ServerConfig>& configs, const Logger* logger);
+		~ProcessSupervisor();
+		int run();
+		void stop();
+		void drain();
+		void request_reload();
+		bool reload(const std::vector<ServerConfig>& configs);
+		void listeners(std::map<int, int>& out) const;
+};
+
+#endif
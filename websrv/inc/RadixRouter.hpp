@@ -0,0 +1,218 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RadixRouter.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 20:02:17 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 20:02:17 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _RADIX_ROUTER_HPP_
+#define _RADIX_ROUTER_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @class RadixRouter
+ * @brief Immutable radix trie answering longest-prefix queries over a map of routes.
+ *
+ * `compile` turns the keys of a `std::map<std::string, T>` (location paths,
+ * CGI paths...) into a compressed trie: each node holds the label of its
+ * incoming edge, children of a node are stored next to each other and sorted
+ * by their first byte, and all labels share a single string. `match` walks
+ * the path once, so a lookup costs O(path length) whatever the number of
+ * routes, and answers what a scan with `starts_with` keeping the longest key
+ * would.
+ *
+ * @details
+ * - The router points to the values of the compiled map, which must not be
+ *   modified (or destroyed) while the router is used. Compile again after any
+ *   change.
+ * - Copies are empty: the values of a copied map live elsewhere, so the owner
+ *   of the copy compiles its own router.
+ * - Read-only once compiled, lookups may run concurrently.
+ */
+template <typename T>
+class RadixRouter {
+	private:
+		struct Node {
+			size_t          label;
+			size_t          label_length;
+			unsigned char   first;
+			size_t          first_child;
+			size_t          children;
+			const T*        value;
+		};
+		struct Pending {
+			size_t  node;
+			size_t  low;
+			size_t  high;
+			size_t  depth;
+		};
+
+		std::vector<Node>   _nodes;
+		std::string         _labels;
+		size_t              _routes;
+
+		static size_t common_prefix(const std::string& a, const std::string& b, size_t from) {
+			size_t limit = a.size() < b.size() ? a.size() : b.size();
+			while (from < limit && a[from] == b[from]) {
+				from++;
+			}
+			return (from);
+		}
+
+		Node make_node(const std::string& key, size_t depth, size_t end, const T* value) {
+			Node node;
+			node.label = _labels.size();
+			node.label_length = end - depth;
+			node.first = depth < key.size() ? static_cast<unsigned char>(key[depth]) : 0;
+			node.first_child = 0;
+			node.children = 0;
+			node.value = key.size() == end ? value : NULL;
+			_labels.append(key, depth, end - depth);
+			return (node);
+		}
+
+		const Node* child(const Node& parent, unsigned char c) const {
+			size_t low = parent.first_child;
+			size_t high = parent.first_child + parent.children;
+			while (low < high) {
+				size_t mid = low + (high - low) / 2;
+				if (_nodes[mid].first < c) {
+					low = mid + 1;
+				} else {
+					high = mid;
+				}
+			}
+			if (low < parent.first_child + parent.children && _nodes[low].first == c) {
+				return (&_nodes[low]);
+			}
+			return (NULL);
+		}
+
+	public:
+		RadixRouter(): _nodes(), _labels(), _routes(0) {}
+		RadixRouter(const RadixRouter&): _nodes(), _labels(), _routes(0) {}
+		RadixRouter& operator=(const RadixRouter& other) {
+			if (this != &other) {
+				clear();
+			}
+			return (*this);
+		}
+
+		/**
+		 * @brief Builds the trie from the keys of `routes`, replacing any previous one.
+		 *
+		 * Keys come sorted from the map, so the keys below a node form a contiguous
+		 * range: it is split by the byte following the node's label, and each part
+		 * becomes a child labelled with the prefix its keys share. Nodes are laid
+		 * out breadth first, which keeps the children of a node contiguous.
+		 *
+		 * @param routes Map of routes. Must outlive the router, unchanged.
+		 */
+		void compile(const std::map<std::string, T>& routes) {
+			clear();
+			std::vector<const std::string*> keys;
+			std::vector<const T*> values;
+			keys.reserve(routes.size());
+			values.reserve(routes.size());
+			for (typename std::map<std::string, T>::const_iterator it = routes.begin();
+				 it != routes.end(); ++it) {
+				keys.push_back(&it->first);
+				values.push_back(&it->second);
+			}
+			_routes = keys.size();
+			static const std::string empty;
+			_nodes.push_back(make_node(empty, 0, 0, NULL));
+			if (!keys.empty() && keys[0]->empty()) {
+				_nodes[0].value = values[0];
+			}
+			std::vector<Pending> queue;
+			Pending root = {0, 0, keys.size(), 0};
+			queue.push_back(root);
+			for (size_t next = 0; next < queue.size(); next++) {
+				Pending current = queue[next];
+				size_t i = current.low;
+				if (i < current.high && keys[i]->size() == current.depth) {
+					i++;
+				}
+				_nodes[current.node].first_child = _nodes.size();
+				while (i < current.high) {
+					size_t j = i + 1;
+					while (j < current.high && (*keys[j])[current.depth] == (*keys[i])[current.depth]) {
+						j++;
+					}
+					size_t end = common_prefix(*keys[i], *keys[j - 1], current.depth + 1);
+					Pending below = {_nodes.size(), i, j, end};
+					_nodes.push_back(make_node(*keys[i], current.depth, end, values[i]));
+					_nodes[current.node].children++;
+					queue.push_back(below);
+					i = j;
+				}
+			}
+		}
+
+		/**
+		 * @brief Finds the longest route that is a prefix of `path`.
+		 *
+		 * @param path Path to route.
+		 * @param length Output. Length of the matching route key.
+		 * @return Value of the matching route, or NULL if no route is a prefix of `path`.
+		 */
+		const T* match(const std::string& path, size_t& length) const {
+			length = 0;
+			if (_nodes.empty()) {
+				return (NULL);
+			}
+			const Node* node = &_nodes[0];
+			const T* best = node->value;
+			size_t depth = 0;
+			while (node->children > 0 && depth < path.size()) {
+				const Node* next = child(*node, static_cast<unsigned char>(path[depth]));
+				if (next == NULL || path.size() - depth < next->label_length
+					|| path.compare(depth, next->label_length, _labels,
+									next->label, next->label_length) != 0) {
+					break ;
+				}
+				depth += next->label_length;
+				node = next;
+				if (node->value) {
+					best = node->value;
+					length = depth;
+				}
+			}
+			return (best);
+		}
+
+		/**
+		 * @brief Drops the compiled trie.
+		 */
+		void clear() {
+			_nodes.clear();
+			_labels.clear();
+			_routes = 0;
+		}
+
+		/**
+		 * @brief Number of routes compiled.
+		 */
+		size_t size() const {
+			return (_routes);
+		}
+
+		/**
+		 * @brief Tells if nothing was compiled.
+		 */
+		bool empty() const {
+			return (_nodes.empty());
+		}
+};
+
+#endif
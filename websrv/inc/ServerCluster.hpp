@@ -0,0 +1,79 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ServerCluster.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 13:02:19 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 13:02:19 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _SERVER_CLUSTER_HPP_
+#define _SERVER_CLUSTER_HPP_
+
+#include <map>
+#include <vector>
+#include <csignal>
+#include <pthread.h>
+#include "ServerManager.hpp"
+#include "webserver.hpp"
+#include "Logger.hpp"
+
+#define SC_NAME "ServerCluster"
+
+/**
+ * @class ServerCluster
+ * @brief Runs `workers` independent event loops (reactors) in parallel.
+ *
+ * Each worker is a complete `ServerManager`: its own event backend, its own
+ * SO_REUSEPORT listening sockets and its own client table. The kernel spreads
+ * incoming connections among the listeners bound to the same port, so workers
+ * never share a descriptor and need no locking on the request path.
+ *
+ * @details
+ * - Configuration is sharded: every worker gets a private copy of the parsed
+ *   `ServerConfig` vector. Host maps, CGI mappings and caches hanging from it
+ *   (or from its `SocketHandler`s) are therefore per worker, and the hot path
+ *   touches no shared mutable state.
+ * - Worker 0 runs on the calling (main) thread, which is the only one that
+ *   receives signals. Extra workers run on threads created with every signal
+ *   blocked.
+ * - `stop` and `drain` are async-signal-safe, they only forward to the
+ *   `ServerManager` method of the same name.
+ * - `request_reload` (async-signal-safe too) makes `run` return on the main
+ *   thread, so the configuration is parsed there, out of the signal handler.
+ *   `reload` gives each worker its own copy of it: worker 0 applies it at
+ *   once, the others at the start of their next loop pass.
+ * - With `workers 1` (default) no thread is created and the behaviour is the
+ *   one of a single `ServerManager`.
+ */
+class ServerCluster {
+	private:
+		std::vector<std::vector<ServerConfig>* >    _shards;
+		std::vector<ServerManager*>                 _workers;
+		std::vector<pthread_t>                      _threads;
+		const Logger*                               _log;
+		ServerConfig                                _settings;
+		volatile sig_atomic_t                       _draining;
+		volatile sig_atomic_t                       _stopping;
+		volatile sig_atomic_t                       _reload;
+
+		static void* worker_routine(void* worker);
+		void start_threads();
+		void join_threads();
+		void clear_workers();
+	public:
+		ServerCluster(std::vector<ServerConfig>& configs, const Logger* logger);
+		~ServerCluster();
+		bool run();
+		void stop();
+		void drain();
+		void request_reload();
+		void reload(const std::vector<ServerConfig>& configs);
+		void listeners(std::map<int, int>& out) const;
+		size_t size() const;
+};
+
+#endif
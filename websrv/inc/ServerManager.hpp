@@ -13,24 +13,30 @@
 #ifndef _SERVERMANAGER_HPP_
 #define _SERVERMANAGER_HPP_
 
+#include <map>
 #include <vector>
-#include <poll.h>
+#include <functional>
 #include <unistd.h>
+#include <pthread.h>
 #include <cstring>
 #include <algorithm>
 #include <sys/time.h>
 #include "SocketHandler.hpp"
 #include "HttpRequestHandler.hpp"
 #include "ClientData.hpp"
+#include "EventBackend.hpp"
+#include "TimerWheel.hpp"
+#include "FileWatcher.hpp"
+#include "IoPool.hpp"
 #include "webserver.hpp"
 #include "Logger.hpp"
 
-//defined in microsecs
-#define CLIENT_LIFECYCLE 10000000
 #define SM_NAME "ServerManager"
+// Pipelined requests answered in one pass, before their responses are written.
+#define SM_PIPELINE_DEPTH 32
+// Queued response bytes that end a pipelined pass early.
+#define SM_PIPELINE_BYTES 262144
 typedef std::map<int, ClientData*>::iterator t_client_it;
-typedef std::map<int, time_t>::iterator t_fd_timestamp;
-typedef std::map<time_t, int>::iterator t_timestamp_fd;
 
 /**
  * @class ServerManager
@@ -41,40 +47,96 @@ typedef std::map<time_t, int>::iterator t_timestamp_fd;
  * - Maintaining active client connections and polling their events.
  * - Handling critical server functions, such as timeouts, connection cleanup, and error handling.
  *
- * This class uses a `poll`-based event loop in the `run` method to handle incoming connections and requests.
+ * The `run` method drives an event loop on top of an `EventBackend` (edge-triggered epoll or poll,
+ * selected at startup). Every registered fd carries an event tag pointing to its owner, so a ready
+ * descriptor is dispatched without searching any container.
  * It provides a shutdown mechanism in case of unrecoverable errors and is equipped with logging for server status tracking.
+ *
+ * A reloaded configuration (`reload`, `post_reload`) replaces the listeners whose server blocks
+ * changed. The replaced ones are retired: they serve the requests in progress with the
+ * configuration those started with, and are released with their last client.
  */
 class ServerManager {
 		private:
-			std::vector<struct pollfd> 	    _poll_fds;
-			std::map<int, size_t>           _poll_index;
+			EventBackend*                   _events;
+			std::vector<t_event>            _ready;
 			std::map<int, SocketHandler*>   _servers_map;
 			std::map<int, int>              _active_ports;
 			std::map<int, ClientData*>      _clients;
-			std::map<time_t, int>           _timeout_index;
-			std::map<int, time_t>           _index_timeout;
+			TimerWheel                      _timers;
+			std::vector<t_timer_node*>      _expired;
+			std::vector<int>                _posted;
+			std::vector<int>                _posted_run;
 			const Logger*			        _log;
-			bool                            _active;
+			volatile bool                   _active;
+			volatile bool                   _draining;
+			bool                            _accepting;
 			bool                            _healthy;
+			int                             _wake_pipe[2];
+			t_event_tag                     _wake_tag;
+			FileWatcher                     _watcher;
+			t_event_tag                     _watch_tag;
+			std::vector<t_file_event>       _file_events;
+			IoPool                          _io_pool;
+			t_event_tag                     _io_tag;
+			std::vector<IoTask*>            _io_done;
+			bool                            _watch_ready;
+			bool                            _io_ready;
+			volatile bool                   _interrupted;
+			std::map<SocketHandler*, size_t>            _retired;
+			std::vector<std::vector<ServerConfig>* >    _snapshots;
+			std::vector<ServerConfig>*                  _reload_next;
+			volatile bool                               _reload_posted;
+			pthread_mutex_t                             _reload_lock;
 
 			bool add_server(int port, ServerConfig& config);
 			void build_servers(std::vector<ServerConfig>& configs);
-			bool add_server_to_poll(int server_fd);
+			bool add_server_to_poll(SocketHandler* server);
+			void add_wakeup_to_poll();
+			void drain_wakeup();
+			void wake();
+			void start_file_watcher(bool enabled);
+			void apply_file_changes();
+			void start_io_pool(size_t threads);
+			void resume_clients();
+			void suspend_client(ClientData* client);
 			void cleanup_invalid_fds();
 			void timeout_clients();
+			void arm_deadline(ClientData* client, t_deadline kind);
 			bool new_client(SocketHandler* server);
-			bool process_request(size_t& poll_fd_index);
+			void accept_clients(SocketHandler* server);
+			bool process_request(ClientData* client, int events);
+			bool serve_requests(ClientData* client);
+			void serve_posted();
+			bool flush_client(ClientData* client);
+			bool finish_request(ClientData* client);
+			void watch_client(ClientData* client, int events);
 			void remove_client_from_poll(t_client_it client_data);
+			static bool is_idle(ClientData* client);
+			void apply_posted_reload();
+			void open_port(std::vector<ServerConfig*>& hosts);
+			void reload_port(int fd, std::vector<ServerConfig*>& hosts);
+			void close_port(int port);
+			void retire(SocketHandler* server);
+			void release_retired(SocketHandler* server);
+			bool snapshot_in_use(const std::vector<ServerConfig>& snapshot) const;
+			void release_snapshots();
+			bool drain_clients();
 			bool turn_off_sanity(const std::string& detail);
 			void clear_clients();
 			void clear_servers();
 			void clear_poll();
-			static time_t timeout_timestamp();
 	public:
 			ServerManager(std::vector<ServerConfig>& configs,
 						  const Logger* logger);
 			~ServerManager();
 			void run();
+			void stop();
+			void drain();
+			void interrupt();
+			void reload(std::vector<ServerConfig>* snapshot);
+			void post_reload(std::vector<ServerConfig>* snapshot);
+			void listeners(std::map<int, int>& out) const;
 			void turn_off_server();
 };
 
@@ -28,6 +28,11 @@
 #include "webserver.hpp"
 #include "http_enum_codes.hpp"
 #include "Logger.hpp"
+#include "EventBackend.hpp"
+#include "VirtualHostTable.hpp"
+#include "FileWatcher.hpp"
+#include "OpenFileCache.hpp"
+#include "IoPool.hpp"
 
 # define SH_NAME "SocketHandler"
 # define SOCKET_BACKLOG_QUEUE 2048
@@ -43,7 +48,8 @@
  * - This class is responsible for initializing and configuring a socket for the server,
  *   including setting it to non-blocking mode and ensuring proper cleanup upon destruction.
  * - Each instance is associated with a specific port and server configuration, and it
- *   supports multiple hosts by managing their configurations in the `_hosts` map.
+ *   supports multiple hosts by managing their configurations in the `_hosts` table
+ *   (`VirtualHostTable`: exact names hashed, wildcard names in a label trie).
  * - The class also provides caching functionality using `WebServerCache` to optimize
  *   request and response handling.
  * - Auxiliary methods handle CGI file mapping, redirection configuration, and path
@@ -59,12 +65,18 @@ class SocketHandler {
 	private:
 		int                                     _socket_fd;
 		ServerConfig&                           _config;
-		std::map<std::string, ServerConfig*>    _hosts;
+		VirtualHostTable                        _hosts;
+		std::vector<ServerConfig*>              _host_list;
 		const Logger*                           _log;
 		const std::string                       _module;
 		std::string                             _port_str;
 		WebServerCache<CacheEntry>              _cache;
 		WebServerCache<CacheRequest>            _request_cache;
+		WebServerCache<CacheMiss>               _missing_cache;
+		OpenFileCache                           _open_files;
+		FileWatcher*                            _watcher;
+		IoPool*                                 _io_pool;
+		t_event_tag                             _event_tag;
 
 		bool set_nonblocking(int fd);
 		static bool is_cgi_file(const std::string& filename, const std::string& extension) ;
@@ -73,18 +85,34 @@ class SocketHandler {
 		                   const std::string& extension, std::map<std::string, t_cgi>& mapped_files);
 		void mapping_cgi_locations(ServerConfig& host, const std::string& extension);
 		void mapping_redir(ServerConfig& host);
+		void mapping_cgi(ServerConfig& host);
 		void close_socket();
+		void adopt_caches(SocketHandler& previous);
 	public:
 		SocketHandler(int port, ServerConfig& config, const Logger* logger);
+		SocketHandler(SocketHandler& previous, const std::vector<ServerConfig*>& hosts, const Logger* logger);
 		~SocketHandler();
+		static int open_listener(int port, bool reuse_port);
 		int accept_connection();
+		void stop_listening();
+		bool is_listening() const;
 		int get_socket_fd() const;
 		void add_host(ServerConfig& config);
 		ServerConfig& get_config() const;
 		ServerConfig* get_config(const std::string& host);
+		const std::vector<ServerConfig*>& get_hosts() const;
 		std::string get_port() const;
 		WebServerCache<CacheEntry>&   get_cache();
 		WebServerCache<CacheRequest>& get_request_cache();
+		WebServerCache<CacheMiss>&    get_missing_cache();
+		OpenFileCache&                get_open_files();
+		void set_watcher(FileWatcher* watcher);
+		const FileWatcher* get_watcher() const;
+		void watch_roots(FileWatcher& watcher) const;
+		void set_io_pool(IoPool* pool);
+		IoPool* get_io_pool() const;
+		void remap_cgi();
+		t_event_tag* event_tag();
 };
 
 #endif
@@ -0,0 +1,93 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 14:21:37 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 14:21:37 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _TIMER_WHEEL_HPP_
+#define _TIMER_WHEEL_HPP_
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+#define TW_NAME "TimerWheel"
+// 4 levels of 64 slots, 1 ms tick: 64ms, 4s, 4.3m and 4.6h ranges.
+#define TW_LEVELS 4
+#define TW_SLOT_BITS 6
+#define TW_SLOTS (1 << TW_SLOT_BITS)
+#define TW_SLOT_MASK (TW_SLOTS - 1)
+
+typedef uint64_t t_msec;
+
+/**
+ * @brief Intrusive timer entry.
+ *
+ * It is meant to be a member of its owner (e.g. `ClientData`), so arming,
+ * re-arming and cancelling a timer never allocate. `owner` is handed back
+ * when the timer expires.
+ */
+typedef struct s_timer_node {
+	s_timer_node*   prev;
+	s_timer_node*   next;
+	t_msec          expires;
+	int             level;
+	int             kind;
+	void*           owner;
+	s_timer_node(void* o = NULL): prev(NULL), next(NULL), expires(0), level(0), kind(0), owner(o) {};
+} t_timer_node;
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel with O(1) schedule and cancel.
+ *
+ * Timers are kept in TW_LEVELS levels of TW_SLOTS circular doubly linked
+ * lists. Level 0 has 1 ms slots; each following level is TW_SLOTS times
+ * coarser. A timer is placed at the level its distance to the deadline fits
+ * in, and moves down a level (cascade) when the lower wheel wraps around,
+ * until it lands in a level 0 slot and expires.
+ *
+ * @details
+ * - `schedule` and `cancel` are constant time: a slot index computation and
+ *   a list link/unlink. Re-arming a timer is a cancel plus a schedule.
+ * - Timers with the same deadline simply share a slot list.
+ * - `next_timeout` returns how long the event loop may sleep: the time to the
+ *   next level 0 expiry, bounded by the next cascade while coarser levels hold
+ *   timers. A cascade wake-up may only move timers, but none of them is
+ *   moved to level 0 after its slot is due.
+ * - Timers beyond the last level are clamped to its range and re-cascaded.
+ */
+class TimerWheel {
+	private:
+		t_timer_node            _slots[TW_LEVELS][TW_SLOTS];
+		size_t                  _level_count[TW_LEVELS];
+		t_msec                  _current;
+		size_t                  _count;
+
+		void link(t_timer_node* node);
+		void unlink(t_timer_node* node);
+		void cascade(int level, std::vector<t_timer_node*>& expired);
+		void tick(std::vector<t_timer_node*>& expired);
+		static bool is_empty(const t_timer_node* head);
+
+		TimerWheel(const TimerWheel&);
+		TimerWheel& operator=(const TimerWheel&);
+	public:
+		TimerWheel();
+		~TimerWheel();
+		void schedule(t_timer_node* node, t_msec expires);
+		void cancel(t_timer_node* node);
+		void advance(t_msec now, std::vector<t_timer_node*>& expired);
+		int next_timeout(t_msec now) const;
+		size_t size() const;
+		static bool is_armed(const t_timer_node* node);
+		static t_msec now_msec();
+};
+
+#endif
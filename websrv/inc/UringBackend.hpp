@@ -0,0 +1,130 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   UringBackend.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 14:02:51 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 14:02:51 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _URING_BACKEND_HPP_
+#define _URING_BACKEND_HPP_
+
+#include "EventBackend.hpp"
+
+// The syscall number comes from the C library, the ring layout from the kernel
+// headers (`linux-headers` on Alpine). Without either, only poll and epoll are built.
+#ifdef __linux__
+# include <sys/syscall.h>
+# if defined(__NR_io_uring_setup) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#   include <linux/io_uring.h>
+#   ifdef IORING_FEAT_EXT_ARG
+#    define WS_HAS_URING 1
+#   endif
+#  endif
+# endif
+#endif
+
+#ifdef WS_HAS_URING
+# include <stdint.h>
+
+# define UR_NAME "UringBackend"
+// Submission queue entries; the completion queue is UR_CQ_ENTRIES long.
+# define UR_SQ_ENTRIES 1024
+# define UR_CQ_ENTRIES 16384
+
+/**
+ * @brief Registration of one file descriptor in the ring.
+ *
+ * - `generation` goes in the `user_data` of every poll armed for the fd, with
+ *   the fd itself: completions of a poll cancelled by `modify` or `remove` (or
+ *   of a previous owner of a reused fd number) are recognized and dropped.
+ * - `armed` tells a poll is in flight; `queued` that the fd waits in
+ *   `_pending` to be armed.
+ */
+typedef struct s_uring_slot {
+	t_event_tag*    tag;
+	int             events;
+	uint32_t        generation;
+	bool            armed;
+	bool            queued;
+} t_uring_slot;
+
+/**
+ * @class UringBackend
+ * @brief Level-triggered EventBackend built on io_uring(7) poll requests. Linux only.
+ *
+ * Every registered fd has one one-shot `IORING_OP_POLL_ADD` in flight. Its
+ * completion is reported by `wait`, and the fd is armed again on the next
+ * `wait`, with the interest it has then: a descriptor still ready is reported
+ * again, as with poll(2).
+ *
+ * `add`, `modify` and `remove` make no system call. They only queue
+ * submissions, which the next `wait` hands to the kernel together with the
+ * wait itself, in a single `io_uring_enter`. Only a full submission queue
+ * makes an early submit.
+ *
+ * @details
+ * - The ring is driven through the raw system calls, no library is needed.
+ * - The constructor probes the kernel and throws WebServerException when the
+ *   ring can not be used (no io_uring, disabled by the system, or a kernel
+ *   without `IORING_FEAT_NODROP` / `IORING_FEAT_EXT_ARG`, 5.11).
+ *   EventBackend::create falls back to epoll or poll then.
+ * - A removed fd may be closed at once: its cancelled poll is identified by
+ *   `user_data`, never by fd.
+ */
+class UringBackend : public EventBackend {
+	private:
+		int                         _ring_fd;
+		void*                       _sq_map;
+		size_t                      _sq_map_size;
+		void*                       _cq_map;
+		size_t                      _cq_map_size;
+		struct io_uring_sqe*        _sqes;
+		size_t                      _sqes_size;
+		unsigned*                   _sq_head;
+		unsigned*                   _sq_tail;
+		unsigned*                   _sq_array;
+		unsigned                    _sq_mask;
+		unsigned                    _sq_entries;
+		unsigned                    _sq_local_tail;
+		unsigned*                   _cq_head;
+		unsigned*                   _cq_tail;
+		unsigned                    _cq_mask;
+		struct io_uring_cqe*        _cqes;
+		std::vector<t_uring_slot>   _slots;
+		std::vector<int>            _pending;
+		const Logger*               _log;
+
+		void map_rings(const struct io_uring_params& params);
+		void unmap_rings();
+		struct io_uring_sqe* next_sqe();
+		bool submit(unsigned min_complete, unsigned flags, void* arg, size_t arg_size);
+		unsigned unsubmitted() const;
+		void queue_arm(int fd);
+		bool arm_pending();
+		bool cancel(int fd);
+		void reap(std::vector<t_event>& ready);
+		static uint64_t user_data(int fd, uint32_t generation);
+		static short to_poll(int events);
+
+		UringBackend(const UringBackend&);
+		UringBackend& operator=(const UringBackend&);
+	public:
+		UringBackend(const Logger* log);
+		~UringBackend();
+		bool add(int fd, int events, t_event_tag* tag);
+		bool modify(int fd, int events, t_event_tag* tag);
+		bool remove(int fd);
+		int wait(std::vector<t_event>& ready, int timeout_ms);
+		bool edge_triggered() const;
+		const char* name() const;
+};
+
+#endif
+
+#endif
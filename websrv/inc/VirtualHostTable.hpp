@@ -0,0 +1,87 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   VirtualHostTable.hpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 21:14:36 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 21:14:36 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _VIRTUAL_HOST_TABLE_HPP_
+#define _VIRTUAL_HOST_TABLE_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+struct ServerConfig;
+
+#define VH_NAME "VirtualHostTable"
+// Initial number of slots of the exact name table, always a power of two.
+#define VH_MIN_SLOTS 16
+
+/**
+ * @brief Slot of the exact name table. Empty while `config` is NULL.
+ */
+typedef struct s_vhost_slot {
+	uint32_t        hash;
+	std::string     name;
+	ServerConfig*   config;
+	s_vhost_slot(): hash(0), name(), config(NULL) {};
+} t_vhost_slot;
+
+/**
+ * @brief Node of the reversed-label trie: one domain label, read right to left.
+ *
+ * `wildcard` serves the hosts having at least one more label on the left.
+ */
+typedef struct s_vhost_node {
+	std::map<std::string, size_t>   children;
+	ServerConfig*                   wildcard;
+	s_vhost_node(): children(), wildcard(NULL) {};
+} t_vhost_node;
+
+/**
+ * @class VirtualHostTable
+ * @brief Maps a request `Host` to the server block serving it.
+ *
+ * Exact server names live in an open addressing hash table (FNV-1a, linear
+ * probing, at most half full), so a known host costs one hash and, in
+ * practice, one probe. Wildcard names are kept in a trie of domain labels
+ * read from the right, walked only when the exact probe misses.
+ *
+ * @details
+ * - `server_name example.com`: that host only.
+ * - `server_name *.example.com`: any subdomain of example.com, not example.com.
+ * - `server_name .example.com`: example.com and any of its subdomains.
+ * - An exact name wins over wildcards, and the longest wildcard wins over shorter ones.
+ * - Names and hosts are compared after `normalize` (lowercase, no port, no trailing dot).
+ * - Built once when the hosts are added, read-only afterwards.
+ */
+class VirtualHostTable {
+	private:
+		std::vector<t_vhost_slot>   _slots;
+		size_t                      _count;
+		std::vector<t_vhost_node>   _suffixes;
+		size_t                      _wildcards;
+
+		static uint32_t hash_name(const std::string& name);
+		size_t probe(const std::string& name, uint32_t hash) const;
+		void grow();
+		bool add_exact(const std::string& name, ServerConfig* config);
+		bool add_suffix(const std::string& domain, ServerConfig* config);
+		ServerConfig* find_suffix(const std::string& host) const;
+	public:
+		VirtualHostTable();
+		static std::string normalize(const std::string& host);
+		bool add(const std::string& server_name, ServerConfig* config);
+		ServerConfig* find(const std::string& host) const;
+		size_t size() const;
+};
+
+#endif
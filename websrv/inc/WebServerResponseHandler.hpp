@@ -18,6 +18,7 @@
 #include "http_enum_codes.hpp"
 #include "Logger.hpp"
 #include "ClientData.hpp"
+#include "IoPool.hpp"
 #include "ws_permissions_bitwise.hpp"
 #include <string>
 #include <unistd.h>
@@ -67,9 +68,12 @@ struct s_content {
 	std::string         mime;
 	e_http_sts          http_status;
 	std::string         header;
+	std::string         etag;
+	std::string         last_modified;
 	s_content(): ranged(false), start(0), end(0), filesize(0),
 	             range_scenario(CR_INIT),status(false), content(""),
-	             mime(""), http_status(HTTP_I_AM_A_TEAPOT), header("") {};
+	             mime(""), http_status(HTTP_I_AM_A_TEAPOT), header(""),
+	             etag(""), last_modified("") {};
 };
 
 
@@ -82,6 +86,12 @@ struct s_content {
  * content validation, response headers, error responses, and client interactions.
  * Derived classes can implement additional logic, including specialized response
  * handling such as for multipart or CGI responses.
+ *
+ * Blocking file system work (uploads, deletions, directory listings) is built
+ * as an `IoTask` and handed to `offload`: with an I/O pool the client is
+ * suspended and the handler returns; the response is built later by a new
+ * handler of the same request, through `resume`. Without a pool the task runs
+ * inline and `resume` is called at once, so both paths answer the same way.
  */
 class WsResponseHandler {
 	private:
@@ -103,10 +113,13 @@ class WsResponseHandler {
 		virtual bool validate_payload();
 		virtual void get_file_content(int pid, int (&fd)[2]) = 0;
 		virtual void get_file_content(std::string& path);
-		bool save_file(const std::string& save_path, const std::string& content);
+		bool offload(IoTask* task);
+		bool resume_save(IoSaveFiles& task);
+		bool resume_delete(IoRemoveFile& task);
+		void save_failed(int error);
 		virtual std::string header(int code, size_t content_size, std::string mime);
 		virtual bool send_response(const std::string& body, const std::string& path);
-		bool sender(const std::string& body);
+		bool enqueue(const std::string& body);
 		std::string default_plain_error();
 		void turn_off_sanity(e_http_sts status, std::string detail);
 	public:
@@ -118,6 +131,7 @@ class WsResponseHandler {
 						  int fd);
 		virtual ~WsResponseHandler();
 		virtual bool handle_request();
+		virtual bool resume(IoTask* task);
 		bool send_error_response();
 		bool redirection();
 };
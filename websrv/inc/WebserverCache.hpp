@@ -6,113 +6,429 @@
 /*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/11/06 09:53:58 by mporras-          #+#    #+#             */
-/*   Updated: 2024/11/30 17:13:40 by mporras-         ###   ########.fr       */
+/*   Updated: 2026/10/18 18:05:12 by mporras-         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
+
 #ifndef _WEBSERVER_CACHE_HPP_
 #define _WEBSERVER_CACHE_HPP_
 
-#include <map>
-#include <list>
 #include <string>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdint.h>
 
+// Default byte budget of the file cache (file_cache_size directive).
+#define WS_FILE_CACHE_BYTES (64 * 1024 * 1024)
+// Default milliseconds a cached file is trusted before stat()ing it again (file_cache_valid directive).
+#define WS_FILE_CACHE_VALID 1000
+// Default files kept open by each listener (open_file_cache directive).
+#define WS_OPEN_FILE_CACHE_MAX 64
+// Byte budget of the request (routing) caches.
+#define WS_REQUEST_CACHE_BYTES (1024 * 1024)
+// Byte budget of the negative cache, paths known to be missing.
+#define WS_NEGATIVE_CACHE_BYTES (256 * 1024)
+// Default milliseconds a missing path is answered from the negative cache (negative_cache_valid directive).
+#define WS_NEGATIVE_CACHE_VALID 500
+// An entry may take at most 1/WS_CACHE_MAX_SHARE of the budget.
+#define WS_CACHE_MAX_SHARE 8
+// Initial number of hash buckets, always a power of two.
+#define WS_CACHE_MIN_BUCKETS 64
 
 /**
- * @brief A simple, in-memory Least Recently Used (LRU) cache.
+ * @brief Reference counted block holding a cached value.
  *
- * The `WebServerCache` class is designed to manage a fixed-size cache for
- * storing frequently accessed items in a web server context. It utilizes a
- * Least Recently Used (LRU) eviction policy, where the least recently accessed
- * entry is removed when the cache reaches its maximum capacity.
+ * The cache keeps one reference while the entry is indexed, every
+ * `CacheHandle` keeps another. The block is deleted by the last `release`,
+ * so an entry evicted while a response is still being sent stays valid
+ * until that response is done.
  *
- * @tparam T The data type of the entries stored in the cache.
- *           The data type `T` should have a `std::string` member named `url`
- *           or a similar identifier that can be used to uniquely identify cache entries.
+ * Counters are not atomic: caches and handles belong to a single worker.
+ */
+class CacheBlock {
+	private:
+		size_t  _refs;
+
+		CacheBlock(const CacheBlock&);
+		CacheBlock& operator=(const CacheBlock&);
+	protected:
+		CacheBlock(): _refs(1) {}
+		virtual ~CacheBlock() {}
+	public:
+		void retain() {
+			_refs++;
+		}
+		void release() {
+			if (--_refs == 0) {
+				delete this;
+			}
+		}
+};
+
+/**
+ * @brief Cache block carrying a read-only `T`.
+ */
+template <typename T>
+class CacheValue : public CacheBlock {
+	public:
+		const T value;
+
+		explicit CacheValue(const T& v): CacheBlock(), value(v) {}
+};
+
+/**
+ * @brief Shared, read-only reference to a cached value.
+ *
+ * Copying a handle only bumps the block counter, the value itself is never
+ * copied. An empty handle (`valid() == false`) must not be dereferenced.
+ */
+template <typename T>
+class CacheHandle {
+	private:
+		CacheValue<T>*  _block;
+
+	public:
+		CacheHandle(): _block(NULL) {}
+		explicit CacheHandle(CacheValue<T>* block): _block(block) {
+			if (_block) {
+				_block->retain();
+			}
+		}
+		CacheHandle(const CacheHandle& other): _block(other._block) {
+			if (_block) {
+				_block->retain();
+			}
+		}
+		CacheHandle& operator=(const CacheHandle& other) {
+			if (other._block) {
+				other._block->retain();
+			}
+			if (_block) {
+				_block->release();
+			}
+			_block = other._block;
+			return (*this);
+		}
+		~CacheHandle() {
+			reset();
+		}
+		void reset() {
+			if (_block) {
+				_block->release();
+				_block = NULL;
+			}
+		}
+		bool valid() const {
+			return (_block != NULL);
+		}
+		const T& operator*() const {
+			return (_block->value);
+		}
+		const T* operator->() const {
+			return (&_block->value);
+		}
+		/**
+		 * @brief Underlying block, to keep the value alive beyond this handle.
+		 */
+		CacheBlock* block() const {
+			return (_block);
+		}
+};
+
+/**
+ * @brief Byte bounded, O(1) Least Recently Used (LRU) cache.
+ *
+ * Entries are indexed in a chained hash table (FNV-1a over the key) and linked
+ * in an intrusive LRU list, so `get`, `put` and `remove` cost O(1) on average,
+ * independently of the number of entries.
+ *
+ * The cache is bounded by bytes rather than by entries: each entry costs
+ * `T::cache_size()` plus its key and bookkeeping, and least recently used
+ * entries are evicted until the total fits in the budget. Entries bigger than
+ * 1/WS_CACHE_MAX_SHARE of the budget are not admitted, so one large file can
+ * not flush everything else.
+ *
+ * Lookups return a `CacheHandle` sharing the stored value, no copy is made.
+ *
+ * @tparam T Type of the cached values. It must be copy constructible and
+ *           provide `size_t cache_size() const`, the bytes it holds.
+ *
+ * @note Not thread-safe. Each worker owns its caches.
+ * @note Copies of a cache start empty, with the same budget: entries are not
+ *       shared between owners.
  */
 template <typename T>
 class WebServerCache {
-private:
-	size_t                                                  _capacity;
-	std::list<T>                                            _entries;
-	std::map<std::string, typename std::list<T>::iterator>  _cache_map;
-
-public:
-	/**
-     * @brief Constructs a cache with a specified maximum capacity.
-     *
-     * @param capacity The maximum number of entries the cache can hold.
-     */
-	explicit WebServerCache(size_t capacity) : _capacity(capacity) {}
-
-	explicit WebServerCache(): _capacity(100) {}
-
-	/**
-     * @brief Retrieves an entry from the cache.
-     *
-     * This method searches the cache for an entry with the specified key.
-     * If the entry is found, it is moved to the front of the LRU list.
-     *
-     * @param key The unique key identifying the cache entry.
-     * @param entry Reference to an object where the retrieved entry will be stored.
-     *
-     * @return `true` if the entry was found and `entry` was updated; otherwise, `false`.
-     */
-	bool get(const std::string& key, T& entry) {
-		typename std::map<std::string, typename std::list<T>::iterator>::iterator it = _cache_map.find(key);
-		if (it == _cache_map.end()) {
-			return false;
-		}
-
-		_entries.splice(_entries.begin(), _entries, it->second);
-		entry = *(it->second);
-		return true;
-	}
-
-	/**
-     * @brief Adds or updates an entry in the cache.
-     *
-     * If an entry with the specified key already exists, it is updated and moved
-     * to the front of the LRU list. If the cache is at capacity, the least
-     * recently used entry is removed to make space for the new entry.
-     *
-     * @param key The unique key identifying the cache entry.
-     * @param entry The entry to be added or updated in the cache.
-     */
-	void put(const std::string& key, const T& entry) {
-		typename std::map<std::string, typename std::list<T>::iterator>::iterator it = _cache_map.find(key);
-
-		if (it != _cache_map.end()) {
-			_entries.splice(_entries.begin(), _entries, it->second);
-			*(it->second) = entry;
-			return;
-		}
-
-		if (_entries.size() >= _capacity) {
-			std::string lru_key = _entries.back().url;
-			_cache_map.erase(lru_key);
-			_entries.pop_back();
-		}
-
-		_entries.push_front(entry);
-		_cache_map[key] = _entries.begin();
-	}
-	/**
-	* @brief Removes a specific entry from the cache by its key.
-	* This function searches for the entry with the specified key in the cache. If found, it removes the entry from both
-	* the list (which maintains the order of usage) and the map (which provides quick access by key).
-	*
-	* @param key The key associated with the cache entry to be removed.
-	*
-	*@note The cache is updated to remove the entry, making space for new entries if necessary.
-	*/
-	void remove(const std::string& key) {
-		typename std::map<std::string, typename std::list<T>::iterator>::iterator it = _cache_map.find(key);
-
-		if (it != _cache_map.end()) {
-			_entries.erase(it->second);
-			_cache_map.erase(it);
-		}
-	}
+	private:
+		struct Node {
+			std::string     key;
+			uint32_t        hash;
+			size_t          cost;
+			CacheValue<T>*  block;
+			Node*           chain;
+			Node*           prev;
+			Node*           next;
+		};
+
+		size_t              _budget;
+		size_t              _used;
+		size_t              _count;
+		std::vector<Node*>  _buckets;
+		Node                _lru;
+
+		static uint32_t hash_key(const std::string& key) {
+			uint32_t hash = 2166136261u;
+			for (size_t i = 0; i < key.size(); i++) {
+				hash ^= static_cast<unsigned char>(key[i]);
+				hash *= 16777619u;
+			}
+			return (hash);
+		}
+
+		void init() {
+			_used = 0;
+			_count = 0;
+			_buckets.assign(WS_CACHE_MIN_BUCKETS, NULL);
+			_lru.prev = &_lru;
+			_lru.next = &_lru;
+		}
+
+		Node** slot(const std::string& key, uint32_t hash) {
+			Node** link = &_buckets[hash & (_buckets.size() - 1)];
+			while (*link && ((*link)->hash != hash || (*link)->key != key)) {
+				link = &(*link)->chain;
+			}
+			return (link);
+		}
+
+		void lru_unlink(Node* node) {
+			node->prev->next = node->next;
+			node->next->prev = node->prev;
+		}
+
+		void lru_push_front(Node* node) {
+			node->prev = &_lru;
+			node->next = _lru.next;
+			_lru.next->prev = node;
+			_lru.next = node;
+		}
+
+		/**
+		 * @brief Doubles the bucket table, keeping the load factor under 1.
+		 */
+		void grow() {
+			std::vector<Node*> buckets(_buckets.size() * 2, NULL);
+			for (size_t i = 0; i < _buckets.size(); i++) {
+				Node* node = _buckets[i];
+				while (node) {
+					Node* chain = node->chain;
+					Node*& head = buckets[node->hash & (buckets.size() - 1)];
+					node->chain = head;
+					head = node;
+					node = chain;
+				}
+			}
+			_buckets.swap(buckets);
+		}
+
+		/**
+		 * @brief Unindexes the node at `link` and drops the cache reference.
+		 */
+		void erase(Node** link) {
+			Node* node = *link;
+			*link = node->chain;
+			lru_unlink(node);
+			_used -= node->cost;
+			_count--;
+			node->block->release();
+			delete node;
+		}
+
+		/**
+		 * @brief Hangs the nodes `first`..`last` of another list on `sentinel`.
+		 *
+		 * `first == other` means that list was empty.
+		 */
+		static void relink(Node& sentinel, Node* first, Node* last, const Node* other) {
+			if (first == other) {
+				sentinel.prev = &sentinel;
+				sentinel.next = &sentinel;
+				return ;
+			}
+			sentinel.next = first;
+			sentinel.prev = last;
+			first->prev = &sentinel;
+			last->next = &sentinel;
+		}
+
+		void evict(size_t budget) {
+			while (_used > budget && _lru.prev != &_lru) {
+				Node* victim = _lru.prev;
+				erase(slot(victim->key, victim->hash));
+			}
+		}
+
+	public:
+		/**
+		 * @brief Constructs an empty cache.
+		 *
+		 * @param budget Maximum bytes held by the cache. 0 disables it.
+		 */
+		explicit WebServerCache(size_t budget): _budget(budget) {
+			init();
+		}
+
+		WebServerCache(): _budget(WS_REQUEST_CACHE_BYTES) {
+			init();
+		}
+
+		WebServerCache(const WebServerCache& other): _budget(other._budget) {
+			init();
+		}
+
+		WebServerCache& operator=(const WebServerCache& other) {
+			if (this != &other) {
+				clear();
+				_budget = other._budget;
+			}
+			return (*this);
+		}
+
+		~WebServerCache() {
+			clear();
+		}
+
+		/**
+		 * @brief Looks an entry up and marks it as the most recently used.
+		 *
+		 * @param key The unique key identifying the cache entry.
+		 * @param entry Output. Shares the cached value when found.
+		 * @return `true` if the entry was found; otherwise, `false`.
+		 */
+		bool get(const std::string& key, CacheHandle<T>& entry) {
+			Node* node = *slot(key, hash_key(key));
+			if (!node) {
+				return (false);
+			}
+			lru_unlink(node);
+			lru_push_front(node);
+			entry = CacheHandle<T>(node->block);
+			return (true);
+		}
+
+		/**
+		 * @brief Adds or replaces an entry, evicting LRU entries over the budget.
+		 *
+		 * A replaced value stays alive for the handles still pointing to it.
+		 * Entries over 1/WS_CACHE_MAX_SHARE of the budget are not stored (a
+		 * previous value under the same key is dropped).
+		 *
+		 * @param key The unique key identifying the cache entry.
+		 * @param entry Value to store. It is copied once into the cache.
+		 * @return `true` if the entry was stored.
+		 */
+		bool put(const std::string& key, const T& entry) {
+			uint32_t hash = hash_key(key);
+			Node** link = slot(key, hash);
+			if (*link) {
+				erase(link);
+			}
+			size_t cost = entry.cache_size() + key.size() + sizeof(Node);
+			if (cost > _budget / WS_CACHE_MAX_SHARE) {
+				return (false);
+			}
+			evict(_budget - cost);
+			if (_count >= _buckets.size()) {
+				grow();
+			}
+			Node* node = new Node;
+			node->key = key;
+			node->hash = hash;
+			node->cost = cost;
+			node->block = new CacheValue<T>(entry);
+			Node*& head = _buckets[hash & (_buckets.size() - 1)];
+			node->chain = head;
+			head = node;
+			lru_push_front(node);
+			_used += cost;
+			_count++;
+			return (true);
+		}
+
+		/**
+		 * @brief Removes an entry. Handles already given out stay valid.
+		 *
+		 * This method should be called when a cached path or content returns an error.
+		 *
+		 * @param key The key associated with the cache entry to be removed.
+		 */
+		void remove(const std::string& key) {
+			Node** link = slot(key, hash_key(key));
+			if (*link) {
+				erase(link);
+			}
+		}
+
+		/**
+		 * @brief Removes every entry `stale(key, value)` is true for.
+		 *
+		 * @tparam P Functor with `bool operator()(const std::string&, const T&) const`.
+		 * @param stale Tells the entries to drop.
+		 * @return Entries removed.
+		 */
+		template <typename P>
+		size_t remove_if(const P& stale) {
+			size_t removed = 0;
+			for (size_t i = 0; i < _buckets.size(); i++) {
+				Node** link = &_buckets[i];
+				while (*link) {
+					if (stale((*link)->key, (*link)->block->value)) {
+						erase(link);
+						removed++;
+					} else {
+						link = &(*link)->chain;
+					}
+				}
+			}
+			return (removed);
+		}
+
+		/**
+		 * @brief Exchanges entries and budget with another cache, in O(1).
+		 *
+		 * Handles given out by either cache stay valid.
+		 */
+		void swap(WebServerCache& other) {
+			Node* first = _lru.next;
+			Node* last = _lru.prev;
+			relink(_lru, other._lru.next, other._lru.prev, &other._lru);
+			relink(other._lru, first, last, &_lru);
+			std::swap(_budget, other._budget);
+			std::swap(_used, other._used);
+			std::swap(_count, other._count);
+			_buckets.swap(other._buckets);
+		}
+
+		/**
+		 * @brief Drops every entry.
+		 */
+		void clear() {
+			evict(0);
+			init();
+		}
+
+		size_t size() const {
+			return (_count);
+		}
+
+		size_t used() const {
+			return (_used);
+		}
+
+		size_t budget() const {
+			return (_budget);
+		}
 };
 
 #endif
@@ -0,0 +1,32 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   http_scan.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 21:02:47 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 21:02:47 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef _HTTP_SCAN_HPP_
+#define _HTTP_SCAN_HPP_
+
+#include <cstddef>
+
+/**
+ * @brief Up to four delimiter bytes searched at once by `ws_scan`.
+ *
+ * Build it with `ws_scan_set`; unused slots repeat the last delimiter.
+ */
+typedef struct s_scan_set {
+	char    bytes[4];
+} t_scan_set;
+
+t_scan_set ws_scan_set(const char* delimiters);
+size_t ws_scan(const char* data, size_t length, const t_scan_set& set);
+size_t ws_find_header_end(const char* data, size_t length, size_t& resume);
+const char* ws_scan_kernel();
+
+#endif
@@ -66,8 +66,7 @@
 #define MID_GRAY		"\033[38;5;245m"
 #define DARK_GREEN		"\033[38;2;75;179;82m"
 #define DARK_YELLOW		"\033[38;5;143m"
-#define WS_MAX_RETRIES 5
-#define WS_RETRY_DELAY_MICROSECONDS 100000
+#define WS_MAX_WORKERS 256
 
 // TODO: define a path max for WS only, path max is defined at limits.h
 # ifndef PATH_MAX
@@ -90,12 +89,15 @@ size_t end_of_header_system(std::string& header);
 std::string int_to_string(int number);
 bool is_dir(const std::string& path);
 bool is_file(const std::string& path);
+std::string clean_path(const std::string& path);
 bool starts_with(const std::string& str, const std::string& prefix);
 bool to_trim_char(char c, const std::string& chars_to_trim);
 std::string trim(const std::string& str, const std::string& chars_to_trim);
 std::string to_lowercase(const std::string& input);
 bool is_valid_size_t(const std::string& value);
 size_t str_to_size_t(const std::string& value);
+std::string http_date(time_t when);
+bool parse_http_date(const std::string& date, time_t& when);
 
 
 
@@ -114,6 +116,7 @@ std::string html_codes(int code);
 // Parse
 
 std::vector<ServerConfig> parse_file(std::string file, Logger* logger);
+bool reload_file(const std::string& file, Logger* logger, std::vector<ServerConfig>& servers);
 std::vector<ServerConfig> parse_servers(std::vector<std::string> rawLines, Logger* logger);
 LocationConfig parse_location_block(std::vector<std::string>::iterator start, std::vector<std::string>::iterator end, Logger* logger);
 
@@ -140,6 +143,7 @@ std::vector<std::string>::iterator skip_block(std::vector<std::string>::iterator
 std::vector<std::string>::iterator find_block_end(std::vector<std::string>::iterator start, std::vector<std::string>::iterator end);
 std::string get_location_path(std::string line);
 t_mode string_to_error_mode(std::string error_mode);
+t_event_backend string_to_event_backend(std::string backend);
 std::string join_paths(std::string path1, std::string path2);
 std::vector<std::string> split_string(std::string str);
 unsigned char method_bitwise(std::string parsed);
@@ -166,8 +170,15 @@ bool check_brackets(std::vector<std::string>::iterator start, std::vector<std::s
 bool check_autoindex(std::string autoindex);
 t_allowed_methods string_to_method(std::string method);
 bool check_error_mode(std::string error_mode);
+bool check_event_backend(std::string backend);
+bool check_workers(std::string workers);
+bool check_worker_processes(std::string processes);
+bool check_io_threads(std::string threads);
+bool check_milliseconds(std::string milliseconds);
+bool check_open_file_cache(std::string files);
 bool check_duplicate_servers(std::vector<ServerConfig> servers);
 bool check_cgi(std::string cgi);
+bool check_on_off(std::string value);
 bool check_obligatory_params(ServerConfig& server, Logger* logger);
 bool check_server_brackets(std::string server_name);
 bool check_duplicate_location(const std::string& location_path, const std::map<std::string, LocationConfig>& locations);
@@ -184,6 +195,21 @@ void parse_error_page(std::vector<std::string>::iterator& it, Logger* logger, Se
 void parse_autoindex(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& server);
 void parse_error_mode(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& server);
 
+// Parse Global
+void parse_global_directives(std::vector<std::string>& rawLines, Logger* logger, ServerConfig& global);
+void inherit_global_config(const ServerConfig& global, ServerConfig& server);
+void parse_event_backend(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+void parse_workers(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+void parse_worker_processes(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+void parse_worker_cpu_affinity(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+void parse_io_threads(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+void parse_file_cache_size(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+void parse_file_cache_valid(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+void parse_open_file_cache(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+void parse_negative_cache_valid(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+void parse_negative_cache_check_dir(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+void parse_file_watch(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global);
+
 // Parse Location
 void parse_location_index(std::vector<std::string>::iterator& it, Logger* logger, LocationConfig& location);
 void parse_location_error_page(std::vector<std::string>::iterator& it, Logger* logger, LocationConfig& location);
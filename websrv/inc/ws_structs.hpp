@@ -13,6 +13,9 @@
 #ifndef WS_STRUCTS_HPP
 #define WS_STRUCTS_HPP
 #include "WebserverCache.hpp"
+#include "IoPool.hpp"
+#include "RadixRouter.hpp"
+#include <sys/stat.h>
 
 /**
  * @brief Represents different operational modes for processing.
@@ -25,6 +28,21 @@ typedef enum e_mode {
 	INVALID_ERROR_MODE=-42
 } t_mode;
 
+/**
+ * @brief Readiness notification mechanism used by the event loop.
+ *
+ * Selected at startup with the global `event_backend` directive. `BACKEND_AUTO`
+ * resolves to the most efficient mechanism available on the build platform
+ * (edge-triggered epoll on Linux, poll elsewhere).
+ */
+typedef enum e_event_backend {
+	BACKEND_AUTO=0,
+	BACKEND_POLL=1,
+	BACKEND_EPOLL=2,
+	BACKEND_URING=3,
+	INVALID_BACKEND=-42
+} t_event_backend;
+
 /**
  * @brief Represents the type of a file path in an HTTP request.
  *
@@ -38,6 +56,22 @@ enum e_path_type {
 	PATH_RELATIVE = 3
 };
 
+/**
+ * @brief Read progress of a request, kept between readiness events.
+ *
+ * A request can arrive over several events. The reader consumes what the
+ * socket has, records how far it got, and resumes from there on the next one.
+ *
+ * - `READ_HEADER`: waiting for the header-body delimiter.
+ * - `READ_BODY`: header parsed, waiting for the rest of the body.
+ * - `READ_DONE`: request fully received.
+ */
+enum e_read_phase {
+	READ_HEADER = 0,
+	READ_BODY = 1,
+	READ_DONE = 2
+};
+
 /**
  * @brief Represents metadata for a CGI (Common Gateway Interface) request.
  *
@@ -82,6 +116,7 @@ struct LocationConfig {
 	bool                                autoindex;
 	bool                                cgi_file;
 	std::map<std::string, t_cgi>		cgi_locations;
+	RadixRouter<t_cgi>                  cgi_router;
 	std::map<int, std::string>			redirections;
 	bool								is_root;
 	bool                                is_redir;
@@ -95,6 +130,7 @@ struct LocationConfig {
 			autoindex(false),
 			cgi_file(false),
 			cgi_locations(),
+			cgi_router(),
 			redirections(),
 			is_root(false),
 			is_redir(false),
@@ -118,6 +154,7 @@ struct LocationConfig {
 			autoindex(false),
 			cgi_file(false),
 			cgi_locations(),
+			cgi_router(),
 			redirections(),
 			is_root(false),
 			is_redir(false),
@@ -127,42 +164,66 @@ struct LocationConfig {
 	}
 };
 
-struct CacheRequest;
-
 struct ServerConfig {
 	int                                           port;
+	int                                           listen_fd;  // Inherited listener (prefork), -1 binds one
 	std::string                                   server_name;
 	std::string                                   server_root;
 	t_mode                                        error_mode;
 	std::map<int, std::string>                    error_pages;
 	std::map<std::string, struct LocationConfig>  locations;
+	RadixRouter<LocationConfig>                   location_router;
 	std::vector<std::string>                      default_pages;
 	size_t                                        client_max_body_size;
 	bool                                          autoindex;
 	std::string                                   template_error_page;
 	bool										  cgi_locations;
+	std::string                                   source;     // Lines it was parsed from, global ones included
 	//	------>>> General config, apply to all servers. Here to make it faster at exec
 	std::string ws_root;
 	std::string ws_errors_root;
 	t_mode      ws_error_mode;
-	WebServerCache<CacheRequest>                  request_cache;
+	t_event_backend ws_event_backend;
+	size_t          ws_workers;
+	size_t          ws_processes;
+	bool            ws_cpu_affinity;
+	size_t          ws_io_threads;
+	size_t          ws_file_cache_size;
+	size_t          ws_file_cache_valid;
+	size_t          ws_open_file_cache;
+	size_t          ws_negative_cache_valid;
+	bool            ws_negative_cache_check_dir;
+	bool            ws_file_watch;
 
 	ServerConfig()
 			: port(-42),
+			  listen_fd(-1),
 			  server_name(),
 			  server_root(),
 			  error_mode(),
 			  error_pages(),
 			  locations(),
+			  location_router(),
 			  default_pages(),
 			  client_max_body_size(0),
 			  autoindex(false),
 			  template_error_page(),
 			  cgi_locations(false),
+			  source(),
 			  ws_root(),
 			  ws_errors_root(),
 			  ws_error_mode(),
-			  request_cache(WebServerCache<CacheRequest>(100)) {
+			  ws_event_backend(BACKEND_AUTO),
+			  ws_workers(1),
+			  ws_processes(0),
+			  ws_cpu_affinity(false),
+			  ws_io_threads(IO_POOL_THREADS),
+			  ws_file_cache_size(WS_FILE_CACHE_BYTES),
+			  ws_file_cache_valid(WS_FILE_CACHE_VALID),
+			  ws_open_file_cache(WS_OPEN_FILE_CACHE_MAX),
+			  ws_negative_cache_valid(WS_NEGATIVE_CACHE_VALID),
+			  ws_negative_cache_check_dir(false),
+			  ws_file_watch(true) {
 		error_pages.clear();
 		locations.clear();
 		default_pages.clear();
@@ -200,7 +261,12 @@ struct s_request {
 	std::string             script;
 	std::string             boundary;
 	std::string             range;
+	std::string             if_none_match;
+	std::string             if_modified_since;
+	std::string             route_key;
+	std::string             mime;
 	bool                    chunks;
+	bool                    framed;
 	int                     factory;
 	bool                    is_cached;
 	bool                    autoindex;
@@ -211,6 +277,9 @@ struct s_request {
 	const LocationConfig*   location;
 	ServerConfig*           host_config;
 	bool                    request_ready;
+	e_read_phase            read_phase;
+	size_t                  header_scanned;
+	size_t                  header_end;
 
 	s_request():
 			header(),
@@ -231,7 +300,12 @@ struct s_request {
 			script(),
 			boundary(),
 			range(),
+			if_none_match(),
+			if_modified_since(),
+			route_key(),
+			mime(),
 			chunks(false),
+			framed(false),
 			factory(0),
 			is_cached(false),
 			autoindex(false),
@@ -241,7 +315,10 @@ struct s_request {
 			status(HTTP_I_AM_A_TEAPOT),
 			location(NULL),
 			host_config(NULL),
-			request_ready(false) {}
+			request_ready(false),
+			read_phase(READ_HEADER),
+			header_scanned(0),
+			header_end(std::string::npos) {}
 
 	void clear_request () {
 		header.clear();
@@ -262,7 +339,12 @@ struct s_request {
 		script.clear();
 		boundary.clear();
 		range.clear();
+		if_none_match.clear();
+		if_modified_since.clear();
+		route_key.clear();
+		mime.clear();
 		chunks = false;
+		framed = false;
 		factory = 0;
 		is_cached = false;
 		autoindex = false;
@@ -273,56 +355,210 @@ struct s_request {
 		location = NULL;
 		host_config = NULL;
 		request_ready = false;
+		read_phase = READ_HEADER;
+		header_scanned = 0;
+		header_end = std::string::npos;
 	}
 };
 
+/**
+ * @brief Identity of a file version: device, inode, size and modification time.
+ *
+ * Two stamps differ as soon as the file is edited, replaced or moved over,
+ * even within the same second.
+ */
+struct FileStamp {
+	dev_t   dev;
+	ino_t   ino;
+	off_t   size;
+	time_t  mtime;
+	long    mtime_nsec;
+
+	FileStamp(): dev(0), ino(0), size(0), mtime(0), mtime_nsec(0) {};
+	explicit FileStamp(const struct stat& st):
+		dev(st.st_dev),
+		ino(st.st_ino),
+		size(st.st_size),
+		mtime(st.st_mtime),
+#ifdef __APPLE__
+		mtime_nsec(st.st_mtimespec.tv_nsec) {};
+#else
+		mtime_nsec(st.st_mtim.tv_nsec) {};
+#endif
+	bool operator==(const FileStamp& other) const {
+		return (dev == other.dev && ino == other.ino && size == other.size
+				&& mtime == other.mtime && mtime_nsec == other.mtime_nsec);
+	};
+};
+
+/**
+ * @brief Version of a watched directory, as `FileWatcher` saw it.
+ *
+ * `wd` is the watch of the directory, -1 when it is not watched (the entry
+ * then relies on its validity time alone). `generation` changes whenever an
+ * entry of the directory is created, deleted or moved.
+ */
+typedef struct s_watch_stamp {
+	int         wd;
+	uint64_t    generation;
+	s_watch_stamp(): wd(-1), generation(0) {};
+} t_watch_stamp;
+
 /**
  * @brief Represents an entry in the server's cache.
  *
  * This structure stores a URL and its corresponding content, allowing the
- * server to quickly respond to requests for cached resources.
+ * server to quickly respond to requests for cached resources. `stamp` is the
+ * file version the content was read from, and `validated` the last time
+ * (TimerWheel::now_msec) it was checked against the file. `validated` is
+ * refreshed through shared, read-only handles, hence mutable.
+ *
+ * `head` holds the 200 response header lines that do not depend on the
+ * request, already serialized: from the end of the `Host` line to the
+ * `Content-Type` line, then, from `head_split` on, the validators and the
+ * blank line. The `Connection` lines of the client go in between.
  */
 struct CacheEntry {
 	std::string			url;
 	std::string			content;
+	std::string			head;
+	size_t				head_split;
+	FileStamp			stamp;
+	mutable uint64_t	validated;
 
-	CacheEntry(const std::string &u, const std::string &c):
+	CacheEntry(const std::string &u, const std::string &c,
+			   const std::string &h, size_t split,
+			   const FileStamp& s, uint64_t v):
 	    url(u),
-	    content(c) {};
-	CacheEntry(): url(), content(){
+	    content(c),
+	    head(h),
+	    head_split(split),
+	    stamp(s),
+	    validated(v) {};
+	CacheEntry(): url(), content(), head(), head_split(0), stamp(), validated(0) {
 		url.clear();
 		content.clear();
 	};
+	size_t cache_size() const {
+		return (url.size() + content.size() + head.size());
+	};
 };
 
 /**
- * @brief Represents a request to retrieve a cached resource.
+ * @brief Handler a route resolves to.
+ *
+ * - `ROUTE_STATIC`: a file, sent by `HttpResponseHandler`.
+ * - `ROUTE_AUTOINDEX`: a directory listing.
+ * - `ROUTE_CGI`: a script run by `HttpCGIHandler`.
+ * - `ROUTE_REDIRECT`: a redirection of the location.
+ */
+typedef enum e_route_kind {
+	ROUTE_STATIC=0,
+	ROUTE_AUTOINDEX=1,
+	ROUTE_CGI=2,
+	ROUTE_REDIRECT=3
+} t_route_kind;
+
+/**
+ * @brief Routing outcome of a request, cached to skip resource resolution.
  *
- * This structure stores metadata about a cache request, including the URL,
- * server configuration, location configuration, and normalized path.
+ * Stores everything `solver_resource` works out for a method, host and path:
+ * the location, the handler kind, the path once rewritten by the location, the
+ * resolved file (or script and path info for CGI), the MIME type of the file
+ * and the methods the location allows. `resolved` is the `TimerWheel::now_msec`
+ * time the route was resolved, older routes are resolved again. `watch` is the
+ * version of the directory the route was resolved from, when it is watched.
  */
 struct CacheRequest {
 	std::string             url;
 	const ServerConfig*     host;
 	const LocationConfig*   location;
+	t_route_kind            kind;
+	std::string             path;
 	std::string             normalized_path;
+	std::string             script;
+	std::string             path_info;
+	std::string             mime;
+	unsigned char           allowed;
+	uint64_t                resolved;
+	t_watch_stamp           watch;
 
-	CacheRequest(const std::string& u,
-				 const ServerConfig* h,
-				 const LocationConfig* loc,
-				 const std::string& np):
-			 url(u),
-			 host(h),
-			 location(loc),
-			 normalized_path(np) {};
+	CacheRequest(const std::string& key,
+				 const s_request& request,
+				 t_route_kind route,
+				 const std::string& mime_type,
+				 uint64_t now):
+			 url(key),
+			 host(request.host_config),
+			 location(request.location),
+			 kind(route),
+			 path(request.path),
+			 normalized_path(request.normalized_path),
+			 script(request.script),
+			 path_info(request.path_info),
+			 mime(mime_type),
+			 allowed(request.location->loc_allowed_methods),
+			 resolved(now),
+			 watch() {};
 
 	CacheRequest():
 			 url(),
 			 host(NULL),
 			 location(NULL),
-			 normalized_path() {
-		url.clear();
-		normalized_path.clear();
+			 kind(ROUTE_STATIC),
+			 path(),
+			 normalized_path(),
+			 script(),
+			 path_info(),
+			 mime(),
+			 allowed(0),
+			 resolved(0),
+			 watch() {};
+	size_t cache_size() const {
+		return (sizeof(CacheRequest) + url.size() + path.size() + normalized_path.size()
+				+ script.size() + path_info.size() + mime.size());
+	};
+};
+
+/**
+ * @brief A path known to be missing, cached to answer repeated 404s.
+ *
+ * `location` is the location the path belongs to, its error pages answer the
+ * hit. `dir` is the deepest directory of the resolved path that exists, and
+ * `dir_stamp` its version when the miss was cached: if it changes, a file may
+ * have been created below it. Both are only set when directory checks are on
+ * (`negative_cache_check_dir`). `resolved` is the `TimerWheel::now_msec` time
+ * of the miss. `watch` is the version of that directory, when it is watched.
+ */
+struct CacheMiss {
+	std::string             url;
+	const LocationConfig*   location;
+	std::string             dir;
+	FileStamp               dir_stamp;
+	uint64_t                resolved;
+	t_watch_stamp           watch;
+
+	CacheMiss(const std::string& key,
+			  const LocationConfig* loc,
+			  const std::string& directory,
+			  const FileStamp& stamp,
+			  uint64_t now):
+			url(key),
+			location(loc),
+			dir(directory),
+			dir_stamp(stamp),
+			resolved(now),
+			watch() {};
+
+	CacheMiss():
+			url(),
+			location(NULL),
+			dir(),
+			dir_stamp(),
+			resolved(0),
+			watch() {};
+	size_t cache_size() const {
+		return (sizeof(CacheMiss) + url.size() + dir.size());
 	};
 };
 
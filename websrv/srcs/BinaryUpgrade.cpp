@@ -0,0 +1,249 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BinaryUpgrade.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 18:05:37 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 18:05:37 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "BinaryUpgrade.hpp"
+#include <set>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+extern char** environ;
+
+/**
+ * @brief Keeps the command line, to execute the new binary the same way.
+ *
+ * The server never changes its working directory, so relative paths (binary
+ * and configuration file) stay valid for the new process.
+ *
+ * @param argc Count of arguments.
+ * @param argv Arguments of the process; `argv[0]` is the binary executed on upgrade.
+ * @param logger Pointer to the Logger instance.
+ *
+ * @throws Logger::NoLoggerPointer If the logger pointer is null.
+ */
+BinaryUpgrade::BinaryUpgrade(int argc, char** argv, const Logger* logger):
+	_log(logger),
+	_parent(0),
+	_child(-1),
+	_disabled(0) {
+	if (_log == NULL) {
+		throw Logger::NoLoggerPointer();
+	}
+	for (int i = 0; i < argc; i++) {
+		_args.push_back(argv[i]);
+	}
+}
+
+BinaryUpgrade::~BinaryUpgrade() {}
+
+/**
+ * @brief Adopts the listening sockets handed over by the previous binary, if any.
+ *
+ * Each socket listed in `WEBSERVER_LISTENERS` is checked (a listening socket
+ * bound to the port it is listed for) and stored in every config of its port
+ * (`listen_fd`). A port no longer configured has its socket closed. Ports
+ * without an inherited socket are bound as usual. Both variables are removed
+ * from the environment, so CGI scripts and later upgrades do not see them.
+ *
+ * @param configs Parsed configuration.
+ */
+void BinaryUpgrade::inherit(std::vector<ServerConfig>& configs) {
+	const char* value = getenv(BU_LISTENERS_ENV);
+	const char* from = getenv(BU_PARENT_ENV);
+	if (value == NULL) {
+		return ;
+	}
+	std::string list(value);
+	if (from != NULL) {
+		_parent = (pid_t)std::atol(from);
+	}
+	unsetenv(BU_LISTENERS_ENV);
+	unsetenv(BU_PARENT_ENV);
+	std::istringstream stream(list);
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		size_t colon = item.find(':');
+		if (colon == std::string::npos) {
+			_log->log_warning(BU_NAME, "Malformed inherited listener: " + item);
+			continue ;
+		}
+		int port = std::atoi(item.substr(0, colon).c_str());
+		int fd = std::atoi(item.substr(colon + 1).c_str());
+		if (!is_listener(fd, port)) {
+			_log->log_warning(BU_NAME, "Inherited fd " + int_to_string(fd)
+									   + " is not a listener of port " + int_to_string(port));
+			continue ;
+		}
+		fcntl(fd, F_SETFD, FD_CLOEXEC);
+		bool used = false;
+		for (size_t i = 0; i < configs.size(); i++) {
+			if (configs[i].port == port && configs[i].listen_fd < 0) {
+				configs[i].listen_fd = fd;
+				used = true;
+			}
+		}
+		if (used) {
+			_log->status(BU_NAME, "Listener of port " + int_to_string(port) + " inherited.");
+		} else {
+			close(fd);
+			_log->log_info(BU_NAME, "Port " + int_to_string(port) + " no longer configured, listener closed.");
+		}
+	}
+}
+
+/**
+ * @brief Closes the inherited sockets once the servers hold their own duplicates.
+ *
+ * Used without worker processes: every `SocketHandler` duplicates the
+ * listener of its config, so the inherited descriptors are no longer needed.
+ * With worker processes the `ProcessSupervisor` owns them instead.
+ *
+ * @param configs Parsed configuration.
+ */
+void BinaryUpgrade::release_inherited(std::vector<ServerConfig>& configs) {
+	std::set<int> closed;
+	for (size_t i = 0; i < configs.size(); i++) {
+		int fd = configs[i].listen_fd;
+		if (fd >= 0 && closed.insert(fd).second) {
+			close(fd);
+		}
+		configs[i].listen_fd = -1;
+	}
+}
+
+/**
+ * @brief Tells whether a descriptor is a listening socket bound to a port.
+ */
+bool BinaryUpgrade::is_listener(int fd, int port) {
+	int listening = 0;
+	socklen_t size = sizeof(listening);
+	if (fd < 0 || getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &size) != 0
+		|| !listening) {
+		return (false);
+	}
+	sockaddr_in address;
+	socklen_t address_size = sizeof(address);
+	std::memset(&address, 0, sizeof(address));
+	if (getsockname(fd, (struct sockaddr*)&address, &address_size) != 0
+		|| address.sin_family != AF_INET) {
+		return (false);
+	}
+	return (ntohs(address.sin_port) == port);
+}
+
+/**
+ * @brief Builds the arguments and environment of the new binary.
+ *
+ * Called once the listeners are open, before the signal handlers are
+ * installed: `start` only reads what is built here.
+ *
+ * @param listeners Listening sockets to hand over, `port -> fd`.
+ */
+void BinaryUpgrade::prepare(const std::map<int, int>& listeners) {
+	std::ostringstream list;
+	_fds.clear();
+	for (std::map<int, int>::const_iterator it = listeners.begin(); it != listeners.end(); it++) {
+		list << (_fds.empty() ? "" : ",") << it->first << ":" << it->second;
+		_fds.push_back(it->second);
+	}
+	std::string listeners_prefix = std::string(BU_LISTENERS_ENV) + "=";
+	std::string parent_prefix = std::string(BU_PARENT_ENV) + "=";
+	_env.clear();
+	for (char** env = environ; env != NULL && *env != NULL; env++) {
+		if (std::strncmp(*env, listeners_prefix.c_str(), listeners_prefix.size()) != 0
+			&& std::strncmp(*env, parent_prefix.c_str(), parent_prefix.size()) != 0) {
+			_env.push_back(*env);
+		}
+	}
+	_env.push_back(listeners_prefix + list.str());
+	_env.push_back(parent_prefix + int_to_string((int)getpid()));
+	_envp.clear();
+	for (size_t i = 0; i < _env.size(); i++) {
+		_envp.push_back(const_cast<char*>(_env[i].c_str()));
+	}
+	_envp.push_back(NULL);
+	_argv.clear();
+	for (size_t i = 0; i < _args.size(); i++) {
+		_argv.push_back(const_cast<char*>(_args[i].c_str()));
+	}
+	_argv.push_back(NULL);
+}
+
+/**
+ * @brief Asks the previous binary to drain, once this one is ready to serve.
+ *
+ * Only after an upgrade, and only if the previous binary is still the parent
+ * process: a pid reused by another process is never signalled.
+ */
+void BinaryUpgrade::notify_parent() {
+	if (_parent <= 1) {
+		return ;
+	}
+	if (getppid() != _parent) {
+		_log->log_warning(BU_NAME, "Previous binary (pid " + int_to_string((int)_parent)
+								   + ") is gone, nothing to drain.");
+	} else if (kill(_parent, SIGQUIT) == 0) {
+		_log->status(BU_NAME, "Binary upgrade completed. Previous binary (pid "
+							  + int_to_string((int)_parent) + ") is draining.");
+	} else {
+		_log->log_error(BU_NAME, "Unable to signal the previous binary (pid "
+								 + int_to_string((int)_parent) + ").");
+	}
+	_parent = 0;
+}
+
+/**
+ * @brief Forks and executes the new binary with the listening sockets. Async-signal-safe.
+ *
+ * Ignored until `prepare` ran, after `disable`, and while the process started by
+ * the previous call still runs. In the child the signal mask is cleared (the
+ * handler runs with the signal blocked) and the listeners lose `FD_CLOEXEC`,
+ * so they survive the `execve`.
+ */
+void BinaryUpgrade::start() {
+	if (_disabled || _argv.empty()) {
+		return ;
+	}
+	if (_child > 0 && waitpid(_child, NULL, WNOHANG) == 0) {
+		return ;
+	}
+	pid_t pid = fork();
+	if (pid == 0) {
+		sigset_t none;
+		sigemptyset(&none);
+		sigprocmask(SIG_SETMASK, &none, NULL);
+		for (size_t i = 0; i < _fds.size(); i++) {
+			fcntl(_fds[i], F_SETFD, 0);
+		}
+		execve(_argv[0], &_argv[0], &_envp[0]);
+		const char error[] = "ERROR: Binary upgrade failed, unable to execute the new binary.\n";
+		ssize_t written = write(STDERR_FILENO, error, sizeof(error) - 1);
+		(void)written;
+		_exit(127);
+	}
+	if (pid > 0) {
+		_child = pid;
+	}
+}
+
+/**
+ * @brief Ignores any further upgrade request, once the process is draining. Async-signal-safe.
+ */
+void BinaryUpgrade::disable() {
+	_disabled = 1;
+}
@@ -0,0 +1,195 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ChunkedDecoder.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 22:10:36 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 22:10:36 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "ChunkedDecoder.hpp"
+
+/**
+ * @brief Value of a hexadecimal digit, or -1.
+ */
+static int hex_value(char c) {
+	if (c >= '0' && c <= '9') {
+		return (c - '0');
+	}
+	if (c >= 'a' && c <= 'f') {
+		return (c - 'a' + 10);
+	}
+	if (c >= 'A' && c <= 'F') {
+		return (c - 'A' + 10);
+	}
+	return (-1);
+}
+
+/**
+ * @brief Constructs a decoder ready for a body without size limit.
+ */
+ChunkedDecoder::ChunkedDecoder():
+	_state(CK_SIZE),
+	_max_body(static_cast<size_t>(-1)),
+	_chunk_left(0),
+	_digits(0),
+	_line(0),
+	_trailer(0) {}
+
+/**
+ * @brief Prepares the decoder for a new body.
+ *
+ * @param max_body Largest decoded body accepted (`client_max_body_size`).
+ */
+void ChunkedDecoder::reset(size_t max_body) {
+	_state = CK_SIZE;
+	_max_body = max_body;
+	_chunk_left = 0;
+	_digits = 0;
+	_line = 0;
+	_trailer = 0;
+}
+
+/**
+ * @brief Tells if the whole body was decoded.
+ */
+bool ChunkedDecoder::done() const {
+	return (_state == CK_DONE);
+}
+
+t_chunk_status ChunkedDecoder::fail(t_chunk_status status) {
+	_state = CK_ERROR;
+	return (status);
+}
+
+/**
+ * @brief Decodes as much of `data` as possible.
+ *
+ * @param data Bytes received, starting where the previous call stopped.
+ * @param length Bytes in `data`.
+ * @param consumed Output. Bytes of `data` used; the caller drops them. Equal
+ *                 to `length` unless the body ended inside `data`.
+ * @param body Decoded payload is appended here.
+ * @return The decoder status after these bytes.
+ */
+t_chunk_status ChunkedDecoder::feed(const char* data, size_t length, size_t& consumed, std::string& body) {
+	size_t i = 0;
+
+	consumed = 0;
+	if (_state == CK_ERROR) {
+		return (CHUNK_BAD);
+	}
+	while (i < length && _state != CK_DONE) {
+		char c = data[i];
+		switch (_state) {
+			case CK_SIZE: {
+				int digit = hex_value(c);
+				if (digit >= 0) {
+					if (_chunk_left > (_max_body - body.size()) / 16) {
+						return (fail(CHUNK_TOO_LARGE));
+					}
+					_chunk_left = _chunk_left * 16 + digit;
+					_digits++;
+				} else if (_digits > 0 && (c == ';' || c == ' ' || c == '\t')) {
+					_state = CK_EXTENSION;
+				} else if (_digits > 0 && c == '\r') {
+					_state = CK_SIZE_LF;
+				} else {
+					return (fail(CHUNK_BAD));
+				}
+				if (_chunk_left > _max_body - body.size()) {
+					return (fail(CHUNK_TOO_LARGE));
+				}
+				if (++_line > CHUNK_LINE_MAX) {
+					return (fail(CHUNK_BAD));
+				}
+				i++;
+				break;
+			}
+			case CK_EXTENSION:
+				if (c == '\r') {
+					_state = CK_SIZE_LF;
+				} else if (c == '\n') {
+					return (fail(CHUNK_BAD));
+				}
+				if (++_line > CHUNK_LINE_MAX) {
+					return (fail(CHUNK_BAD));
+				}
+				i++;
+				break;
+			case CK_SIZE_LF:
+				if (c != '\n') {
+					return (fail(CHUNK_BAD));
+				}
+				_digits = 0;
+				_line = 0;
+				_state = (_chunk_left == 0) ? CK_TRAILER : CK_DATA;
+				i++;
+				break;
+			case CK_DATA: {
+				size_t take = length - i;
+				if (take > _chunk_left) {
+					take = _chunk_left;
+				}
+				body.append(data + i, take);
+				_chunk_left -= take;
+				i += take;
+				if (_chunk_left == 0) {
+					_state = CK_DATA_CR;
+				}
+				break;
+			}
+			case CK_DATA_CR:
+				if (c != '\r') {
+					return (fail(CHUNK_BAD));
+				}
+				_state = CK_DATA_LF;
+				i++;
+				break;
+			case CK_DATA_LF:
+				if (c != '\n') {
+					return (fail(CHUNK_BAD));
+				}
+				_state = CK_SIZE;
+				i++;
+				break;
+			case CK_TRAILER:
+				_state = (c == '\r') ? CK_END_LF : CK_TRAILER_LINE;
+				if (++_trailer > CHUNK_TRAILER_MAX) {
+					return (fail(CHUNK_BAD));
+				}
+				i++;
+				break;
+			case CK_TRAILER_LINE:
+				if (c == '\r') {
+					_state = CK_TRAILER_LF;
+				}
+				if (++_trailer > CHUNK_TRAILER_MAX) {
+					return (fail(CHUNK_BAD));
+				}
+				i++;
+				break;
+			case CK_TRAILER_LF:
+				if (c != '\n') {
+					return (fail(CHUNK_BAD));
+				}
+				_state = CK_TRAILER;
+				i++;
+				break;
+			case CK_END_LF:
+				if (c != '\n') {
+					return (fail(CHUNK_BAD));
+				}
+				_state = CK_DONE;
+				i++;
+				break;
+			default:
+				return (fail(CHUNK_BAD));
+		}
+	}
+	consumed = i;
+	return (_state == CK_DONE ? CHUNK_DONE : CHUNK_MORE);
+}
@@ -20,7 +20,7 @@
  *
  * @param server Pointer to the server's `SocketHandler`, responsible for managing the client connection.
  * @param log Pointer to the `Logger` instance for recording client activities.
- * @param fd File descriptor for the client's socket, set to monitor read events (`POLLIN`).
+ * @param fd File descriptor for the client's socket. Its event tag points back to this instance.
  */
 ClientData::ClientData(SocketHandler* server,
 					   const Logger* log, int fd):
@@ -28,11 +28,13 @@ ClientData::ClientData(SocketHandler* server,
 					   _log(log),
 					   _active(false),
 					   _alive(true),
-					   _client_fd() {
+					   _client_fd(fd),
+					   _event_tag(EV_CLIENT, this),
+					   _interest(WS_EV_READ),
+					   _timer(this),
+					   _read_pending(false),
+					   _io_task(NULL) {
 
-	_client_fd.fd = fd;
-	_client_fd.events = POLLIN | POLLOUT;
-	_client_fd.revents = 0;
 	_timestamp = std::time(NULL);
 	_log->log_debug( CD_MODULE,
 			  "Client Data init.");
@@ -60,8 +62,9 @@ ClientData::~ClientData() {
 void ClientData::close_fd() {
 	try {
 		_active = false;
-		if (_client_fd.fd) {
-			close(_client_fd.fd);
+		if (_client_fd >= 0) {
+			close(_client_fd);
+			_client_fd = -1;
 			_log->log_warning( CD_MODULE,
 			          "client fd closed and set to inactive.");
 		} else {
@@ -87,17 +90,26 @@ SocketHandler* ClientData::get_server() {
 
 
 /**
- * @brief Retrieves the client's poll file descriptor structure.
+ * @brief Retrieves the client's socket file descriptor.
  *
- * Provides access to the `pollfd` structure, which contains the client's file descriptor
- * and event monitoring settings (e.g., `POLLIN` for incoming data).
- *
- * @return A `pollfd` structure containing the client's file descriptor and polling events.
+ * @return The client's file descriptor, -1 once it has been closed.
  */
-struct pollfd ClientData::get_fd() {
+int ClientData::get_fd() const {
 	return (_client_fd);
 }
 
+/**
+ * @brief Retrieves the tag registered with this client's fd in the event backend.
+ *
+ * The tag carries a pointer to this instance, so the event loop gets the
+ * `ClientData` of a ready descriptor without any lookup.
+ *
+ * @return Pointer to the client's event tag.
+ */
+t_event_tag* ClientData::event_tag() {
+	return (&_event_tag);
+}
+
 /**
  * @brief Checks if the client connection has exceeded the request timeout.
  *
@@ -177,9 +189,11 @@ bool ClientData::is_alive() const {
  *
  * Updates the `_active` flag to `true`, indicating that the client connection
  * is currently in use and not eligible for cleanup or timeout handling.
+ * A server that stopped listening (draining) keeps no connection: the flag stays
+ * `false`, so the response says `Connection: close`.
  */
 void ClientData::keep_active() {
-	_active = true;
+	_active = _server->is_listening();
 }
 
 /**
@@ -218,3 +232,143 @@ void ClientData::set_state(short state) {
 short ClientData::get_state() const {
 	return (_state);
 }
+
+/**
+ * @brief Retrieves the client's timer, linked in the `ServerManager` timer wheel.
+ *
+ * The node is a member of the client, so arming and re-arming a deadline never
+ * allocates. `kind` holds the `t_deadline` currently guarded.
+ *
+ * @return Pointer to the client's timer node.
+ */
+t_timer_node* ClientData::timer() {
+	return (&_timer);
+}
+
+/**
+ * @brief Phase guarded by the timer currently armed.
+ */
+t_deadline ClientData::deadline_kind() const {
+	return (static_cast<t_deadline>(_timer.kind));
+}
+
+/**
+ * @brief Duration, in milliseconds, allowed for each connection phase.
+ *
+ * @param kind Connection phase.
+ * @return Milliseconds from the moment the phase starts.
+ */
+t_msec ClientData::deadline_span(t_deadline kind) {
+	switch (kind) {
+		case DEADLINE_HEADER:
+			return (TIMEOUT_HEADER_MS);
+		case DEADLINE_BODY:
+			return (TIMEOUT_BODY_MS);
+		case DEADLINE_KEEPALIVE:
+			return (TIMEOUT_KEEPALIVE_MS);
+		case DEADLINE_SEND:
+			return (TIMEOUT_SEND_MS);
+		case DEADLINE_IO:
+			return (TIMEOUT_IO_MS);
+	}
+	return (TIMEOUT_HEADER_MS);
+}
+
+/**
+ * @brief Retrieves the bytes received from the client and not consumed yet.
+ *
+ * The buffer outlives each `HttpRequestHandler`, so a request split across
+ * several events is rebuilt here. It is not cleared with the request: bytes
+ * past the end of a request belong to the next one.
+ *
+ * @return Reference to the client's read buffer.
+ */
+std::string& ClientData::read_buffer() {
+	return (_read_buffer);
+}
+
+/**
+ * @brief Tells if the last read stopped before the socket was empty.
+ *
+ * An edge-triggered backend does not report those bytes again, so
+ * `ServerManager` posts the client to read them.
+ */
+bool ClientData::read_pending() const {
+	return (_read_pending);
+}
+
+/**
+ * @brief Records whether the last read left bytes in the socket.
+ *
+ * @param pending `true` if the read stopped before `recv()` reported an empty socket.
+ */
+void ClientData::set_read_pending(bool pending) {
+	_read_pending = pending;
+}
+
+/**
+ * @brief Retrieves the queue of response bytes waiting to be written.
+ *
+ * Response handlers enqueue here and return; `ServerManager` drains the queue
+ * when the socket is writable.
+ *
+ * @return Reference to the client's output queue.
+ */
+OutputQueue& ClientData::output() {
+	return (_output);
+}
+
+/**
+ * @brief Retrieves the decoder of the chunked body being received.
+ *
+ * It keeps its position in the chunked stream between events, so every byte
+ * is decoded once. It is reset when a request announces a chunked body.
+ *
+ * @return Reference to the client's chunked decoder.
+ */
+ChunkedDecoder& ClientData::chunk_decoder() {
+	return (_chunked);
+}
+
+/**
+ * @brief WS_EV_* interest the client fd is currently registered with.
+ */
+int ClientData::interest() const {
+	return (_interest);
+}
+
+/**
+ * @brief Records the WS_EV_* interest the client fd was registered with.
+ *
+ * @param events New interest, already applied to the event backend.
+ */
+void ClientData::set_interest(int events) {
+	_interest = events;
+}
+
+/**
+ * @brief Marks the client as waiting for an I/O task.
+ *
+ * The task belongs to the `IoPool` meanwhile; it is only used to tell that a
+ * completed task is still awaited by this client.
+ *
+ * @param task Task submitted for the current request.
+ */
+void ClientData::suspend(IoTask* task) {
+	task->client_fd = _client_fd;
+	_io_task = task;
+}
+
+/**
+ * @brief Ends the wait for the I/O task, once it completed.
+ */
+void ClientData::resume() {
+	_io_task = NULL;
+}
+
+/**
+ * @brief Task the current request waits for, or NULL.
+ */
+IoTask* ClientData::io_task() const {
+	return (_io_task);
+}
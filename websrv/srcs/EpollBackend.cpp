@@ -0,0 +1,155 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EpollBackend.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 11:27:45 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 11:27:45 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "EpollBackend.hpp"
+
+#ifdef WS_HAS_EPOLL
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include "WebserverException.hpp"
+
+/**
+ * @brief Constructs an edge-triggered epoll backend.
+ *
+ * @param log Pointer to the Logger instance.
+ * @throws Logger::NoLoggerPointer If the logger pointer is null.
+ * @throws WebServerException If the epoll instance cannot be created.
+ */
+EpollBackend::EpollBackend(const Logger* log):
+	_epoll_fd(-1),
+	_events(EP_MAX_EVENTS),
+	_log(log) {
+	if (_log == NULL) {
+		throw Logger::NoLoggerPointer();
+	}
+	_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (_epoll_fd < 0) {
+		throw WebServerException("Error creating epoll instance: " + std::string(strerror(errno)));
+	}
+	_log->log_debug(EP_NAME, "epoll backend ready.");
+}
+
+/**
+ * @brief Destructor. Closes the epoll instance, not the registered fds.
+ */
+EpollBackend::~EpollBackend() {
+	if (_epoll_fd >= 0) {
+		close(_epoll_fd);
+	}
+}
+
+/**
+ * @brief Translates WS_EV_* interest flags to edge-triggered epoll events.
+ */
+uint32_t EpollBackend::to_epoll(int events) {
+	uint32_t epoll_events = EPOLLET | EPOLLRDHUP;
+	if (events & WS_EV_READ)
+		epoll_events |= EPOLLIN;
+	if (events & WS_EV_WRITE)
+		epoll_events |= EPOLLOUT;
+	return (epoll_events);
+}
+
+/**
+ * @brief Thin wrapper around epoll_ctl.
+ */
+bool EpollBackend::control(int op, int fd, int events, t_event_tag* tag) {
+	struct epoll_event event;
+	std::memset(&event, 0, sizeof(event));
+	event.events = to_epoll(events);
+	event.data.ptr = tag;
+	if (epoll_ctl(_epoll_fd, op, fd, &event) < 0) {
+		_log->log_warning(EP_NAME, "epoll_ctl failed: " + std::string(strerror(errno)));
+		return (false);
+	}
+	return (true);
+}
+
+/**
+ * @brief Registers a file descriptor.
+ *
+ * @param fd File descriptor to monitor.
+ * @param events WS_EV_* interest flags.
+ * @param tag Owner data returned with every event of this fd.
+ * @return true on success, false otherwise.
+ */
+bool EpollBackend::add(int fd, int events, t_event_tag* tag) {
+	if (fd < 0) {
+		_log->log_error(EP_NAME, "Invalid file descriptor.");
+		return (false);
+	}
+	return (control(EPOLL_CTL_ADD, fd, events, tag));
+}
+
+/**
+ * @brief Changes the interest flags of a registered fd.
+ *
+ * EPOLL_CTL_MOD also re-arms the edge: if the descriptor is already ready for
+ * any requested condition, an event is reported on the next wait.
+ */
+bool EpollBackend::modify(int fd, int events, t_event_tag* tag) {
+	return (control(EPOLL_CTL_MOD, fd, events, tag));
+}
+
+/**
+ * @brief Stops monitoring a file descriptor.
+ *
+ * Closing a descriptor removes it from the interest list as well, so a failure
+ * here (EBADF) is not reported as an error.
+ */
+bool EpollBackend::remove(int fd) {
+	struct epoll_event event;
+	std::memset(&event, 0, sizeof(event));
+	return (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, &event) == 0);
+}
+
+/**
+ * @brief Waits for events and fills `ready` with them.
+ *
+ * @param ready Output vector. Cleared before being filled.
+ * @param timeout_ms Maximum wait in milliseconds, -1 to block.
+ * @return Number of ready descriptors, 0 on timeout, -1 on error (errno is kept).
+ */
+int EpollBackend::wait(std::vector<t_event>& ready, int timeout_ms) {
+	ready.clear();
+	int count = epoll_wait(_epoll_fd, &_events[0], (int)_events.size(), timeout_ms);
+	if (count <= 0) {
+		return (count);
+	}
+	for (int i = 0; i < count; ++i) {
+		uint32_t flags = _events[i].events;
+		t_event event;
+		event.tag = static_cast<t_event_tag*>(_events[i].data.ptr);
+		event.events = 0;
+		if (flags & EPOLLIN)
+			event.events |= WS_EV_READ;
+		if (flags & EPOLLOUT)
+			event.events |= WS_EV_WRITE;
+		if (flags & (EPOLLHUP | EPOLLRDHUP))
+			event.events |= WS_EV_HUP;
+		if (flags & EPOLLERR)
+			event.events |= WS_EV_ERROR;
+		ready.push_back(event);
+	}
+	return (count);
+}
+
+bool EpollBackend::edge_triggered() const {
+	return (true);
+}
+
+const char* EpollBackend::name() const {
+	return ("epoll");
+}
+
+#endif
@@ -0,0 +1,65 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventBackend.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 11:06:30 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 11:06:30 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "EventBackend.hpp"
+#include "PollBackend.hpp"
+#include "EpollBackend.hpp"
+#include "UringBackend.hpp"
+#include "WebserverException.hpp"
+
+/**
+ * @brief Builds the event backend requested by configuration.
+ *
+ * `BACKEND_AUTO` picks edge-triggered epoll when the platform provides it and
+ * poll otherwise. Asking explicitly for epoll on a platform without it is
+ * reported and falls back to poll, so a config file stays portable.
+ * `BACKEND_URING` is probed at runtime: a kernel or system where io_uring
+ * can not be used is reported, and falls back as `BACKEND_AUTO` does.
+ *
+ * @param kind Backend selected with the `event_backend` directive.
+ * @param log Pointer to the Logger instance.
+ * @return A heap allocated backend. Ownership goes to the caller.
+ *
+ * @throws WebServerException If the backend cannot be initialized.
+ */
+EventBackend* EventBackend::create(t_event_backend kind, const Logger* log) {
+	if (log == NULL) {
+		throw Logger::NoLoggerPointer();
+	}
+#ifdef WS_HAS_URING
+	if (kind == BACKEND_URING) {
+		try {
+			return (new UringBackend(log));
+		} catch (const WebServerException& e) {
+			log->log_warning(EB_NAME, std::string(e.what()) + " Falling back.");
+			kind = BACKEND_AUTO;
+		}
+	}
+#else
+	if (kind == BACKEND_URING) {
+		log->log_warning(EB_NAME,
+						 "io_uring is not available on this platform. Falling back.");
+		kind = BACKEND_AUTO;
+	}
+#endif
+#ifdef WS_HAS_EPOLL
+	if (kind == BACKEND_AUTO || kind == BACKEND_EPOLL) {
+		return (new EpollBackend(log));
+	}
+#else
+	if (kind == BACKEND_EPOLL) {
+		log->log_warning(EB_NAME,
+						 "epoll is not available on this platform. Using poll.");
+	}
+#endif
+	return (new PollBackend(log));
+}
@@ -0,0 +1,331 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   FileWatcher.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 23:05:12 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 23:05:12 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "FileWatcher.hpp"
+#include <cerrno>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+# include <sys/inotify.h>
+#endif
+
+#ifdef __linux__
+// Events a directory is watched for.
+# define FW_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE \
+				  | IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_ONLYDIR)
+#endif
+
+/**
+ * @brief Constructs an idle watcher. `start` opens the inotify instance.
+ *
+ * @param log Pointer to the Logger instance.
+ */
+FileWatcher::FileWatcher(const Logger* log):
+	_fd(-1),
+	_log(log),
+	_watches(),
+	_paths(),
+	_generation(0),
+	_full(false) {}
+
+/**
+ * @brief Destructor. Closes the inotify instance, which drops every watch.
+ */
+FileWatcher::~FileWatcher() {
+	if (_fd >= 0) {
+		close(_fd);
+	}
+}
+
+/**
+ * @brief Opens the inotify instance, non-blocking and close-on-exec.
+ *
+ * @return `false` if inotify is not available (not Linux, or out of instances).
+ */
+bool FileWatcher::start() {
+#ifdef __linux__
+	_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (_fd < 0) {
+		_log->log_warning(FW_NAME, "inotify is not available, caches rely on their validity time.");
+		return (false);
+	}
+	return (true);
+#else
+	_log->log_info(FW_NAME, "inotify is not available, caches rely on their validity time.");
+	return (false);
+#endif
+}
+
+/**
+ * @brief Tells if the inotify instance is open.
+ */
+bool FileWatcher::active() const {
+	return (_fd >= 0);
+}
+
+/**
+ * @brief inotify descriptor, to be registered for read readiness.
+ */
+int FileWatcher::get_fd() const {
+	return (_fd);
+}
+
+/**
+ * @brief Watches a directory and every directory below it.
+ *
+ * @param root Top directory. Missing directories are ignored.
+ */
+void FileWatcher::watch_tree(const std::string& root) {
+	if (_fd < 0) {
+		return ;
+	}
+	watch_dir(clean_path(root), NULL);
+}
+
+/**
+ * @brief Watches `path` and, recursively, its subdirectories.
+ *
+ * @param path Clean path of the directory.
+ * @param found If not NULL, every entry met is appended as `CHANGE_NAME`: the
+ *        directory was just created, and its entries may predate the watch.
+ */
+void FileWatcher::watch_dir(const std::string& path, std::vector<t_file_event>* found) {
+#ifdef __linux__
+	if (_paths.find(path) != _paths.end()) {
+		return ;
+	}
+	if (_watches.size() >= FW_MAX_WATCHES) {
+		if (!_full) {
+			_log->log_warning(FW_NAME, "Watch limit reached, " + path + " and the rest are not watched.");
+			_full = true;
+		}
+		return ;
+	}
+	int wd = inotify_add_watch(_fd, path.c_str(), FW_MASK);
+	if (wd < 0) {
+		if (errno == ENOSPC && !_full) {
+			_log->log_warning(FW_NAME, "System watch limit reached at " + path + ".");
+			_full = true;
+		}
+		return ;
+	}
+	if (_watches.find(wd) != _watches.end()) {
+		return ;
+	}
+	_watches[wd].path = path;
+	_watches[wd].generation = ++_generation;
+	_paths[path] = wd;
+	DIR* dir = opendir(path.c_str());
+	if (dir == NULL) {
+		return ;
+	}
+	std::vector<std::string> subdirs;
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL) {
+		std::string name = entry->d_name;
+		if (name == "." || name == "..") {
+			continue ;
+		}
+		std::string full_path = (path == "/" ? path : path + "/") + name;
+		if (found) {
+			found->push_back(t_file_event(CHANGE_NAME, full_path));
+		}
+		struct stat info;
+		if (lstat(full_path.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+			subdirs.push_back(full_path);
+		}
+	}
+	closedir(dir);
+	for (size_t i = 0; i < subdirs.size(); i++) {
+		watch_dir(subdirs[i], found);
+	}
+#else
+	(void)path;
+	(void)found;
+#endif
+}
+
+/**
+ * @brief Drops the bookkeeping of a watch the kernel removed.
+ */
+void FileWatcher::forget(int wd) {
+	std::map<int, t_watch>::iterator it = _watches.find(wd);
+	if (it == _watches.end()) {
+		return ;
+	}
+	_paths.erase(it->second.path);
+	_watches.erase(it);
+	_full = false;
+}
+
+/**
+ * @brief Removes the watches of `path` and of every directory below it.
+ *
+ * Used when a directory moves: the kernel keeps following it, under a path
+ * this watcher does not know.
+ */
+void FileWatcher::unwatch_tree(const std::string& path) {
+#ifdef __linux__
+	std::string prefix = path + "/";
+	std::vector<int> drop;
+	std::map<std::string, int>::iterator it = _paths.find(path);
+	if (it != _paths.end()) {
+		drop.push_back(it->second);
+	}
+	for (it = _paths.lower_bound(prefix); it != _paths.end() && starts_with(it->first, prefix); ++it) {
+		drop.push_back(it->second);
+	}
+	for (size_t i = 0; i < drop.size(); i++) {
+		inotify_rm_watch(_fd, drop[i]);
+		forget(drop[i]);
+	}
+#else
+	(void)path;
+#endif
+}
+
+/**
+ * @brief Renews the generation of a directory: its entries changed.
+ */
+void FileWatcher::bump(int wd) {
+	std::map<int, t_watch>::iterator it = _watches.find(wd);
+	if (it != _watches.end()) {
+		it->second.generation = ++_generation;
+	}
+}
+
+/**
+ * @brief Reads every pending inotify event and translates it to path changes.
+ *
+ * The descriptor is drained, as an edge-triggered backend requires.
+ * - Entries created, deleted or moved renew the generation of their
+ *   directory and are reported as `CHANGE_NAME`. A new directory is watched
+ *   at once and its entries reported too.
+ * - Writes and attribute changes are reported as `CHANGE_CONTENT`; a run of
+ *   writes to the same file is reported once.
+ * - A lost queue, or a watched directory moved, renews every generation and
+ *   is reported as `CHANGE_RESET`.
+ *
+ * @param events Output. Changes are appended.
+ * @return `true` if any change was appended.
+ */
+bool FileWatcher::read_events(std::vector<t_file_event>& events) {
+	size_t before = events.size();
+#ifdef __linux__
+	char buffer[FW_READ_BUFFER] __attribute__((aligned(__alignof__(struct inotify_event))));
+	while (_fd >= 0) {
+		ssize_t length = read(_fd, buffer, sizeof(buffer));
+		if (length < 0 && errno == EINTR) {
+			continue ;
+		}
+		if (length <= 0) {
+			break ;
+		}
+		for (char* ptr = buffer; ptr < buffer + length; ) {
+			const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+			ptr += sizeof(struct inotify_event) + event->len;
+			if (event->mask & IN_Q_OVERFLOW) {
+				_log->log_warning(FW_NAME, "Event queue overflow, every cache entry is renewed.");
+				invalidate_all();
+				events.push_back(t_file_event(CHANGE_RESET, ""));
+				continue ;
+			}
+			if (event->mask & IN_IGNORED) {
+				forget(event->wd);
+				continue ;
+			}
+			std::map<int, t_watch>::iterator watch = _watches.find(event->wd);
+			if (watch == _watches.end()) {
+				continue ;
+			}
+			if (event->mask & IN_MOVE_SELF) {
+				unwatch_tree(watch->second.path);
+				invalidate_all();
+				events.push_back(t_file_event(CHANGE_RESET, ""));
+				continue ;
+			}
+			if (event->len == 0) {
+				continue ;
+			}
+			const std::string& dir = watch->second.path;
+			std::string path = (dir == "/" ? dir : dir + "/") + event->name;
+			if (event->mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)) {
+				bump(event->wd);
+				events.push_back(t_file_event(CHANGE_NAME, path));
+				if (event->mask & IN_ISDIR) {
+					if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+						watch_dir(path, &events);
+					} else if (event->mask & IN_MOVED_FROM) {
+						unwatch_tree(path);
+						invalidate_all();
+						events.push_back(t_file_event(CHANGE_RESET, ""));
+					}
+				}
+				continue ;
+			}
+			if (events.size() > before && events.back().change == CHANGE_CONTENT
+				&& events.back().path == path) {
+				continue ;
+			}
+			events.push_back(t_file_event(CHANGE_CONTENT, path));
+		}
+	}
+#endif
+	return (events.size() > before);
+}
+
+/**
+ * @brief Current version of a directory, to be kept with a cache entry.
+ *
+ * @param dir Directory the entry depends on.
+ * @return Its stamp; `wd` is -1 if the directory is not watched.
+ */
+t_watch_stamp FileWatcher::stamp(const std::string& dir) const {
+	t_watch_stamp result;
+	std::map<std::string, int>::const_iterator it = _paths.find(clean_path(dir));
+	if (it != _paths.end()) {
+		result.wd = it->second;
+		result.generation = _watches.find(it->second)->second.generation;
+	}
+	return (result);
+}
+
+/**
+ * @brief Tells if the directory a stamp was taken from is unchanged.
+ *
+ * A stamp of an unwatched directory (`wd` -1) is always current, its entry
+ * relies on its validity time. A stamp whose watch is gone is never current.
+ */
+bool FileWatcher::current(const t_watch_stamp& stamp) const {
+	if (stamp.wd < 0) {
+		return (true);
+	}
+	std::map<int, t_watch>::const_iterator it = _watches.find(stamp.wd);
+	return (it != _watches.end() && it->second.generation == stamp.generation);
+}
+
+/**
+ * @brief Renews every generation: no stamp taken before is current anymore.
+ */
+void FileWatcher::invalidate_all() {
+	for (std::map<int, t_watch>::iterator it = _watches.begin(); it != _watches.end(); ++it) {
+		it->second.generation = ++_generation;
+	}
+}
+
+/**
+ * @brief Number of watched directories.
+ */
+size_t FileWatcher::size() const {
+	return (_watches.size());
+}
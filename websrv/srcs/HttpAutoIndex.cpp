@@ -43,10 +43,10 @@ HttpAutoIndex::HttpAutoIndex(const LocationConfig *location,
  *
  * This method processes an HTTP GET request to generate an automatic index page for a directory.
  * It first checks if the GET method is allowed on the requested resource. If not allowed, it sends an HTTP 403 Forbidden response.
- * If GET is allowed, it attempts to load the content of the directory by calling `get_file_content()`.
- * Depending on the success of the file content loading, it either sends the generated HTML response or returns an error response.
+ * If GET is allowed, the directory is listed by an `IoListDir` task, offloaded to the I/O pool;
+ * `resume` builds and sends the page once the entries are read.
  *
- * @return `true` if the request is handled successfully and the response is sent, otherwise `false`.
+ * @return `true` if the listing was offloaded or the response sent, otherwise `false`.
  *
  * @details
  * The method follows these main steps:
@@ -55,17 +55,9 @@ HttpAutoIndex::HttpAutoIndex(const LocationConfig *location,
  *    - If GET is not allowed, the method sets the response status to HTTP 403 (Forbidden) and sends an error response.
  *    - It then returns `false` indicating that the request was not handled successfully.
  *
- * 2. **Loading File Content**:
- *    - If GET is allowed, it calls `get_file_content()` to load the content of the directory indicated by `_request.normalized_path`.
- *    - If the directory content is successfully loaded (`_response_data.status` is `true`), it sets the MIME type to `text/html`.
- *    - Logs a debug message indicating that the file content will be sent.
- *    - Sends the response containing the generated directory index using `send_response()`.
- *    - Returns `true` if the response was successfully sent.
- *
- * 3. **Error Handling**:
- *    - If `get_file_content()` fails to load the directory content, it logs a debug message.
- *    - Sends an error response using `send_error_response()`.
- *    - Returns `false` indicating that an error occurred while handling the request.
+ * 2. **Listing the Directory**:
+ *    - Offloads an `IoListDir` of `_request.normalized_path`: `opendir`, `readdir` and the
+ *      `stat()` of every entry run on an I/O thread, or inline without a pool.
  */
 bool HttpAutoIndex::handle_request() {
 	if (!HAS_GET(_location->loc_allowed_methods)) {
@@ -74,7 +66,25 @@ bool HttpAutoIndex::handle_request() {
 		send_error_response();
 		return (false);
 	}
-	get_file_content(_request.normalized_path);
+	return (offload(new IoListDir(_request.normalized_path)));
+}
+
+/**
+ * @brief Sends the index page once the directory was listed.
+ *
+ * @param task Completed task. Other kinds are answered by `WsResponseHandler::resume`.
+ * @return `true` if the index was sent, otherwise `false`.
+ *
+ * @details
+ * - If the page was built (`_response_data.status` is `true`), it sets the MIME type to
+ *   `text/html` and sends it using `send_response()`.
+ * - Otherwise it sends an error response using `send_error_response()`.
+ */
+bool HttpAutoIndex::resume(IoTask* task) {
+	if (task->kind != IO_LIST_DIR) {
+		return (WsResponseHandler::resume(task));
+	}
+	build_index(static_cast<IoListDir&>(*task));
 	if (_response_data.status) {
 		_response_data.mime = "text/html";
 		_log->log_debug( RSP_NAME,
@@ -87,32 +97,31 @@ bool HttpAutoIndex::handle_request() {
 }
 
 /**
- * @brief Generates the content of an auto index for a given directory.
+ * @brief Generates the content of an auto index from a directory listing.
  *
- * This method reads the contents of a specified directory and generates an HTML page that serves as an automatic index.
- * It lists all the files and directories in the provided directory path, displaying details such as the file name, size, and last modified date.
+ * This method generates an HTML page that serves as an automatic index from the entries an
+ * `IoListDir` read. It lists all the files and directories, displaying details such as the
+ * file name, size, and last modified date. No system call is made here.
  *
- * @param path The path to the directory for which the auto index will be generated.
+ * @param listing Completed listing of `_request.normalized_path`.
  *
  * @details
  * The method follows these steps:
- * 1. **Open Directory**:
- *    - Attempts to open the directory specified by the `path`.
- *    - If the directory cannot be opened, it logs an error, sets the HTTP status to `HTTP_NOT_FOUND`, and exits the function.
+ * 1. **Directory Check**:
+ *    - If the directory could not be opened, it logs an error, sets the HTTP status to `HTTP_NOT_FOUND`, and exits the function.
  *
  * 2. **Generate HTML Content**:
  *    - Constructs the initial HTML structure, including the title, styles, and a heading indicating the directory being indexed.
- *    - Iterates over each entry in the directory, excluding `.` and `..`.
  *    - For each entry, constructs a table row containing:
  *      - A link to the file or directory.
  *      - The size (in bytes) if it is a file or the label `Directory` if it is a directory.
  *      - The last modified date in the format `YYYY-MM-DD HH:MM:SS`.
  *
  * 3. **Error Handling**:
- *    - If an error occurs while reading a file's information, logs an error and continues with the next entry.
+ *    - Entries whose information could not be read were left out by the listing; a warning is logged.
  *
- * 4. **Close Directory and Set Response**:
- *    - After iterating through all entries, the directory is closed, and the generated HTML content is stored in `_response_data.content`.
+ * 4. **Set Response**:
+ *    - The generated HTML content is stored in `_response_data.content`.
  *    - Sets `_response_data.status` to `true` to indicate that the content generation was successful.
  *
  * 5. **Exception Handling**:
@@ -120,14 +129,17 @@ bool HttpAutoIndex::handle_request() {
  *
  * @note This method generates a complete HTML page with a table format to present the directory content in a user-friendly way.
  */
-void HttpAutoIndex::get_file_content(std::string& path) {
+void HttpAutoIndex::build_index(const IoListDir& listing) {
 	try {
-		DIR* dir = opendir(path.c_str());
-		if (dir == NULL) {
+		if (!listing.opened) {
 			turn_off_sanity(HTTP_NOT_FOUND,
 			                "Dir cannot be open.");
 			return ;
 		}
+		if (listing.skipped > 0) {
+			_log->log_warning(AI_NAME,
+			                "Error reading file.");
+		}
 		std::string path_to_file = _request.path;
 		if (!_location->is_root && !_request.path_request.empty()) {
 			path_to_file = _request.path_request;
@@ -143,42 +155,30 @@ void HttpAutoIndex::get_file_content(std::string& path) {
 		out << "<h1 class=\"autoindex\">Index of : " << _request.path << "</h1>\n";
 		out << "<table>\n<tr><th>Name</th><th>Size</th><th>Last Modified</th></tr>\n";
 
-		struct dirent* entry;
-		while ((entry = readdir(dir)) != NULL) {
-			std::string name = entry->d_name;
-			if (name == "." || name == "..") {
-				continue;
-			}
-			std::string base_path = _request.normalized_path + name;
-			struct stat file_stat;
-			if (stat(base_path.c_str(), &file_stat) == -1) {
-				_log->log_warning(AI_NAME,
-				                "Error reading file.");
-				continue;
-			}
+		for (size_t i = 0; i < listing.items.size(); i++) {
+			const t_dir_item& item = listing.items[i];
 			out << "<tr>";
-			out << "<td><a href=\"" << path_to_file << name << "\">" << name << "</a></td>";
-			if (S_ISDIR(file_stat.st_mode)) {
+			out << "<td><a href=\"" << path_to_file << item.name << "\">" << item.name << "</a></td>";
+			if (item.is_dir) {
 				out << "<td>Directory</td>";
 			} else {
 				std::ostringstream size_stream;
-				size_stream << file_stat.st_size;
+				size_stream << item.size;
 				out << "<td>" << size_stream.str() << " bytes</td>";
 			}
 			char time_buf[80];
-			std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M:%S", std::localtime(&file_stat.st_mtime));
+			std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M:%S", std::localtime(&item.mtime));
 			out << "<td>" << time_buf << "</td>";
 
 			out << "</tr>\n";
 		}
 
 		out << "</table>\n</div>\n" << FOOTER_GENERAL << "</body>\n</html>";
-		closedir(dir);
 		_response_data.content = out.str();
 		_response_data.status = true;
 	} catch (std::exception& e) {
 		std::ostringstream detail;
-		detail << "Error Creating Autoindex file for " << path << ". Error: " << e.what();
+		detail << "Error Creating Autoindex file for " << listing.path << ". Error: " << e.what();
 		_log->log_warning(AI_NAME,detail.str());
 		turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
 						"Error Creating Autoindex data.");
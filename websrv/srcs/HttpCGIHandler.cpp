@@ -166,6 +166,9 @@ bool HttpCGIHandler::cgi_execute() {
 		return (false);
 	}
 	try {
+		// Built before fork: with worker threads, the child must not allocate.
+		std::string cgi_path = _request.normalized_path + _request.script;
+		char* const argv[] = { const_cast<char*>(cgi_path.c_str()), NULL };
 		pid_t pid = fork();
 		if (pid == -1) {
 			turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
@@ -186,9 +189,6 @@ bool HttpCGIHandler::cgi_execute() {
 			close(cgi_out[0]);
 			close(cgi_in[0]);
 			close(cgi_out[1]);
-
-			std::string cgi_path = _request.normalized_path + _request.script;
-			char* const argv[] = { const_cast<char*>(cgi_path.c_str()), NULL };
 			execve(cgi_path.c_str(), argv, _cgi_env.data());
 			_log->log_error( CGI_NAME,
 			          "execve function error.");
@@ -361,7 +361,7 @@ void HttpCGIHandler::free_cgi_env() {
 /**
  * @brief Sends the CGI response body to the client.
  *
- * This method invokes the `sender` function to transmit the response body to the client.
+ * This method invokes the `enqueue` function to queue the response body for the client.
  * The `path` parameter is unused in this context.
  *
  * @param body The response body content to be sent.
@@ -370,5 +370,5 @@ void HttpCGIHandler::free_cgi_env() {
  */
 bool HttpCGIHandler::send_response(const std::string &body, const std::string &path) {
 	UNUSED(path);
-	return(sender(body));
+	return(enqueue(body));
 }
@@ -0,0 +1,220 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   HttpHeaderIndex.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 20:14:03 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 20:14:03 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "HttpHeaderIndex.hpp"
+#include "http_scan.hpp"
+#include <cstring>
+#include <cctype>
+
+struct s_header_name {
+	const char* name;
+	size_t      length;
+};
+
+/**
+ * @brief Lower case names of the known headers, in `t_header_id` order.
+ */
+static const s_header_name g_header_names[HDR_COUNT] = {
+	{"host", 4},
+	{"content-length", 14},
+	{"content-type", 12},
+	{"transfer-encoding", 17},
+	{"range", 5},
+	{"connection", 10},
+	{"cookie", 6},
+	{"referer", 7},
+	{"if-none-match", 13},
+	{"if-modified-since", 17}
+};
+
+static bool is_ows(char c) {
+	return (c == ' ' || c == '\t');
+}
+
+/**
+ * @brief Compares `length` bytes case-insensitively with a lower case name.
+ */
+static bool same_name(const char* name, const char* known, size_t length) {
+	for (size_t i = 0; i < length; i++) {
+		if (std::tolower(static_cast<unsigned char>(name[i])) != known[i]) {
+			return (false);
+		}
+	}
+	return (true);
+}
+
+/**
+ * @brief Constructs an empty index.
+ */
+HttpHeaderIndex::HttpHeaderIndex():
+	_block(NULL) {}
+
+/**
+ * @brief Forgets every recorded field.
+ */
+void HttpHeaderIndex::clear() {
+	_block = NULL;
+	for (int id = 0; id < HDR_COUNT; id++) {
+		_fields[id] = t_header_field();
+	}
+}
+
+/**
+ * @brief Maps a field name to its id.
+ *
+ * Only names of the exact same length are compared, so most lines are
+ * discarded without looking at their bytes.
+ *
+ * @param name Field name, any case, without the colon.
+ * @param length Bytes of `name`.
+ * @return The header id, or `HDR_UNKNOWN`.
+ */
+t_header_id HttpHeaderIndex::lookup(const char* name, size_t length) {
+	for (int id = 0; id < HDR_COUNT; id++) {
+		if (g_header_names[id].length == length
+			&& same_name(name, g_header_names[id].name, length)) {
+			return (static_cast<t_header_id>(id));
+		}
+	}
+	return (HDR_UNKNOWN);
+}
+
+/**
+ * @brief Records a field, if it is a known one seen for the first time.
+ * A known field seen again is only marked as repeated.
+ *
+ * @param base First byte of the block.
+ * @param line First byte of the field line.
+ * @param colon Colon ending the field name.
+ * @param end End of the line, without CR/LF.
+ */
+void HttpHeaderIndex::record(const char* base, const char* line, const char* colon, const char* end) {
+	t_header_id id = lookup(line, colon - line);
+	if (id == HDR_UNKNOWN) {
+		return ;
+	}
+	if (_fields[id].present) {
+		_fields[id].repeated = true;
+		return ;
+	}
+	const char* value = colon + 1;
+	while (value < end && is_ows(*value)) {
+		value++;
+	}
+	while (end > value && is_ows(end[-1])) {
+		end--;
+	}
+	_fields[id].offset = value - base;
+	_fields[id].length = end - value;
+	_fields[id].present = true;
+}
+
+/**
+ * @brief Indexes the known fields of a header block, in a single pass.
+ *
+ * Line feeds and colons are located together by `ws_scan`: the first colon of
+ * a line ends its field name, the line feed ends the line.
+ *
+ * @param block Header block: request line and fields, without the final
+ *              empty line. It must outlive the lookups.
+ */
+void HttpHeaderIndex::index(const std::string& block) {
+	static const t_scan_set separators = ws_scan_set("\n:");
+	clear();
+	_block = &block;
+	const char* base = block.data();
+	size_t size = block.size();
+	size_t pos = ws_scan(base, size, separators);
+	while (pos < size && base[pos] != '\n') {
+		pos++;
+		pos += ws_scan(base + pos, size - pos, separators);
+	}
+	size_t line = pos + 1;
+	size_t colon = std::string::npos;
+	pos = line;
+	while (line < size) {
+		pos += ws_scan(base + pos, size - pos, separators);
+		if (pos < size && base[pos] == ':') {
+			if (colon == std::string::npos) {
+				colon = pos;
+			}
+			pos++;
+			continue;
+		}
+		size_t end = pos;
+		if (end > line && base[end - 1] == '\r') {
+			end--;
+		}
+		if (colon != std::string::npos && colon < end) {
+			record(base, base + line, base + colon, base + end);
+		}
+		line = pos + 1;
+		colon = std::string::npos;
+		pos = line;
+	}
+}
+
+/**
+ * @brief Tells if the header was present (even with an empty value).
+ */
+bool HttpHeaderIndex::has(t_header_id id) const {
+	return (id < HDR_COUNT && _fields[id].present);
+}
+
+/**
+ * @brief Tells if the header appeared more than once.
+ */
+bool HttpHeaderIndex::repeated(t_header_id id) const {
+	return (id < HDR_COUNT && _fields[id].repeated);
+}
+
+/**
+ * @brief First byte of the value, inside the indexed block. NULL if absent.
+ */
+const char* HttpHeaderIndex::data(t_header_id id) const {
+	if (!has(id)) {
+		return (NULL);
+	}
+	return (_block->data() + _fields[id].offset);
+}
+
+/**
+ * @brief Bytes of the value. 0 if absent.
+ */
+size_t HttpHeaderIndex::length(t_header_id id) const {
+	if (!has(id)) {
+		return (0);
+	}
+	return (_fields[id].length);
+}
+
+/**
+ * @brief Copy of the value, or an empty string if the header is absent.
+ */
+std::string HttpHeaderIndex::value(t_header_id id) const {
+	if (!has(id)) {
+		return ("");
+	}
+	return (_block->substr(_fields[id].offset, _fields[id].length));
+}
+
+/**
+ * @brief Compares the value, case-insensitively, with a lower case token.
+ *
+ * @param id Header to compare.
+ * @param expected Lower case token, e.g. `"keep-alive"`.
+ * @return `true` if the header is present and its whole value matches.
+ */
+bool HttpHeaderIndex::equals(t_header_id id, const char* expected) const {
+	size_t size = std::strlen(expected);
+	return (has(id) && _fields[id].length == size && same_name(data(id), expected, size));
+}
@@ -73,7 +73,8 @@ bool HttpMultipartHandler::handle_request() {
  * @details
  * - **Permission Check**: Ensures the current location has `WRITE` access.
  * - **Payload Validation**: Verifies request content length and type.
- * - **File Saving**: Iterates through `_multi_content` to save each file part.
+ * - **File Saving**: Moves each file part of `_multi_content` to one `IoSaveFiles` task,
+ *   offloaded; the response is sent by `resume`.
  */
 bool HttpMultipartHandler::handle_post() {
 	if (!HAS_POST(_location->loc_allowed_methods)) {
@@ -84,6 +85,7 @@ bool HttpMultipartHandler::handle_post() {
 	if (!validate_payload()) {
 		return (send_error_response());
 	}
+	IoSaveFiles* task = new IoSaveFiles();
 	std::string save_path;
 	for (size_t i = 0; i < _multi_content.size(); i++) {
 		if (_multi_content[i].data_type == CT_FILE) {
@@ -91,23 +93,44 @@ bool HttpMultipartHandler::handle_post() {
 			if (!_request.boundary.empty()) {
 				save_path = _request.normalized_path + _multi_content[i].filename;
 			}
-			if (!save_file(save_path, _multi_content[i].data)) {
-				if (i > 0) {
-					turn_off_sanity(HTTP_MULTI_STATUS,
-									"Error posting some resources.");
-					return (send_response("Partially Created.",
-										  _request.normalized_path));
-				} else {
-					return (send_error_response());
-				}
-			} else {
-				_request.status = HTTP_CREATED;
-				_log->log_debug( MP_NAME,
-				          "File Data Recieved and saved.");
-			}
+			task->add(save_path, _multi_content[i].data);
+		}
+	}
+	return (offload(task));
+}
+
+/**
+ * @brief Answers a multipart `POST` once its file parts were written.
+ *
+ * Parts are written in order, and writing stops at the first failure:
+ * - Every part written: `201 Created`.
+ * - Some parts written: `207 Multi-Status`, "Partially Created.".
+ * - None written: the error of the first part (`409` if it exists).
+ *
+ * @param task Completed task. Other kinds are answered by `WsResponseHandler::resume`.
+ * @return `true` if a response was queued without error.
+ */
+bool HttpMultipartHandler::resume(IoTask* task) {
+	if (task->kind != IO_SAVE_FILES) {
+		return (WsResponseHandler::resume(task));
+	}
+	IoSaveFiles& files = static_cast<IoSaveFiles&>(*task);
+	if (files.saved < files.paths.size()) {
+		save_failed(files.error);
+		if (files.saved == 0) {
+			return (send_error_response());
 		}
+		turn_off_sanity(HTTP_MULTI_STATUS,
+						"Error posting some resources.");
+		return (send_response("Partially Created.",
+							  _request.normalized_path));
+	}
+	if (!files.paths.empty()) {
+		_request.status = HTTP_CREATED;
+		_log->log_debug( MP_NAME,
+				  "File Data Recieved and saved.");
 	}
-	return(send_response("Created", _request.normalized_path));
+	return (send_response("Created", _request.normalized_path));
 }
 
 /**
@@ -34,11 +34,21 @@ HttpRangeHandler::HttpRangeHandler(const LocationConfig *location,
 								   int fd) :
 		WsResponseHandler(location, log,
 		                  client_data, request,
-		                  fd) {
+		                  fd),
+		_file(NULL) {
 	_log->log_debug( RRH_NAME,
 	          "Range Response Handler Init.");
 }
 
+/**
+ * @brief Destructor. Releases the open file; a queued range keeps its own reference.
+ */
+HttpRangeHandler::~HttpRangeHandler() {
+	if (_file) {
+		_file->release();
+	}
+}
+
 /**
  * @brief Processes the HTTP range request, allowing only GET requests.
  *
@@ -72,6 +82,10 @@ bool HttpRangeHandler::handle_request() {
  * This methods overloads handle_get just to be able to handle different HTTP status
  * depending of the range. HTTP PARTIAL CONTENT is important to render ranged contents.
  *
+ * The header is queued, then the range as a segment of the open file: the
+ * `OutputQueue` keeps the `OpenFile` alive and sends it with `sendfile`, so no
+ * byte of the range is copied to user space.
+ *
  * @return `true` if the request was processed as a GET range request; `false` otherwise.
  *
  * @note Full content will return 200 HTTP OK, Other ranges HTTP PARTIAL CONTENT.
@@ -85,9 +99,16 @@ bool HttpRangeHandler::handle_get() {
 	}
 	get_file_content(_request.normalized_path);
 	if (_response_data.status) {
+		size_t length = _response_data.end - _response_data.start + 1;
+		std::string mime_type = _response_data.mime.empty()
+			? get_mime_type(_request.normalized_path) : _response_data.mime;
+		_headers = header(_request.status, length, mime_type);
+		OutputQueue& output = _client_data->output();
+		output.enqueue_swap(_headers);
+		output.enqueue_shared_file(_file->fd, static_cast<off_t>(_response_data.start), length, _file);
 		_log->log_debug( RSP_NAME,
-						 "File content will be sent.");
-		return (send_response(_response_data.content, _request.normalized_path));
+						 "File range will be sent.");
+		return (true);
 	}
 	_log->log_debug( RSP_NAME,
 					 "Get will send a error due to content load fails.");
@@ -95,20 +116,21 @@ bool HttpRangeHandler::handle_get() {
 }
 
 /**
- * @brief Reads file content within the specified range, if valid, and stores it in `_response_data`.
+ * @brief Opens the file and validates the requested range against its size.
  *
- * This method retrieves file content based on a specified range, ensuring the range is valid and within
- * the file's size. If any error occurs (such as missing permissions, invalid range, or read failure),
- * it disables sanity and logs an appropriate error message.
+ * The file comes from the listener's `OpenFileCache`, so a known file costs no
+ * `open` nor `stat`, and its size is the one of the descriptor that will be
+ * sent. Nothing is read here: `handle_get` queues the range from the file.
+ * If any error occurs (missing permissions, invalid range), it disables sanity
+ * and logs an appropriate error message.
  *
  * @param path Reference to the file path as a string.
  *
  * @details
  * - Calls `validate_content_range` to check the validity of the specified content range.
- * - Reads the content within the specified range if it exists and assigns it to `_response_data.content`.
- * - Handles file access exceptions and I/O errors, logging any issues encountered during the process.
+ * - On success `_response_data.status` is `true`, and `_file` holds the open file.
  *
- * @note If the content range is invalid, `_response_data.status` is set to `false`, and no content is read.
+ * @note If the content range is invalid, `_response_data.status` is set to `false`.
  */
 void HttpRangeHandler::get_file_content(std::string& path) {
 	if (path.empty()) {
@@ -116,48 +138,21 @@ void HttpRangeHandler::get_file_content(std::string& path) {
 		                "Path is needed.");
 		return;
 	}
-	try {
-		std::string content;
-		parse_content_range();
-		_response_data.status = false;
-		std::ifstream file(path.c_str(), std::ios::binary);
-		if (!file) {
-			turn_off_sanity(HTTP_FORBIDDEN,
-							"Failed to open file " + path);
-			return;
-		}
-		file.seekg(0, std::ios::end);
-		std::streampos file_size = file.tellg();
-		_response_data.filesize = file_size;
-		file.seekg(0, std::ios::beg);
-
-		if (validate_content_range(file_size)) {
-			size_t content_length = _response_data.end - _response_data.start + 1;
-			content.resize(content_length, '\0');
-			file.seekg(_response_data.start);
-			file.read(&content[0], content_length);
-			if (!file) {
-				turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-				                "Error reading file: " + path);
-				file.close();
-				_response_data.status = false;
-				return ;
-			}
-			_response_data.status = true;
-			_request.status = HTTP_PARTIAL_CONTENT;
-		}
-
-		file.close();
-		_response_data.content = content;
-	} catch (const std::ios_base::failure& e) {
-		turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-						"I/O failure: " + std::string(e.what()));
-	} catch (const std::exception& e) {
-		turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-						"Unhandled Exception: " + std::string(e.what()));
+	parse_content_range();
+	_response_data.status = false;
+	_file = _client_data->get_server()->get_open_files().acquire(clean_path(path));
+	if (_file == NULL) {
+		turn_off_sanity(HTTP_FORBIDDEN,
+						"Failed to open file " + path);
+		return;
+	}
+	_response_data.filesize = _file->size;
+	if (validate_content_range(_file->size)) {
+		_response_data.status = true;
+		_request.status = HTTP_PARTIAL_CONTENT;
 	}
 	_log->log_debug( RRH_NAME,
-			  "File content read completed.");
+			  "File range ready to be sent.");
 }
 
 /**
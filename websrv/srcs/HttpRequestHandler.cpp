@@ -31,12 +31,17 @@
  */
 HttpRequestHandler::HttpRequestHandler(const Logger* log,
 									   ClientData* client_data):
+	_host_config(NULL),
 	_config(client_data->get_server()->get_config()),
 	_log(log),
 	_client_data(client_data),
-	_fd(_client_data->get_fd().fd),
+	_location(NULL),
+	_fd(_client_data->get_fd()),
+	_request(client_data->read_buffer()),
 	_request_data(client_data->client_request()),
-	_cache(&_config.request_cache){
+	_cache(&client_data->get_server()->get_request_cache()),
+	_missing(&client_data->get_server()->get_missing_cache()),
+	_watcher(client_data->get_server()->get_watcher()){
 
 	if (!log) {
 		throw Logger::NoLoggerPointer();
@@ -49,7 +54,6 @@ HttpRequestHandler::HttpRequestHandler(const Logger* log,
 	}
 	if (_request_data.host_config) {
 		_host_config = _request_data.host_config;
-		_cache = &_request_data.host_config->request_cache;
 	}
 	_max_request = _client_data->get_server()->get_config().client_max_body_size;
 }
@@ -72,30 +76,40 @@ HttpRequestHandler::~HttpRequestHandler() {
  * followed by handling the request if it is ready. The workflow is divided into distinct
  * validation steps, each responsible for a specific part of the HTTP request processing.
  *
+ * The request may arrive over several events. Each call reads what the socket has and
+ * advances `_request_data.read_phase` as far as the buffered bytes allow; if the request is
+ * still incomplete it returns, and the next readiness event resumes from the same phase.
+ *
  * @details
  * The method operates as follows:
- * 1. **Define Steps**:
- *    - An array of function pointers (`validate_step`) defines the steps for processing:
- *      - `read_request_header`: Reads the HTTP request header from the client.
+ * 1. **Receive**:
+ *    - `receive_available` moves every available byte to the client's read buffer, without waiting.
+ *    - Without `POLLIN` in the client state the socket is not read: the request is parsed from
+ *      the bytes already buffered (the next request of a pipeline).
+ *
+ * 2. **Header Phase** (`READ_HEADER`):
+ *    - `read_request_header`: Checks if the HTTP request header is complete.
+ *    - Once it is, the header steps run in sequence:
  *      - `parse_header`: Parses the header for key-value pairs.
  *      - `parse_method_and_path`: Extracts the HTTP method and requested path.
  *      - `parse_path_type`: Determines the type of resource (e.g., file, directory).
  *      - `load_header_data`: Loads additional header data needed for processing.
  *      - `load_host_config`: Maps the request to the correct host configuration.
  *      - `solver_resource`: Resolves the resource requested by the client.
- *      - `load_content`: Reads the content of the request, if any.
- *      - `validate_request`: Performs final validation of the request's integrity.
- *
- * 2. **Check Input State**:
- *    - If the request is not ready and the socket is readable (`POLLIN`), the validation process begins.
  *
- * 3. **Execute Validation Steps**:
- *    - Iterates through the validation steps sequentially:
- *      - Calls each step using a member function pointer.
- *      - Stops the process if the `sanity` flag indicates a validation failure.
+ * 3. **Body Phase** (`READ_BODY`):
+ *    - `load_content`: Takes the body from the buffer once it is complete.
  *
- * 4. **Mark Request as Ready**:
- *    - If all steps succeed, the request is marked as ready for further handling.
+ * 4. **Completion**:
+ *    - An incomplete request waits for the next event, unless the client closed its side.
+ *    - `validate_request`: Performs final validation of the request's integrity.
+ *    - `cache_route`: Stores the routing outcome of a valid GET or HEAD.
+ *    - The bytes after a failed request are only kept, as the next pipelined request,
+ *      when its end is known: `load_header_data` framed it (`load_body_framing`) and
+ *      it has no body. Otherwise the rest of the stream cannot be parsed: pending bytes
+ *      are dropped and the connection is closed after the error response, whatever the
+ *      `Connection` header of this or a previous request asked for.
+ *    - The request is marked as ready for further handling.
  *
  * 5. **Handle Ready Requests**:
  *    - If the request is ready and the socket is writable (`POLLOUT`), the request is processed.
@@ -104,27 +118,62 @@ HttpRequestHandler::~HttpRequestHandler() {
  *         such as malformed headers or resource resolution failures.
  */
 void HttpRequestHandler::request_workflow() {
-	validate_step steps[] = {&HttpRequestHandler::read_request_header,
-	                         &HttpRequestHandler::parse_header,
+	validate_step steps[] = {&HttpRequestHandler::parse_header,
 	                         &HttpRequestHandler::parse_method_and_path,
 	                         &HttpRequestHandler::parse_path_type,
 	                         &HttpRequestHandler::load_header_data,
 							 &HttpRequestHandler::load_host_config,
-							 &HttpRequestHandler::solver_resource,
-	                         &HttpRequestHandler::load_content,
-	                         &HttpRequestHandler::validate_request};
+							 &HttpRequestHandler::solver_resource};
 
-	if (!_request_data.request_ready && _client_data->get_state() & POLLIN) {
+	if (!_request_data.request_ready
+		&& (_client_data->get_state() & POLLIN || !_request.empty())) {
 		_log->log_debug( RH_NAME,
 		                 "Parse and Validation Request Process. Start");
-		size_t i = 0;
 		_client_data->chronos_reset();
-		while (i < (sizeof(steps) / sizeof(validate_step)))
-		{
-			(this->*steps[i])();
-			if (!_request_data.sanity)
-				break;
-			i++;
+		bool open = true;
+		if (_client_data->get_state() & POLLIN) {
+			open = receive_available();
+		}
+		if (!_client_data->is_alive()) {
+			_request_data.request_ready = true;
+			return ;
+		}
+		if (_request_data.read_phase == READ_HEADER) {
+			read_request_header();
+			size_t i = 0;
+			while (_request_data.read_phase == READ_BODY
+				   && i < (sizeof(steps) / sizeof(validate_step))) {
+				(this->*steps[i])();
+				if (!_request_data.sanity)
+					break;
+				i++;
+			}
+			if (!_request_data.sanity && _request_data.framed
+				&& !_request_data.chunks && _request_data.content_length == 0) {
+				_request_data.read_phase = READ_DONE;
+			}
+		}
+		if (_request_data.sanity && _request_data.read_phase == READ_BODY) {
+			load_content();
+		}
+		if (_request_data.sanity && _request_data.read_phase != READ_DONE) {
+			if (open) {
+				return ;
+			}
+			turn_off_sanity(HTTP_CLIENT_CLOSE_REQUEST,
+			                "Client Close Request");
+			_client_data->kill_client();
+		}
+		if (_request_data.sanity) {
+			validate_request();
+			cache_route();
+		}
+		if (!_request_data.sanity && _request_data.read_phase != READ_DONE) {
+			_request.clear();
+			_client_data->deactivate();
+		}
+		if (!open) {
+			_client_data->deactivate();
 		}
 		_request_data.request_ready = true;
 	}
@@ -134,91 +183,100 @@ void HttpRequestHandler::request_workflow() {
 }
 
 /**
- * @brief Reads the HTTP request header from the client socket.
+ * @brief Moves every byte available on the client socket to the read buffer.
  *
- * This method reads data from the client socket, accumulating it into
- * `_request` until the complete HTTP header is received. The header is considered
- * complete when the "\r\n\r\n" delimiter is detected.
+ * Reads until `recv()` reports that the socket is empty, which is also what an
+ * edge-triggered backend requires. It never waits: an empty socket ends the
+ * read, and the request is resumed on the next readiness event.
  *
- * Function Workflow:
- * 1. Attempt to read data from the socket using `recv()`.
- * 2. If data is read successfully, append it to the request buffer.
- * 3. Check if the headers are fully received by looking for the end sequence (`\r\n\r\n`).
- * 4. If `recv()` returns `-1`, retry reading up to a predefined maximum number of times.
- * 5. If the client closes the connection (`recv()` returns `0`) or an error occurs after maximum retries,
- * 	  mark the connection as inactive.
- * 6. If the request headers are successfully read, proceed to the next step in handling the request.
+ * A chunked body is decoded as it is read (`load_content_chunks`), so the buffer
+ * only holds the bytes not decoded yet, and the body limit applies to the decoded
+ * size, not to the encoding (small chunks, extensions).
  *
- * Upon successful completion, the client's `chronos_reset` is called to refresh
- * the timestamp, indicating the request's active state.
+ * Reading stops early once the buffer holds more than a header and a body can
+ * take, or once a chunked body fails. Bytes may be left in the socket then:
+ * `ClientData::read_pending` tells `ServerManager` to read them again if the
+ * request is not complete yet.
  *
- * @exception std::exception If an unexpected exception occurs during reading,
- * it logs the exception message and disables request sanity.
- *
- * @note This function sets the request's sanity to `false` if any issues are
- * encountered (e.g., timeout, client disconnection, header size too large).
- *
- * @see turn_off_sanity
- * @see ClientData::chronos_request
+ * @return `false` if the client closed its side of the connection or the socket
+ *         failed (the client is killed in that case), `true` otherwise.
  */
-void HttpRequestHandler::read_request_header() {
+bool HttpRequestHandler::receive_available() {
 	char buffer[BUFFER_REQUEST];
-	int read_byte;
+	size_t limit = MAX_HEADER + _max_request;
 
-	try {
-		_log->log_debug( RH_NAME,
-				  "Reading HTTP request");
-
-		int retry_count = 0;
-		while (true) {
-			read_byte = recv(_fd, buffer, sizeof(buffer), 0);
-			if (read_byte > 0) {
-				_request.append(buffer, read_byte);
-				if (_request.find("\r\n\r\n") != std::string::npos) {
+	_client_data->set_read_pending(false);
+	while (true) {
+		if (_request.size() > limit) {
+			_client_data->set_read_pending(true);
+			break;
+		}
+		ssize_t read_byte = recv(_fd, buffer, sizeof(buffer), 0);
+		if (read_byte > 0) {
+			_request.append(buffer, read_byte);
+			if (_request_data.chunks && _request_data.read_phase == READ_BODY) {
+				load_content_chunks();
+				if (!_request_data.sanity) {
 					break;
 				}
-				retry_count = 0;
-				if (!_client_data->chronos_request()) {
-					turn_off_sanity(HTTP_REQUEST_TIMEOUT,
-									"Request Timeout.");
-					return;
-				}
-			} else if (read_byte == 0) {
-				_client_data->kill_client();
-				turn_off_sanity(HTTP_CLIENT_CLOSE_REQUEST,
-								"Client Close Request");
-				_client_data->kill_client();
-				return;
-			} else {
-				retry_count++;
-				if (retry_count >= WS_MAX_RETRIES) {
-					turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-									"Max retries exceeded while reading from socket.");
-					return;
-				}
-				usleep(WS_RETRY_DELAY_MICROSECONDS);
-				continue;
 			}
+			continue;
 		}
+		if (read_byte == 0) {
+			_log->log_debug( RH_NAME,
+			                 "Client closed its side of the connection.");
+			return (false);
+		}
+		if (errno == EINTR) {
+			continue;
+		}
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			break;
+		}
+		turn_off_sanity(HTTP_CLIENT_CLOSE_REQUEST,
+		                "Error reading from socket.");
+		_client_data->kill_client();
+		return (false);
+	}
+	return (true);
+}
 
-		_client_data->chronos_reset();
+/**
+ * @brief Checks if the HTTP request header has been fully received.
+ *
+ * The header is considered complete when the "\r\n\r\n" delimiter is in the
+ * read buffer; its offset is kept in `header_end` and the request moves to
+ * `READ_BODY`. Otherwise it stays in `READ_HEADER`, waiting for more data.
+ * The scan (`ws_find_header_end`) resumes at `header_scanned`, so bytes
+ * already checked by a previous read are not scanned again.
+ *
+ * @note This function sets the request's sanity to `false` if the buffer grows
+ * beyond `MAX_HEADER` without a complete header.
+ *
+ * @see turn_off_sanity
+ */
+void HttpRequestHandler::read_request_header() {
+	size_t header_end = ws_find_header_end(_request.data(), _request.size(),
+	                                       _request_data.header_scanned);
+
+	if (header_end != std::string::npos) {
+		_request_data.header_end = header_end;
+		_request_data.read_phase = READ_BODY;
 		_log->log_debug( RH_NAME,
 				  "Request read.");
-
-	} catch (std::exception& e) {
-		std::ostringstream detail;
-		detail << "Error Getting Header Data Request: " << e.what();
-		turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-						detail.str());
-		_client_data->kill_client();
+		return ;
+	}
+	if (_request.size() > MAX_HEADER) {
+		turn_off_sanity(HTTP_REQUEST_HEADER_FIELDS_TOO_LARGE,
+						"Request Header too large.");
 	}
 }
 
 /**
  * @brief Parses the HTTP request header from the `_request` data.
  *
- * This method extracts the HTTP header section from `_request` by locating
- * the header-body delimiter ("\r\n\r\n"). If the delimiter is found,
+ * This method extracts the HTTP header section from `_request`, up to the
+ * header-body delimiter ("\r\n\r\n") found by `read_request_header`. If the delimiter is found,
  * the header data is stored in `_request_data.header` and the remaining
  * data is retained in `_request` as the body. If no delimiter is found,
  * the request is marked as having a bad request error.
@@ -237,7 +295,7 @@ void HttpRequestHandler::read_request_header() {
  * @see turn_off_sanity
  */
 void HttpRequestHandler::parse_header() {
-	size_t header_end = _request.find("\r\n\r\n");
+	size_t header_end = _request_data.header_end;
 
 	if (header_end != std::string::npos) {
 		_request_data.header = _request.substr(0, header_end);
@@ -249,10 +307,7 @@ void HttpRequestHandler::parse_header() {
 
 		_log->log_debug( RH_NAME,
 		          "Header successfully parsed.");
-		header_end += 4;
-		std::string tmp = _request.substr(header_end);
-		_request.clear();
-		_request = tmp;
+		_request.erase(0, header_end + 4);
 		if (_request_data.header.length() > MAX_HEADER) {
 			turn_off_sanity(HTTP_REQUEST_HEADER_FIELDS_TOO_LARGE,
 							"Request Header too large.");
@@ -296,8 +351,10 @@ void HttpRequestHandler::parse_method_and_path() {
 
 	_log->log_debug( RH_NAME,
 			  "Parsing Request to get path and method.");
-	size_t method_end = _request_data.header.find(' ');
-	if (method_end != std::string::npos) {
+	static const t_scan_set space = ws_scan_set(" ");
+	const std::string& header = _request_data.header;
+	size_t method_end = ws_scan(header.data(), header.size(), space);
+	if (method_end < header.size()) {
 		_request_data.method_str = _request_data.header.substr(0, method_end);
 		if (_request_data.method_str.empty()
 			|| (_request_data.method = parse_method(_request_data.method_str)) == 0 ) {
@@ -306,8 +363,9 @@ void HttpRequestHandler::parse_method_and_path() {
 			return ;
 		}
 
-		size_t path_end = _request_data.header.find(' ', method_end + 1);
-		if (path_end != std::string::npos) {
+		size_t path_end = method_end + 1
+			+ ws_scan(header.data() + method_end + 1, header.size() - method_end - 1, space);
+		if (path_end < header.size()) {
 			path = _request_data.header.substr(method_end + 1, path_end - method_end - 1);
 			if (path.size() > URI_MAX) {
 				turn_off_sanity(HTTP_URI_TOO_LONG,
@@ -367,8 +425,9 @@ void HttpRequestHandler::parse_method_and_path() {
 void HttpRequestHandler::parse_path_type() {
 	_log->log_debug( RH_NAME,
 			  "Parsing Path type.");
-	size_t pos = _request_data.path.find('?');
-	if (pos == std::string::npos) {
+	static const t_scan_set query = ws_scan_set("?");
+	size_t pos = ws_scan(_request_data.path.data(), _request_data.path.size(), query);
+	if (pos == _request_data.path.size()) {
 		_request_data.path_type = PATH_REGULAR;
 		_log->log_debug( RH_NAME,
 				  "Regular Path to normalize.");
@@ -390,11 +449,9 @@ void HttpRequestHandler::parse_path_type() {
  * @details
  * The method performs the following actions:
  *
- * 1. **Content-Length Header**:
- *    - Retrieves the `Content-Length` header value using `get_header_value()`.
- *    - If `Content-Length` is present and valid (`is_valid_size_t()` returns `true`), converts it to a `size_t` using `str_to_size_t()` and stores it in `_request_data.content_length`.
- *    - If the `Content-Length` is invalid, sets the request status to `HTTP_BAD_REQUEST`.
- *    - If the `Content-Length` header is not present, sets `_request_data.content_length` to `0`.
+ * 1. **Body Framing** (`Content-Length`, `Transfer-Encoding`):
+ *    - `load_body_framing` sets `_request_data.content_length` or `_request_data.chunks`,
+ *      and `_request_data.framed` once the end of the body is known.
  *
  * 2. **Content-Type Header**:
  *    - Retrieves the `Content-Type` header value.
@@ -402,47 +459,38 @@ void HttpRequestHandler::parse_path_type() {
  *    - If the `boundary` is not found or malformed, sets the request status to `HTTP_BAD_REQUEST`.
  *    - Updates `_request_data.content_type` to only include the primary MIME type, removing any additional parameters.
  *
- * 3. **Transfer-Encoding Header**:
- *    - Retrieves the `Transfer-Encoding` header value.
- *    - Checks if the encoding is `"chunked"` and sets `_request_data.chunks` to `true` if it is.
- *
- * 4. **Range Header**:
+ * 3. **Range Header**:
  *    - Retrieves the `Range` header value.
  *    - If the `Range` header is present, increments `_request_data.factory` to indicate that this data will be used later.
  *
- * 5. **Connection Header**:
+ * 4. **Connection Header**:
  *    - Retrieves the `Connection` header value.
  *    - If the value is `"keep-alive"`, calls `_client_data->keep_active()` to maintain the connection.
  *    - Otherwise, calls `_client_data->deactivate()` to close the connection after handling the request.
  *
- * 6. **Cookie Header**:
+ * 5. **Cookie Header**:
  *    - Retrieves the `Cookie` header value and stores it in `_request_data.cookie`.
  *
- * 7. **Referer Header**:
+ * 6. **Referer Header**:
  *    - Retrieves the `Referer` header value and stores it in `_request_data.referer`.
  *
- * 8. **Host**:
+ * 7. **Host**:
  * 	  - Retrieves `Host` header value, and stores it in `_request_data.host` to be parsed.
  *
+ * 8. **Conditional Headers**:
+ *    - Retrieves `If-None-Match` and `If-Modified-Since`, evaluated by the response handler.
+ *
  * @note
- * - The method uses `get_header_value()` to extract specific header values from `_request_data.header`.
+ * - `_request_data.header` is indexed once by `HttpHeaderIndex`; every header above is then an
+ *   O(1) lookup, and `Transfer-Encoding`/`Connection` are compared in place, case-insensitively.
  * - The `_request_data.factory` variable is incremented whenever additional processing for multipart content or range is required.
  * - The method ensures that malformed headers, such as an invalid `Content-Length` or missing `boundary`, are caught and the request is marked as invalid.
  */
 void HttpRequestHandler::load_header_data() {
-	std::string content_length = get_header_value(_request_data.header, "content-length:");
-	_request_data.content_type = get_header_value(_request_data.header, "content-type:");
+	_header_index.index(_request_data.header);
+	_request_data.content_type = _header_index.value(HDR_CONTENT_TYPE);
 
-	if (!content_length.empty()){
-		if (is_valid_size_t(content_length)) {
-			_request_data.content_length = str_to_size_t(content_length);
-		} else {
-			turn_off_sanity(HTTP_BAD_REQUEST,
-			                "Content-Length malformed.");
-		}
-	} else {
-		_request_data.content_length = 0;
-	}
+	load_body_framing();
 	if (!_request_data.content_type.empty()) {
 		if (starts_with(_request_data.content_type, "multipart")) {
 			_request_data.boundary = get_header_value(_request_data.content_type, "boundary");
@@ -457,33 +505,91 @@ void HttpRequestHandler::load_header_data() {
 			}
 		}
 	}
-	_request_data.host = get_header_value(_request_data.header, "host:");
-	std::string chunks = get_header_value(_request_data.header, "transfer-encoding:");
-	if (!chunks.empty()) {
-		chunks = trim(chunks, " ");
-		if (chunks == "chunked") {
-			_request_data.chunks = true;
-		}
-	}
-	_request_data.range = get_header_value(_request_data.header, "range:");
+	_request_data.host = _header_index.value(HDR_HOST);
+	_request_data.range = _header_index.value(HDR_RANGE);
 	if (!_request_data.range.empty()) {
 		_request_data.factory++;
 	}
-	std::string keep = get_header_value(_request_data.header, "connection:");
-	if (keep == "keep-alive") {
+	if (_header_index.equals(HDR_CONNECTION, "keep-alive")) {
 		_client_data->keep_active();
 	} else {
 		_client_data->deactivate();
 	}
-	_request_data.cookie = get_header_value(_request_data.header, "cookie");
-	_request_data.referer = get_header_value(_request_data.header, "referer:");
+	_request_data.cookie = _header_index.value(HDR_COOKIE);
+	_request_data.referer = _header_index.value(HDR_REFERER);
+	_request_data.if_none_match = _header_index.value(HDR_IF_NONE_MATCH);
+	_request_data.if_modified_since = _header_index.value(HDR_IF_MODIFIED_SINCE);
+}
+
+/**
+ * @brief Finds where the body of the request ends.
+ *
+ * The body is either chunked (`Transfer-Encoding: chunked`) or `Content-Length`
+ * bytes long; without either header it is empty. Anything else leaves the end of
+ * the request unknown, and the bytes after the header could be taken as another
+ * request (request smuggling), so it fails and `_request_data.framed` stays `false`:
+ * - A repeated `Content-Length` or `Transfer-Encoding`, or both headers: 400.
+ * - A `Content-Length` that is not a plain decimal number fitting a `size_t`: 400.
+ * - A `Transfer-Encoding` other than `chunked`: 501.
+ *
+ * `request_workflow` only keeps the bytes after a failed request when it is framed.
+ */
+void HttpRequestHandler::load_body_framing() {
+	bool has_length = _header_index.has(HDR_CONTENT_LENGTH);
+	bool has_encoding = _header_index.has(HDR_TRANSFER_ENCODING);
+
+	_request_data.content_length = 0;
+	if (_header_index.repeated(HDR_CONTENT_LENGTH)
+		|| _header_index.repeated(HDR_TRANSFER_ENCODING)) {
+		turn_off_sanity(HTTP_BAD_REQUEST,
+		                "Content-Length or Transfer-Encoding repeated.");
+		return ;
+	}
+	if (has_length && has_encoding) {
+		turn_off_sanity(HTTP_BAD_REQUEST,
+		                "Content-Length sent with Transfer-Encoding.");
+		return ;
+	}
+	if (has_encoding) {
+		if (!_header_index.equals(HDR_TRANSFER_ENCODING, "chunked")) {
+			turn_off_sanity(HTTP_NOT_IMPLEMENTED,
+			                "Transfer-Encoding not supported.");
+			return ;
+		}
+		_request_data.chunks = true;
+		_client_data->chunk_decoder().reset(_max_request);
+	} else if (has_length) {
+		const char* digits = _header_index.data(HDR_CONTENT_LENGTH);
+		size_t length = _header_index.length(HDR_CONTENT_LENGTH);
+		size_t value = 0;
+		bool valid = (length > 0);
+		for (size_t i = 0; valid && i < length; i++) {
+			size_t digit = static_cast<size_t>(digits[i] - '0');
+			valid = (digits[i] >= '0' && digits[i] <= '9'
+			         && value <= (static_cast<size_t>(-1) - digit) / 10);
+			value = value * 10 + digit;
+		}
+		if (!valid) {
+			turn_off_sanity(HTTP_BAD_REQUEST,
+			                "Content-Length malformed.");
+			return ;
+		}
+		_request_data.content_length = value;
+	}
+	_request_data.framed = true;
 }
 
+/**
+ * @brief Selects the server block serving the request `Host`.
+ *
+ * The host is normalized once (lowercase, no port, no trailing dot) and looked
+ * up in the virtual host table of the listening socket. Hosts no server block
+ * names get the socket's default configuration.
+ */
 void HttpRequestHandler::load_host_config() {
-	std::string host = to_lowercase(_request_data.host);
+	std::string host = VirtualHostTable::normalize(_request_data.host);
 	_host_config = _client_data->get_server()->get_config(host);
 	_request_data.host_config = _host_config;
-	_cache = &_request_data.host_config->request_cache;
 	if (_host_config == NULL) {
 		turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
 						"Host Config Pointer NULL.");
@@ -500,6 +606,11 @@ void HttpRequestHandler::load_host_config() {
  *
  * @details
  * The method performs the following steps:
+ * 0. **Route Cache**:
+ *    - A GET or HEAD whose route is cached (`load_cached_route`) skips every step below.
+ *    - A GET or HEAD whose path is known to be missing (`load_missing_route`) fails with
+ *      a 404 without running the steps. A new 404 is cached by `cache_missing_route`.
+ *
  * 1. **Initialize Validation Steps**:
  *    - Defines an array of function pointers (`steps`) representing the validation steps to be executed in sequence:
  *      - `get_location_config()`: Retrieves the configuration for the requested location.
@@ -519,6 +630,7 @@ void HttpRequestHandler::load_host_config() {
  *      - `_request_data.sanity` is set to `true`.
  *      - `_request_data.status` is reset to `HTTP_MAX_STATUS`.
  *      - `_request_data.path` is reset to the original request path (`_request_data.path_request`).
+ *    - A route resolved through the `Referer` depends on that header, so it is not cached.
  *    - Calls `resolve_relative_path()` to resolve any relative paths in the request.
  *
  * 5. **Execute Validation Steps Again**:
@@ -534,17 +646,24 @@ void HttpRequestHandler::solver_resource() {
 	validate_step steps[] = {&HttpRequestHandler::get_location_config,
 	                         &HttpRequestHandler::cgi_normalize_path,
 	                         &HttpRequestHandler::normalize_request_path};
+	if (load_cached_route()) {
+		return ;
+	}
 	size_t i = 0;
-	while (i < (sizeof(steps) / sizeof(validate_step)))
-	{
-		(this->*steps[i])();
-		if (!_request_data.sanity)
-			break;
-		i++;
+	if (!load_missing_route()) {
+		while (i < (sizeof(steps) / sizeof(validate_step)))
+		{
+			(this->*steps[i])();
+			if (!_request_data.sanity)
+				break;
+			i++;
+		}
+		cache_missing_route();
 	}
 	if (i == 3 || _request_data.referer.empty()) {
 		return ;
 	}
+	_request_data.route_key.clear();
 	_location = NULL;
 	_request_data.location = NULL;
 	_request_data.sanity = true;
@@ -561,6 +680,229 @@ void HttpRequestHandler::solver_resource() {
 	}
 }
 
+
+/**
+ * @brief Key of the route cache: method, server block and path, query excluded.
+ *
+ * The server block is identified by its address, so every name of a virtual
+ * host shares its routes. The query does not take part in routing, CGI scripts
+ * get it from the request.
+ */
+std::string HttpRequestHandler::route_key() const {
+	std::string key(_request_data.method_str);
+	key += ' ';
+	key.append(reinterpret_cast<const char*>(&_host_config), sizeof(_host_config));
+	key += ' ';
+	key += _request_data.path;
+	return (key);
+}
+
+/**
+ * @brief Restores the routing outcome of a GET or HEAD from the route cache.
+ *
+ * On a hit, the location, the rewritten path, the resolved file, the CGI
+ * script and path info, the MIME type and the handler kind are copied to
+ * `_request_data`, as the resolution steps would have set them, without any
+ * location lookup or `stat()`. A route whose directory is watched stays valid
+ * until the watcher reports a change of its entries. Other routes are resolved
+ * again after `file_cache_valid` milliseconds, so a new index file or script
+ * is picked up.
+ *
+ * @return `true` on a hit, `false` if the route has to be resolved. In both
+ *         cases `_request_data.route_key` is set for a GET or HEAD.
+ */
+bool HttpRequestHandler::load_cached_route() {
+	if (!HAS_PERMISSION(_request_data.method, MASK_METHOD_GET | MASK_METHOD_HEAD)) {
+		return (false);
+	}
+	_request_data.route_key = route_key();
+	if (!_cache->get(_request_data.route_key, _cache_data)) {
+		return (false);
+	}
+	bool valid = (_watcher && _cache_data->watch.wd >= 0)
+				 ? _watcher->current(_cache_data->watch)
+				 : TimerWheel::now_msec() - _cache_data->resolved < _config.ws_file_cache_valid;
+	if (!valid || !HAS_PERMISSION(_cache_data->allowed, _request_data.method)) {
+		_cache->remove(_request_data.route_key);
+		return (false);
+	}
+	_location = _cache_data->location;
+	_request_data.location = _cache_data->location;
+	_request_data.path = _cache_data->path;
+	_request_data.normalized_path = _cache_data->normalized_path;
+	_request_data.script = _cache_data->script;
+	_request_data.path_info = _cache_data->path_info;
+	_request_data.mime = _cache_data->mime;
+	switch (_cache_data->kind) {
+		case ROUTE_AUTOINDEX:
+			_request_data.autoindex = true;
+			_request_data.factory++;
+			break;
+		case ROUTE_CGI:
+			_request_data.cgi = true;
+			_request_data.factory++;
+			break;
+		case ROUTE_REDIRECT:
+			_request_data.is_redir = true;
+			_request_data.factory++;
+			break;
+		default:
+			break;
+	}
+	_request_data.is_cached = true;
+	_log->log_debug( RH_NAME,
+			  "Route found in cache.");
+	return (true);
+}
+
+/**
+ * @brief Stores the routing outcome of a valid GET or HEAD in the route cache.
+ *
+ * Only routes resolved from the request path alone are stored: `route_key` is
+ * cleared when the `Referer` was needed. A static file route also keeps the
+ * file's MIME type. When files are watched, the route keeps the stamp of the
+ * directory it was resolved from: the listed directory for an autoindex, the
+ * directory of the file or script otherwise.
+ */
+void HttpRequestHandler::cache_route() {
+	if (!_request_data.sanity || _request_data.is_cached || _request_data.route_key.empty()) {
+		return ;
+	}
+	t_route_kind kind = ROUTE_STATIC;
+	if (_request_data.is_redir) {
+		kind = ROUTE_REDIRECT;
+	} else if (_request_data.autoindex) {
+		kind = ROUTE_AUTOINDEX;
+	} else if (_request_data.cgi) {
+		kind = ROUTE_CGI;
+	} else {
+		_request_data.mime = get_mime_type(_request_data.normalized_path);
+	}
+	CacheRequest route(_request_data.route_key, _request_data, kind,
+					   _request_data.mime, TimerWheel::now_msec());
+	if (_watcher && kind != ROUTE_REDIRECT) {
+		std::string dir = clean_path(_request_data.normalized_path);
+		if (kind != ROUTE_AUTOINDEX) {
+			size_t slash = dir.find_last_of('/');
+			dir.erase(slash == 0 ? 1 : slash);
+		}
+		route.watch = _watcher->stamp(dir);
+	}
+	_cache->put(_request_data.route_key, route);
+}
+
+/**
+ * @brief Answers a GET or HEAD whose path is known to be missing, from the negative cache.
+ *
+ * A hit fails the request with a 404 in the location the miss was found in,
+ * as `normalize_request_path` would, without any `stat()`. A miss whose
+ * directory is watched stays valid until the watcher reports a change of its
+ * entries. Other misses older than `negative_cache_valid` milliseconds are
+ * resolved again and, with `negative_cache_check_dir` on, the deepest existing
+ * directory of the path is checked too, and a change (a file created or removed
+ * below it) ends the entry.
+ *
+ * @return `true` on a hit, `false` if the path has to be resolved.
+ */
+bool HttpRequestHandler::load_missing_route() {
+	if (_config.ws_negative_cache_valid == 0 || _request_data.route_key.empty()) {
+		return (false);
+	}
+	if (!_missing->get(_request_data.route_key, _miss_data)) {
+		return (false);
+	}
+	bool valid;
+	if (_watcher && _miss_data->watch.wd >= 0) {
+		valid = _watcher->current(_miss_data->watch);
+	} else {
+		valid = TimerWheel::now_msec() - _miss_data->resolved < _config.ws_negative_cache_valid;
+		if (valid && !_miss_data->dir.empty()) {
+			struct stat dir_stat;
+			valid = stat(_miss_data->dir.c_str(), &dir_stat) == 0
+					&& FileStamp(dir_stat) == _miss_data->dir_stamp;
+		}
+	}
+	if (!valid) {
+		_missing->remove(_request_data.route_key);
+		return (false);
+	}
+	_location = _miss_data->location;
+	_request_data.location = _miss_data->location;
+	turn_off_sanity(HTTP_NOT_FOUND,
+					"Requested path not found (negative cache) " + _request_data.path);
+	return (true);
+}
+
+/**
+ * @brief Caches the path of a GET or HEAD that resolution found missing.
+ *
+ * Only 404s found within a location are cached, and only from the first
+ * resolution pass: it depends on the path alone, not on the `Referer`. The
+ * deepest existing directory of the path is kept for the directory check,
+ * and its stamp when files are watched.
+ */
+void HttpRequestHandler::cache_missing_route() {
+	if (_config.ws_negative_cache_valid == 0 || _request_data.route_key.empty()
+		|| _request_data.sanity || _request_data.status != HTTP_NOT_FOUND || _location == NULL) {
+		return ;
+	}
+	std::string dir;
+	FileStamp stamp;
+	if ((_config.ws_negative_cache_check_dir || _watcher) && !missing_dir(dir, stamp)) {
+		return ;
+	}
+	CacheMiss miss(_request_data.route_key, _location, "", FileStamp(),
+				   TimerWheel::now_msec());
+	if (_watcher) {
+		miss.watch = _watcher->stamp(dir);
+	}
+	if (_config.ws_negative_cache_check_dir) {
+		miss.dir = dir;
+		miss.dir_stamp = stamp;
+	}
+	_missing->put(_request_data.route_key, miss);
+}
+
+/**
+ * @brief Finds the deepest directory of the resolved path that exists.
+ *
+ * Walks the path up, from the resolved path itself, until an existing
+ * directory is found. A file created below the missing path
+ * changes that directory, or one of the directories on the way down to it.
+ *
+ * @param dir Output. The directory found.
+ * @param stamp Output. Its version.
+ * @return `false` if no directory of the path exists.
+ */
+bool HttpRequestHandler::missing_dir(std::string& dir, FileStamp& stamp) const {
+	dir = _host_config->server_root + _request_data.path;
+	while (dir.size() > 1 && dir[dir.size() - 1] == '/') {
+		dir.erase(dir.size() - 1);
+	}
+	struct stat dir_stat;
+	while (!dir.empty()) {
+		if (stat(dir.c_str(), &dir_stat) == 0 && S_ISDIR(dir_stat.st_mode)) {
+			stamp = FileStamp(dir_stat);
+			return (true);
+		}
+		size_t slash = dir.find_last_of('/');
+		if (slash == std::string::npos || dir.size() == 1) {
+			break ;
+		}
+		dir.erase(slash == 0 ? 1 : slash);
+	}
+	return (false);
+}
+
+/**
+ * @brief Drops a cached route whose response failed, so the next request resolves it again.
+ */
+void HttpRequestHandler::forget_failed_route() {
+	if (_request_data.is_cached && !_request_data.sanity) {
+		_cache->remove(_request_data.route_key);
+	}
+}
+
 /**
  * @brief Resolves the relative path of the requested resource based on the `Referer` header.
  *
@@ -633,15 +975,13 @@ void HttpRequestHandler::resolve_relative_path() {
  * matching key is selected, allowing for precise path matching.
  *
  * Detailed Workflow:
- * - Iterates through `_host_config->locations` to find entries whose paths match the beginning of
- *   `_request_data.path`.
- * - The longest matching key is selected, ensuring the most specific location configuration
- *   is applied.
+ * - Walks `_host_config->location_router`, the radix trie compiled from `_host_config->locations`
+ *   when the host was added, along `_request_data.path`. The longest location key the path starts
+ *   with is selected, ensuring the most specific location configuration is applied, in
+ *   O(path length) whatever the number of locations.
  * - If a match is found, `_location` is set to the corresponding `LocationConfig` pointer.
  * - If no match is found, the method sets `sanity` to false with an HTTP 400 (Bad Request)
  *   status, as the requested path does not correspond to any configured location.
- * @note: This method will use cached data if the method is GET and its content is available.
- * 		  cached avoid extra interactions over locations.
  *
  * Error Handling:
  * - If no matching location is found, `turn_off_sanity` is invoked with `HTTP_BAD_REQUEST`
@@ -650,30 +990,14 @@ void HttpRequestHandler::resolve_relative_path() {
  * @see turn_off_sanity
  */
 void HttpRequestHandler::get_location_config() {
-	std::string saved_key;
-	const LocationConfig* result = NULL;
+	size_t key_length = 0;
 
 	_log->log_debug( RH_NAME,
 			  "Searching related location.");
 
-	_request_data.is_cached = _cache->get(_request_data.path, _cache_data);
-	if (_request_data.is_cached && HAS_GET(_request_data.method)) {
-		_location = _cache_data.location;
-		_request_data.location = _cache_data.location;
-		_request_data.normalized_path = _cache_data.normalized_path;
-		return ;
-	}
-	for (std::map<std::string, LocationConfig>::const_iterator it = _host_config->locations.begin();
-	     it != _host_config->locations.end(); ++it) {
-		const std::string& key = it->first;
-		if (starts_with(_request_data.path, key)) {
-			if (key.length() > saved_key.length()) {
-				result = &it->second;
-				saved_key = key;
-			}
-		}
-	}
+	const LocationConfig* result = _host_config->location_router.match(_request_data.path, key_length);
 	if (result) {
+		std::string saved_key = _request_data.path.substr(0, key_length);
 		_log->log_debug( RH_NAME,
 				  "Location Found: " + saved_key);
 		_location = result;
@@ -711,7 +1035,7 @@ void HttpRequestHandler::get_location_config() {
  *   - Sets `_request_data.normalized_path` to the directory containing the CGI file.
  *   - Marks `_request_data.cgi` as `true` and increments `_request_data.factory`.
  * - If no direct CGI file is found, checks if the path matches any mapped CGI locations in `_location->cgi_locations`:
- *   - Iterates over `cgi_locations` to find the longest matching prefix.
+ *   - Finds the longest matching prefix with the location's `cgi_router`, compiled from `cgi_locations`.
  *   - If a match is found, sets `_request_data.normalized_path`, `_request_data.script`, and `_request_data.path_info`.
  *   - Marks `_request_data.cgi` as `true` and increments `_request_data.factory`.
  *
@@ -722,7 +1046,7 @@ void HttpRequestHandler::get_location_config() {
  * @see is_file, is_dir, starts_with, _request_data
  */
 void HttpRequestHandler::cgi_normalize_path() {
-	if (!_location->cgi_file || _request_data.is_cached) {
+	if (!_location->cgi_file) {
 		_log->log_debug( RH_NAME,
 		          "No CGI locations at server config.");
 		return ;
@@ -745,27 +1069,17 @@ void HttpRequestHandler::cgi_normalize_path() {
 		return ;
 	}
 
-	std::string saved_key;
-	const t_cgi* cgi_data = NULL;
+	size_t key_length = 0;
 
 	_log->log_debug( RH_NAME,
 	          "Request will be testing against mapped CGI scripts.");
-	for (std::map<std::string, t_cgi>::const_iterator it = _location->cgi_locations.begin();
-	     it != _location->cgi_locations.end(); it++) {
-		const std::string& key = it->first;
-		if (starts_with(_request_data.path, key)) {
-			if (key.length() > saved_key.length()) {
-				cgi_data = &it->second;
-				saved_key = key;
-			}
-		}
-	}
+	const t_cgi* cgi_data = _location->cgi_router.match(_request_data.path, key_length);
 	if (cgi_data) {
 		_log->log_debug( RH_NAME,
-		          "CGI - Location Found: " + saved_key);
+		          "CGI - Location Found: " + _request_data.path.substr(0, key_length));
 		_request_data.normalized_path = _host_config->server_root + cgi_data->cgi_path;
 		_request_data.script = cgi_data->script;
-		_request_data.path_info = _request_data.path.substr(saved_key.length());
+		_request_data.path_info = _request_data.path.substr(key_length);
 		_request_data.cgi = true;
 		_request_data.factory++;
 	}
@@ -806,7 +1120,7 @@ void HttpRequestHandler::normalize_request_path() {
 		          "CGI context. path has been normalized");
 		return ;
 	}
-	if (_request_data.is_cached || _request_data.is_redir) {
+	if (_request_data.is_redir) {
 		return;
 	}
 	std::string eval_path = _host_config->server_root + _request_data.path;
@@ -895,256 +1209,78 @@ void HttpRequestHandler::load_content() {
 }
 
 /**
- * @brief Handles the reading and processing of HTTP chunked content from a client connection.
+ * @brief Decodes the chunked body bytes available in the read buffer.
  *
- * This method reads HTTP chunked transfer-encoded content from a client socket. It processes
- * the content incrementally, detects the end of the chunked body (`\r\n0\r\n\r\n`), and ensures
- * that the received content adheres to the constraints of the HTTP protocol, such as request
- * size limits and timeout conditions.
+ * The client's `ChunkedDecoder` keeps its position in the chunked stream
+ * between readiness events: the bytes received are decoded straight into
+ * `_request_data.body` and dropped from the buffer, so each byte is handled
+ * once whatever the number of reads. Once the last chunk and the trailers
+ * are decoded, the request moves to `READ_DONE`; bytes after them stay in the
+ * buffer.
  *
- * The method uses retry mechanisms and handles exceptional conditions, including client-initiated
- * disconnections, excessive retries, and content exceeding predefined limits. It ultimately parses
- * the chunked data and stores the reconstructed content in the internal request body storage.
+ * Sanity Control:
+ * - **Malformed Encoding**: Calls `turn_off_sanity` with `HTTP_BAD_REQUEST`.
+ * - **Excessive Content**: Calls `turn_off_sanity` with `HTTP_CONTENT_TOO_LARGE` as
+ *   soon as a chunk size takes the body over `_max_request`, before its payload arrives.
  *
- * @see parse_chunks()
- * @throws std::exception If an error occurs during the socket communication or chunk parsing.
+ * @see ChunkedDecoder
  */
 void HttpRequestHandler::load_content_chunks() {
-	char buffer[BUFFER_REQUEST];
-	int read_byte;
-	size_t size = 0;
-	int retry_count = 0;
-
-	try {
-		while (true) {
-			if (!_client_data->chronos_request()) {
-				turn_off_sanity(HTTP_REQUEST_TIMEOUT,
-								"Request Timeout.");
-				return;
-			}
-			read_byte = recv(_fd, buffer, sizeof(buffer), 0);
-
-			if (read_byte > 0) {
-				size += read_byte;
-				if (size > _max_request) {
-					turn_off_sanity(HTTP_CONTENT_TOO_LARGE,
-									"Body Content too Large.");
-					return;
-				}
-				_request.append(buffer, read_byte);
-				if (_request.find("\r\n0\r\n\r\n")) {
-					break;
-				}
-				retry_count = 0;
-
-			} else if (read_byte == 0) {
-				_client_data->kill_client();
-				turn_off_sanity(HTTP_CLIENT_CLOSE_REQUEST,
-								"Client Close Request");
-				_client_data->kill_client();
-				return;
-
-			} else {
-				retry_count++;
-				if (retry_count >= WS_MAX_RETRIES) {
-					if (_request.find("\r\n0\r\n\r\n")) {
-						break;
-					}
-					turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-									"Max retries exceeded while reading from socket.");
-					return;
-				}
-				usleep(WS_RETRY_DELAY_MICROSECONDS);
-				continue;
-			}
-		}
-
-		if (size == 0) {
-			_client_data->kill_client();
-			turn_off_sanity(HTTP_CLIENT_CLOSE_REQUEST,
-							"Client Close Request");
-			_client_data->kill_client();
-			return;
-		}
-		parse_chunks();
-		_request_data.body = _request;
-		_request_data.content_length = _request_data.body.length();
-		_log->log_debug( RH_NAME,
-				  "Chunked Request read.");
-
-	} catch (std::exception& e) {
-		std::ostringstream detail;
-		detail << "Error getting chunk data: " << e.what();
-		turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-						detail.str());
-		_client_data->kill_client();
+	size_t consumed = 0;
+	t_chunk_status status = _client_data->chunk_decoder().feed(_request.data(), _request.size(),
+	                                                           consumed, _request_data.body);
+	_request.erase(0, consumed);
+	if (status == CHUNK_BAD) {
+		turn_off_sanity(HTTP_BAD_REQUEST,
+						"Invalid chunked body.");
+		return ;
 	}
-}
-
-/**
- * @brief Parses the chunked data according to HTTP/1.1 chunked transfer encoding.
- *
- * This function reads the chunk size and content in the chunked transfer-encoded data,
- * handling each chunk iteratively. It appends valid chunks to `_request` and checks
- * for valid boundaries and chunk sizes.
- *
- * Workflow:
- * - **Chunk Size Extraction**: Reads the chunk size (in hexadecimal) from `chunk_data`.
- * - **Size Validation**: Checks that the chunk size is valid and within specified limits.
- * - **Content Appending**: Appends chunk content to `_request` if within the max size.
- * - **Chunk End Check**: Verifies chunk termination using `\r\n` characters.
- *
- * Sanity Control:
- * - **Invalid Chunk Size**: Calls `turn_off_sanity` with `HTTP_BAD_REQUEST` if the chunk size
- *   format is invalid.
- * - **Excessive Content**: Calls `turn_off_sanity` with `HTTP_CONTENT_TOO_LARGE` if the
- *   cumulative content size exceeds `_max_request`.
- * - **Invalid End of Chunk**: Calls `turn_off_sanity` if the chunk ending is malformed.
- *
- * @return `true` if parsing completes successfully, `false` otherwise.
- */
-bool HttpRequestHandler::parse_chunks() {
-	size_t pos = 0;
-	std::string chunk_data = _request;
-	_request.clear();
-	long chunk_size = 0;
-
-	while (true) {
-		size_t chunk_size_end = chunk_data.find("\r\n", pos);
-		if (chunk_size_end == std::string::npos) {
-			break;
-		}
-		std::string chunk_size_str = chunk_data.substr(pos, chunk_size_end - pos);
-		char* endptr;
-		errno = 0;
-		chunk_size = strtol(chunk_size_str.c_str(), &endptr, 16);
-
-		if (errno == ERANGE || chunk_size < 0 || *endptr != '\0') {
-			turn_off_sanity(HTTP_BAD_REQUEST,
-							"Invalid chunk size format.");
-			return false;
-		}
-
-		pos = chunk_size_end + 2;
-		if (chunk_size == 0) {
-			if (chunk_data.size() < pos + 2) {
-				break;
-			}
-			if (chunk_data.compare(pos, 2, "\r\n") == 0) {
-				chunk_data.erase(0, pos + 2);
-				break;
-			} else {
-				turn_off_sanity(HTTP_BAD_REQUEST,
-								"Invalid chunk ending.");
-				return (false);
-			}
-		}
-
-		_request.append(chunk_data, pos, chunk_size);
-		pos += chunk_size + 2;
-
-		if (_request.size() > _max_request) {
-			turn_off_sanity(HTTP_CONTENT_TOO_LARGE,
-							"Body Content too Large.");
-			return (false);
-		}
-
-		chunk_data.erase(0, pos);
-		pos = 0;
+	if (status == CHUNK_TOO_LARGE) {
+		turn_off_sanity(HTTP_CONTENT_TOO_LARGE,
+						"Body Content too Large.");
+		return ;
 	}
-	return (true);
+	if (status == CHUNK_MORE) {
+		return ;
+	}
+	_request_data.content_length = _request_data.body.length();
+	_request_data.read_phase = READ_DONE;
+	_log->log_debug( RH_NAME,
+			  "Chunked Request read.");
 }
 
 /**
- * @brief Reads the HTTP request body based on the `Content-Length` specified.
- *
- * This function reads the request body from the file descriptor `_fd` until the total
- * number of bytes read matches the `Content-Length`. It updates the `_request` string
- * with the body content and checks for size limits and timeouts.
+ * @brief Takes the HTTP request body from the read buffer, based on the `Content-Length` specified.
  *
- * The flow of the function is as follows:
- * 1. Verify that `Content-Length` is greater than `0`. If not, log the information and return.
- * 2. Read data from the socket using `recv()` until the entire content is received.
- * 3. If `recv()` returns `-1`, retry reading up to a predefined maximum number of times.
- * 4. If `recv()` returns `0`, it means the client closed the connection, and the connection is marked inactive.
- * 5. Accumulate the read data in the request buffer and ensure it does not exceed the allowed maximum size.
- * 6. If the body is successfully read, reset the request timeout and proceed with processing the request.
+ * The body is complete when the buffer holds `Content-Length` bytes. Until then the
+ * request stays in `READ_BODY` and the next readiness event appends more data. Once
+ * complete, exactly `Content-Length` bytes are moved to `_request_data.body` and the
+ * request moves to `READ_DONE`; bytes past the body stay in the buffer.
  *
  * Sanity Control:
- * - **Content-Length Exceeded**: Calls `turn_off_sanity` with `HTTP_CONTENT_TOO_LARGE`.
- * - **Timeout Error**: Calls `turn_off_sanity` with `HTTP_REQUEST_TIMEOUT` if reading
- *   times out.
- * - **Socket Closure/Read Error**: Calls `turn_off_sanity` if there is an error reading
- *   from the socket or if the client closes the connection.
- *
- * @exception std::exception Catches general exceptions during the reading process
- * and deactivates sanity if an exception is encountered.
+ * - **Content-Length Exceeded**: Calls `turn_off_sanity` with `HTTP_CONTENT_TOO_LARGE` if the
+ *   announced length is above `_max_request`, before reading the body.
  */
 void HttpRequestHandler::load_content_normal() {
 	if (_request_data.content_length == 0) {
 		_log->log_info( RH_NAME,
 				  "No Content-Length to read from FD.");
+		_request_data.read_phase = READ_DONE;
 		return;
 	}
-	char buffer[BUFFER_REQUEST];
-	int read_byte;
-	size_t size = _request.length();
-	if (size > _max_request) {
+	if (_request_data.content_length > _max_request) {
 		turn_off_sanity(HTTP_CONTENT_TOO_LARGE,
 						"Body Content too Large.");
 		return;
 	}
-	size_t to_read = _request_data.content_length - _request.length();
-	int retry_count = 0;
-
-	try {
-		while (to_read > 0) {
-			read_byte = recv(_fd, buffer, sizeof(buffer), 0);
-			if (read_byte > 0) {
-				size += read_byte;
-				to_read -= read_byte;
-
-				if (size > _max_request) {
-					turn_off_sanity(HTTP_CONTENT_TOO_LARGE,
-									"Body Content too Large.");
-					return;
-				}
-				_request.append(buffer, read_byte);
-				retry_count = 0;
-				if (!_client_data->chronos_request()) {
-					turn_off_sanity(HTTP_REQUEST_TIMEOUT,
-									"Request Timeout.");
-					return;
-				}
-			} else if (read_byte == 0) {
-				_client_data->kill_client();
-				turn_off_sanity(HTTP_CLIENT_CLOSE_REQUEST,
-								"Client Close Request");
-				_client_data->kill_client();
-				return;
-			} else {
-				retry_count++;
-				if (retry_count >= WS_MAX_RETRIES) {
-					turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-									"Max retries exceeded while reading from socket.");
-					return;
-				}
-				usleep(WS_RETRY_DELAY_MICROSECONDS);
-				continue;
-			}
-		}
-		_client_data->chronos_reset();
-		_request_data.body = _request;
-		_log->log_debug( RH_NAME,
-				  "Request body read.");
-	}
-	catch (std::exception& e) {
-		std::ostringstream detail;
-		detail << "Error reading request: " << e.what();
-		turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-						detail.str());
-		_client_data->kill_client();
+	if (_request.size() < _request_data.content_length) {
+		return;
 	}
+	_request_data.body = _request.substr(0, _request_data.content_length);
+	_request.erase(0, _request_data.content_length);
+	_request_data.read_phase = READ_DONE;
+	_log->log_debug( RH_NAME,
+			  "Request body read.");
 }
 
 /**
@@ -1173,8 +1309,13 @@ void HttpRequestHandler::load_content_normal() {
  *    error message if validation fails.
  * 3. **Security Issues**: If a cgi script is trying to be executed, without cgi
  * 	  active, turn off sanity to avoid server the script as plain text.
+ * 4. **Cached Route**: A route restored from the cache passed these checks when
+ *    it was stored, and its method is allowed, so only the body is checked.
  */
 void HttpRequestHandler::validate_request() {
+	if (_request_data.is_cached && _request_data.body.empty()) {
+		return ;
+	}
 	if (is_cgi(_request_data.normalized_path)) {
 		if (!_location->cgi_file) {
 			turn_off_sanity(HTTP_FORBIDDEN,
@@ -1220,8 +1361,7 @@ void HttpRequestHandler::validate_request() {
  *   - If `_request_data.cgi` is true, uses `HttpCGIHandler`.
  *   - If `_request_data.range` is non-empty, uses `HttpRangeHandler`.
  *   - If `_request_data.boundary` is non-empty, uses `HttpMultipartHandler`.
- * @note: This method will cache request related info if it was not cached yet, if
- * 		  everything went ok, and if method is get.
+ * @note: A response that fails on a cached route drops the route from the cache.
  *
  * **Exception Handling**:
  * - Catches `WebServerException`, `Logger::NoLoggerPointer`, and `std::exception`
@@ -1245,18 +1385,7 @@ void HttpRequestHandler::handle_request() {
 		if (_request_data.factory == 0) {
 			HttpResponseHandler response(_location, _log, _client_data, _request_data, _fd);
 			response.handle_request();
-			if (_request_data.is_cached) {
-				if (!_request_data.sanity) {
-					_cache->remove(_request_data.path);
-					return ;
-				}
-				return;
-			}
-			if (_request_data.sanity && HAS_GET(_request_data.method)) {
-				_cache->put(_request_data.path,
-							   CacheRequest(_request_data.path, _host_config,
-											_location, _request_data.normalized_path));
-			}
+			forget_failed_route();
 			return;
 		}
 		if (_request_data.is_redir) {
@@ -1267,11 +1396,13 @@ void HttpRequestHandler::handle_request() {
 		if (_request_data.autoindex) {
 			HttpAutoIndex response(_location, _log, _client_data, _request_data, _fd);
 			response.handle_request();
+			forget_failed_route();
 			return;
 		}
 		if (_request_data.cgi) {
 			HttpCGIHandler response(_location, _log, _client_data, _request_data, _fd);
 			response.handle_request();
+			forget_failed_route();
 			_client_data->deactivate();
 			return ;
 		} else if (!_request_data.range.empty()){
@@ -1306,6 +1437,42 @@ void HttpRequestHandler::handle_request() {
 }
 
 
+/**
+ * @brief Builds the response of a request whose `IoTask` completed.
+ *
+ * The client kept the request (`s_request`) while the task ran, so the
+ * response handler is chosen as `handle_request` chose it, and answers from
+ * the task (`WsResponseHandler::resume`). Only handlers that offload are
+ * considered: the directory index, multipart uploads, and the standard
+ * handler (POST, DELETE).
+ *
+ * @param task Completed task. Owned by the caller.
+ */
+void HttpRequestHandler::resume_request(IoTask* task) {
+	if (!_client_data->is_alive()) {
+		return;
+	}
+	try {
+		if (_request_data.factory != 0 && _request_data.autoindex) {
+			HttpAutoIndex response(_location, _log, _client_data, _request_data, _fd);
+			response.resume(task);
+		} else if (_request_data.factory != 0 && !_request_data.boundary.empty()) {
+			HttpMultipartHandler response(_location, _log, _client_data, _request_data, _fd);
+			response.resume(task);
+		} else {
+			HttpResponseHandler response(_location, _log, _client_data, _request_data, _fd);
+			response.resume(task);
+		}
+		forget_failed_route();
+	} catch (std::exception& e) {
+		std::ostringstream detail;
+		detail << "Unknown error resuming response: " << e.what();
+		_log->log_error( RH_NAME,
+		          detail.str());
+		_client_data->kill_client();
+	}
+}
+
 /**
  * @brief Disables the request's sanity state and sets an error status.
  *
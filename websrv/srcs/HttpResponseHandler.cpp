@@ -11,6 +11,8 @@
 /* ************************************************************************** */
 
 #include "HttpResponseHandler.hpp"
+#include "TimerWheel.hpp"
+#include <cerrno>
 
 /**
  * @brief Constructs an `HttpResponseHandler` instance for handling HTTP responses.
@@ -36,37 +38,316 @@ HttpResponseHandler::HttpResponseHandler(const LocationConfig *location,
 										 WsResponseHandler(location, log,
 														   client_data, request,
 														   fd),
-									     _cache(client_data->get_server()->get_cache()) {
+									     _cache(client_data->get_server()->get_cache()),
+									     _open_files(client_data->get_server()->get_open_files()),
+									     _file(NULL),
+									     _cache_valid(client_data->get_server()->get_config().ws_file_cache_valid),
+									     _file_stamp(),
+									     _stamped(false) {
 	_log->log_debug( RHB_NAME,
 			  "Static Response Handler Init.");
 }
 
 /**
- * @brief Retrieves the content of a file, utilizing the cache if available.
+ * @brief Destructor. Releases the open file; queued file segments keep their own reference.
+ */
+HttpResponseHandler::~HttpResponseHandler() {
+	if (_file) {
+		_file->release();
+	}
+}
+
+/**
+ * @brief Handles GET requests from the cache, or streaming large files.
  *
- * Attempts to retrieve the file content from the cache. If the content is not
- * cached, it loads the file content from disk using the base `WsResponseHandler`
- * method. If the content is successfully loaded, it is then stored in the cache.
+ * A cached file checked less than `file_cache_valid` milliseconds ago is sent
+ * with `send_cached` without touching the file system. Otherwise the file is
+ * stat'ed once, and that result serves every decision:
+ * - A path that is gone is dropped from the cache and answered with a 404.
+ * - A cached entry whose FileStamp still matches is sent, and marked as
+ *   validated. One that does not match (edited, replaced) is dropped.
+ * - A conditional request matching the stamp gets a 304, the file is not
+ *   opened.
+ * - Files of SENDFILE_THRESHOLD bytes or more are sent with `stream_file`.
+ * - Anything else follows the regular path (`WsResponseHandler::handle_get`),
+ *   which reads the file and caches it with the stamp taken here.
  *
- * @param path Path to the file whose content is to be retrieved.
+ * @returns `true` if the response was queued; `false` if an error response was sent.
  */
-void HttpResponseHandler::get_file_content(std::string &path) {
-	CacheEntry data;
-	if (!_cache.get(path, data)) {
-		WsResponseHandler::get_file_content(path);
-		if (_request.sanity) {
-			_cache.put(path, CacheEntry(path, _response_data.content));
-		}
-	} else {
-		struct stat buffer;
-		if (stat(path.c_str(), &buffer) == 0) {
-			_response_data.content = data.content;
-			_response_data.status = true;
-		} else {
-			_cache.remove(path);
+bool HttpResponseHandler::handle_get() {
+	const std::string& path = _request.normalized_path;
+	if (!HAS_GET(_location->loc_allowed_methods) || path.empty()) {
+		return (WsResponseHandler::handle_get());
+	}
+	const std::string key = clean_path(path);
+	CacheHandle<CacheEntry> entry;
+	bool cached = _cache.get(key, entry);
+	t_msec now = TimerWheel::now_msec();
+	if (cached && now - entry->validated < _cache_valid) {
+		return (send_cached(entry));
+	}
+	_file = _open_files.acquire(key);
+	if (_file == NULL) {
+		if (errno == ENOENT || errno == ENOTDIR) {
+			_cache.remove(key);
 			turn_off_sanity(HTTP_NOT_FOUND,
 							"File is not found.");
+			return (send_error_response());
+		}
+		return (WsResponseHandler::handle_get());
+	}
+	_file_stamp = _file->stamp;
+	_stamped = true;
+	if (cached) {
+		if (entry->stamp == _file_stamp) {
+			entry->validated = now;
+			return (send_cached(entry));
+		}
+		_log->log_debug( RHB_NAME, "Cached file changed on disk, reloading.");
+		_cache.remove(key);
+	}
+	set_validators(_file_stamp);
+	if (not_modified(_file_stamp)) {
+		return (send_not_modified(path, _file->size));
+	}
+	if (_file->size >= SENDFILE_THRESHOLD) {
+		return (stream_file(path));
+	}
+	return (WsResponseHandler::handle_get());
+}
+
+/**
+ * @brief Queues a response whose body is a cached file.
+ *
+ * The body and the header lines serialized with it (`CacheEntry::head`) are
+ * queued by reference: the client's `OutputQueue` keeps the cache block alive
+ * until they are sent, so a hit copies no file byte and formats nothing. Only
+ * the status and `Host` line is built; the `Connection` lines are literals.
+ * The segments leave in one gathered write, the same bytes `header` would
+ * produce. Conditional requests are answered from the entry's stamp, with a
+ * 304 if it matches.
+ *
+ * @param entry Cached file.
+ * @returns `true` if the response was queued.
+ */
+bool HttpResponseHandler::send_cached(const CacheHandle<CacheEntry>& entry) {
+	set_validators(entry->stamp);
+	if (not_modified(entry->stamp)) {
+		return (send_not_modified(entry->url, entry->content.size()));
+	}
+	_request.status = HTTP_OK;
+	_response_data.status = true;
+	_headers.reserve(sizeof(RHB_STATUS_OK) + _request.host.size());
+	_headers.assign(RHB_STATUS_OK);
+	_headers.append(_request.host);
+	OutputQueue& output = _client_data->output();
+	const std::string& head = entry->head;
+	output.enqueue_swap(_headers);
+	output.enqueue_shared(head.data(), entry->head_split, entry.block());
+	if (_client_data->is_active()) {
+		output.enqueue_static(RHB_KEEP_ALIVE, sizeof(RHB_KEEP_ALIVE) - 1);
+	} else {
+		output.enqueue_static(RHB_CLOSE, sizeof(RHB_CLOSE) - 1);
+	}
+	output.enqueue_shared(head.data() + entry->head_split, head.size() - entry->head_split,
+						  entry.block());
+	output.enqueue_shared(entry->content.data(), entry->content.size(), entry.block());
+	_log->log_debug( RHB_NAME, "File content sent from cache.");
+	return (true);
+}
+
+/**
+ * @brief Sets the validators of the response, `ETag` and `Last-Modified`.
+ *
+ * The ETag is strong, derived from inode, size and modification time (with
+ * nanoseconds), so any change of the file changes it.
+ *
+ * @param stamp Version of the file being answered.
+ */
+void HttpResponseHandler::set_validators(const FileStamp& stamp) {
+	std::ostringstream etag;
+	etag << std::hex << "\"" << static_cast<unsigned long>(stamp.ino)
+		 << "-" << static_cast<unsigned long>(stamp.size)
+		 << "-" << static_cast<unsigned long>(stamp.mtime)
+		 << "." << static_cast<unsigned long>(stamp.mtime_nsec) << "\"";
+	_response_data.etag = etag.str();
+	_response_data.last_modified = http_date(stamp.mtime);
+}
+
+/**
+ * @brief Evaluates the conditional headers of a GET against a file version.
+ *
+ * As RFC 9110 requires, `If-None-Match` takes precedence: when present,
+ * `If-Modified-Since` is ignored. `If-None-Match` uses weak comparison, so
+ * `W/` prefixes are dropped, and `*` matches any existing file. A date that can
+ * not be parsed is ignored.
+ *
+ * @param stamp Version of the requested file. `set_validators` must have run.
+ * @returns `true` if the client copy is current and a 304 can be sent.
+ */
+bool HttpResponseHandler::not_modified(const FileStamp& stamp) const {
+	const std::string& match = _request.if_none_match;
+	if (!match.empty()) {
+		size_t start = 0;
+		while (start < match.size()) {
+			size_t end = match.find(',', start);
+			if (end == std::string::npos) {
+				end = match.size();
+			}
+			std::string tag = trim(match.substr(start, end - start), " \t");
+			if (starts_with(tag, "W/")) {
+				tag = tag.substr(2);
+			}
+			if (tag == "*" || tag == _response_data.etag) {
+				return (true);
+			}
+			start = end + 1;
+		}
+		return (false);
+	}
+	time_t since;
+	if (!_request.if_modified_since.empty()
+		&& parse_http_date(trim(_request.if_modified_since, " \t"), since)) {
+		return (stamp.mtime <= since);
+	}
+	return (false);
+}
+
+/**
+ * @brief Queues a 304 Not Modified response, header only.
+ *
+ * `Content-Length` carries the size the 200 response would have, as RFC 9110
+ * allows; no body follows.
+ *
+ * @param path Requested file, for the Content-Type.
+ * @param size Size of the file.
+ * @returns `true` if the response was queued.
+ */
+bool HttpResponseHandler::send_not_modified(const std::string& path, size_t size) {
+	_request.status = HTTP_NOT_MODIFIED;
+	_response_data.status = true;
+	_headers = header(_request.status, size, content_type(path));
+	_client_data->output().enqueue_swap(_headers);
+	_log->log_debug( RHB_NAME, "Client copy is current, 304 sent.");
+	return (true);
+}
+
+/**
+ * @brief MIME type of a file being answered.
+ *
+ * The request's resolved file comes with its MIME type when its route was
+ * cached, so it is not looked up again.
+ *
+ * @param path File being answered.
+ */
+std::string HttpResponseHandler::content_type(const std::string& path) const {
+	if (!_request.mime.empty() && path == _request.normalized_path) {
+		return (_request.mime);
+	}
+	return (get_mime_type(path));
+}
+
+/**
+ * @brief Queues a file response whose body is sent straight from the open file.
+ *
+ * The size comes from the `fstat` of the open descriptor (`_file`), so header
+ * and body agree even if the path changes meanwhile. The header is queued, then
+ * the shared descriptor as a file segment, which keeps the `OpenFile` alive
+ * until it is sent. No file byte is copied to user space.
+ *
+ * @param path Regular file to send, for the Content-Type.
+ * @returns `true` if the response was queued.
+ */
+bool HttpResponseHandler::stream_file(const std::string& path) {
+	size_t size = _file->size;
+	_request.status = HTTP_OK;
+	_headers = header(_request.status, size, content_type(path));
+	OutputQueue& output = _client_data->output();
+	output.enqueue_swap(_headers);
+	output.enqueue_shared_file(_file->fd, 0, size, _file);
+	std::ostringstream detail;
+	detail << "File streamed with sendfile. Size: " << size;
+	_log->log_debug( RHB_NAME, detail.str());
+	return (true);
+}
+
+/**
+ * @brief Reads the whole open file with `pread()`, as the base `get_file_content` would.
+ *
+ * The descriptor is shared, so the offset is explicit. Reading stops at the
+ * size of the `fstat`: a file that shrank meanwhile is an error.
+ */
+void HttpResponseHandler::read_open_file() {
+	std::string content(_file->size, '\0');
+	size_t done = 0;
+	while (done < content.size()) {
+		ssize_t got = pread(_file->fd, &content[done], content.size() - done, static_cast<off_t>(done));
+		if (got < 0 && errno == EINTR) {
+			continue ;
+		}
+		if (got <= 0) {
+			turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
+							"Error reading file: " + _file->path);
+			return ;
 		}
+		done += static_cast<size_t>(got);
+	}
+	_response_data.content.swap(content);
+	_response_data.status = true;
+	_log->log_debug( RHB_NAME, "File content read from open file.");
+}
+
+/**
+ * @brief Serializes the header lines of a cached file that do not depend on the request.
+ *
+ * Starts by ending the `Host` line, then `Content-Length` and `Content-Type`;
+ * `split` marks where the `Connection` lines go, followed by the validators
+ * `set_validators` set and the blank line, in the order `header` uses.
+ *
+ * @param size Content length.
+ * @param mime Content type.
+ * @param split Output. Offset of the `Connection` lines.
+ * @return The serialized lines.
+ */
+std::string HttpResponseHandler::cached_head(size_t size, const std::string& mime, size_t& split) const {
+	std::ostringstream head;
+	head << "\r\n"
+		 << "Content-Length: " << size << "\r\n"
+		 << "Content-Type: " << mime << "\r\n";
+	split = head.str().size();
+	if (!_response_data.etag.empty()) {
+		head << "ETag: " << _response_data.etag << "\r\n"
+			 << "Last-Modified: " << _response_data.last_modified << "\r\n";
+	}
+	head << "\r\n";
+	return (head.str());
+}
+
+/**
+ * @brief Loads the content of a file, and stores it in the cache.
+ *
+ * Lookups are done by `handle_get`, so this is only reached on a cache miss.
+ * The content is read from the file `handle_get` opened (`read_open_file`),
+ * or loaded with the base `WsResponseHandler` method when there is none. If
+ * it was read successfully, it is cached for the next requests with the
+ * FileStamp of the open file and its serialized header lines. If the file
+ * changed in between, the stamp is older than the content and the next
+ * validation reloads it.
+ *
+ * @param path Path to the file whose content is to be retrieved.
+ */
+void HttpResponseHandler::get_file_content(std::string &path) {
+	if (_file) {
+		read_open_file();
+	} else {
+		WsResponseHandler::get_file_content(path);
+	}
+	if (_request.sanity && _stamped) {
+		const std::string key = clean_path(path);
+		size_t split = 0;
+		std::string head = cached_head(_response_data.content.size(), content_type(path), split);
+		_cache.put(key, CacheEntry(key, _response_data.content, head, split,
+								   _file_stamp, TimerWheel::now_msec()));
 	}
 }
 
@@ -0,0 +1,238 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IoPool.cpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 02:10:26 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 02:10:26 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "IoPool.hpp"
+#include "webserver.hpp"
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#ifdef __linux__
+# include <sys/eventfd.h>
+#endif
+
+/**
+ * @brief Constructs an idle pool. `start` creates the threads.
+ *
+ * @param log Pointer to the Logger instance. Only used by the event loop thread.
+ */
+IoPool::IoPool(const Logger* log):
+	_log(log),
+	_threads(),
+	_queue(),
+	_done(),
+	_stopping(false),
+	_notify_read(-1),
+	_notify_write(-1) {
+	pthread_mutex_init(&_lock, NULL);
+	pthread_cond_init(&_wake, NULL);
+}
+
+/**
+ * @brief Destructor. Stops the threads, then deletes the tasks nobody collected.
+ *
+ * A thread in the middle of a task finishes it first.
+ */
+IoPool::~IoPool() {
+	stop();
+	for (size_t i = 0; i < _queue.size(); i++) {
+		delete _queue[i];
+	}
+	for (size_t i = 0; i < _done.size(); i++) {
+		delete _done[i];
+	}
+	if (_notify_write >= 0 && _notify_write != _notify_read) {
+		close(_notify_write);
+	}
+	if (_notify_read >= 0) {
+		close(_notify_read);
+	}
+	pthread_cond_destroy(&_wake);
+	pthread_mutex_destroy(&_lock);
+}
+
+/**
+ * @brief Opens the notification descriptor and creates the threads.
+ *
+ * Signals are blocked while threads are created, so they inherit a full mask.
+ *
+ * @param threads Number of threads. `0` starts nothing.
+ * @return `true` if at least one thread runs.
+ */
+bool IoPool::start(size_t threads) {
+	if (threads == 0) {
+		return (false);
+	}
+#ifdef __linux__
+	_notify_read = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	_notify_write = _notify_read;
+#else
+	int ends[2];
+	if (pipe(ends) == 0) {
+		for (int i = 0; i < 2; i++) {
+			fcntl(ends[i], F_SETFL, fcntl(ends[i], F_GETFL, 0) | O_NONBLOCK);
+			fcntl(ends[i], F_SETFD, FD_CLOEXEC);
+		}
+		_notify_read = ends[0];
+		_notify_write = ends[1];
+	}
+#endif
+	if (_notify_read < 0) {
+		_log->log_warning(IP_NAME, "Notification descriptor not available, I/O runs inline.");
+		return (false);
+	}
+	sigset_t all;
+	sigset_t previous;
+	sigfillset(&all);
+	pthread_sigmask(SIG_BLOCK, &all, &previous);
+	for (size_t i = 0; i < threads; i++) {
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, &IoPool::thread_routine, this) != 0) {
+			break ;
+		}
+		_threads.push_back(thread);
+	}
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+	if (_threads.size() < threads) {
+		_log->log_warning(IP_NAME, "Only " + int_to_string(static_cast<int>(_threads.size()))
+								   + " I/O threads could be created.");
+	}
+	return (!_threads.empty());
+}
+
+/**
+ * @brief Tells if tasks can be submitted.
+ */
+bool IoPool::active() const {
+	return (!_threads.empty());
+}
+
+/**
+ * @brief Notification descriptor, to be registered for read readiness.
+ */
+int IoPool::get_fd() const {
+	return (_notify_read);
+}
+
+/**
+ * @brief Queues a task for the next free thread.
+ *
+ * @param task Task to run. The pool owns it until `collect` returns it.
+ * @return `false` if the pool is not running or its queue is full: the task
+ *         is left to the caller.
+ */
+bool IoPool::submit(IoTask* task) {
+	if (_threads.empty()) {
+		return (false);
+	}
+	pthread_mutex_lock(&_lock);
+	if (_stopping || _queue.size() >= IO_POOL_MAX_QUEUE) {
+		pthread_mutex_unlock(&_lock);
+		return (false);
+	}
+	_queue.push_back(task);
+	pthread_cond_signal(&_wake);
+	pthread_mutex_unlock(&_lock);
+	return (true);
+}
+
+/**
+ * @brief Takes every completed task, in completion order.
+ *
+ * The notification descriptor is drained before the list is taken, so a task
+ * completed meanwhile either is taken now or signals again.
+ *
+ * @param done Output. Completed tasks are appended; the caller deletes them.
+ */
+void IoPool::collect(std::vector<IoTask*>& done) {
+	drain_notify();
+	pthread_mutex_lock(&_lock);
+	done.insert(done.end(), _done.begin(), _done.end());
+	_done.clear();
+	pthread_mutex_unlock(&_lock);
+}
+
+/**
+ * @brief Entry point of a pool thread.
+ */
+void* IoPool::thread_routine(void* pool) {
+	static_cast<IoPool*>(pool)->work();
+	return (NULL);
+}
+
+/**
+ * @brief Runs queued tasks until the pool stops.
+ *
+ * The event loop is signaled only when the completed list was empty: a loop
+ * that did not collect yet will take the new task with the others.
+ */
+void IoPool::work() {
+	pthread_mutex_lock(&_lock);
+	while (true) {
+		while (!_stopping && _queue.empty()) {
+			pthread_cond_wait(&_wake, &_lock);
+		}
+		if (_stopping) {
+			break ;
+		}
+		IoTask* task = _queue.front();
+		_queue.pop_front();
+		pthread_mutex_unlock(&_lock);
+		task->run();
+		pthread_mutex_lock(&_lock);
+		bool signal = _done.empty();
+		_done.push_back(task);
+		if (signal) {
+			notify();
+		}
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+/**
+ * @brief Makes the notification descriptor readable.
+ */
+void IoPool::notify() {
+#ifdef __linux__
+	uint64_t one = 1;
+	ssize_t written = write(_notify_write, &one, sizeof(one));
+#else
+	ssize_t written = write(_notify_write, "", 1);
+#endif
+	(void)written;
+}
+
+/**
+ * @brief Empties the notification descriptor.
+ */
+void IoPool::drain_notify() {
+	char buffer[64];
+	if (_notify_read < 0) {
+		return ;
+	}
+	while (read(_notify_read, buffer, sizeof(buffer)) > 0)
+		;
+}
+
+/**
+ * @brief Wakes every thread to finish, and waits for them.
+ */
+void IoPool::stop() {
+	pthread_mutex_lock(&_lock);
+	_stopping = true;
+	pthread_cond_broadcast(&_wake);
+	pthread_mutex_unlock(&_lock);
+	for (size_t i = 0; i < _threads.size(); i++) {
+		pthread_join(_threads[i], NULL);
+	}
+	_threads.clear();
+}
@@ -0,0 +1,130 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IoTask.cpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 02:10:26 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 02:10:26 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "IoTask.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <dirent.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Constructs a task of the given kind, not yet bound to a client.
+ */
+IoTask::IoTask(t_io_kind task_kind):
+	kind(task_kind),
+	client_fd(-1) {}
+
+IoTask::~IoTask() {}
+
+/**
+ * @param dir_path Directory to list, ending with '/' as `normalized_path` does.
+ */
+IoListDir::IoListDir(const std::string& dir_path):
+	IoTask(IO_LIST_DIR),
+	path(dir_path),
+	opened(false),
+	skipped(0),
+	items() {}
+
+/**
+ * @brief Reads every entry but `.` and `..`, with its `stat()`.
+ */
+void IoListDir::run() {
+	DIR* dir = opendir(path.c_str());
+	if (dir == NULL) {
+		return ;
+	}
+	opened = true;
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL) {
+		std::string name = entry->d_name;
+		if (name == "." || name == "..") {
+			continue ;
+		}
+		struct stat info;
+		if (stat((path + name).c_str(), &info) == -1) {
+			skipped++;
+			continue ;
+		}
+		t_dir_item item;
+		item.name = name;
+		item.is_dir = S_ISDIR(info.st_mode);
+		item.size = info.st_size;
+		item.mtime = info.st_mtime;
+		items.push_back(item);
+	}
+	closedir(dir);
+}
+
+IoSaveFiles::IoSaveFiles():
+	IoTask(IO_SAVE_FILES),
+	paths(),
+	contents(),
+	saved(0),
+	error(0) {}
+
+/**
+ * @brief Queues a file to write. `content` is swapped in, and left empty.
+ */
+void IoSaveFiles::add(const std::string& path, std::string& content) {
+	paths.push_back(path);
+	contents.push_back(std::string());
+	contents.back().swap(content);
+}
+
+/**
+ * @brief Writes the files in order, stopping at the first one that fails.
+ */
+void IoSaveFiles::run() {
+	for (size_t i = 0; i < paths.size(); i++) {
+		if (std::ifstream(paths[i].c_str()).good()) {
+			error = EEXIST;
+			return ;
+		}
+		errno = 0;
+		std::ofstream file(paths[i].c_str());
+		if (!file.is_open()) {
+			error = (errno != 0 ? errno : EIO);
+			return ;
+		}
+		file << contents[i];
+		file.close();
+		if (file.fail()) {
+			error = EIO;
+			return ;
+		}
+		saved++;
+	}
+}
+
+/**
+ * @param file_path File to remove.
+ */
+IoRemoveFile::IoRemoveFile(const std::string& file_path):
+	IoTask(IO_REMOVE_FILE),
+	path(file_path),
+	found(false),
+	error(0) {}
+
+/**
+ * @brief Removes the file, if it can be opened.
+ */
+void IoRemoveFile::run() {
+	if (!std::ifstream(path.c_str()).good()) {
+		return ;
+	}
+	found = true;
+	if (std::remove(path.c_str()) != 0) {
+		error = errno;
+	}
+}
@@ -23,7 +23,7 @@
  *
  * @note If the provided log level is out of the allowed range (LOG_DEBUG to LOG_ERROR), the constructor will terminate the program.
  */
-Logger::Logger(int level, bool log_to_file): _level(level), _log_to_file(log_to_file)
+Logger::Logger(int level, bool log_to_file): _level(level), _log_to_file(log_to_file), _fatal_throws(false)
 {
 	if (_level > LOG_ERROR || _level < LOG_DEBUG) {
 		std::cerr << "[LOGGER][ERROR]. Log level off limits (0-3)." << std::endl;
@@ -85,11 +85,17 @@ void Logger::log(int log_level, const std::string& module, const std::string& me
  * @brief Logs a fatal error message and terminates the program.
  *
  * This function logs a fatal error message, prints it to the standard error output, and then terminates the program.
+ * With `throw_on_fatal` enabled, `FatalError` is thrown instead, and nothing is printed.
  *
  * @param module The name of the module or component generating the log message.
  * @param message The fatal error message to be recorded.
+ *
+ * @throws Logger::FatalError If `throw_on_fatal` is enabled.
  */
  void Logger::fatal_log(const std::string &module, const std::string &message) const {
+	if (_fatal_throws) {
+		throw FatalError("[" + module + "]: " + message);
+	}
 	*(_log_out) << "[FATAL ERROR][" << module << "]: " << message << std::endl;
 	std::cerr << "[FATAL ERROR][" << module << "]: " << message << std::endl;
 	exit(1);
@@ -180,3 +186,26 @@ const char *Logger::NoLoggerPointer::what(void) const throw() {
 	return ("Logger Pointer cannot be NULL.");
 }
 
+/**
+ * @brief Makes `fatal_log` throw `FatalError` instead of terminating the program.
+ *
+ * Used while a configuration is parsed again on a running server (`reload_file`):
+ * an invalid file must not end the process serving the previous one.
+ *
+ * @param enabled `true` to throw, `false` (default) to terminate.
+ */
+void Logger::throw_on_fatal(bool enabled) {
+	_fatal_throws = enabled;
+}
+
+Logger::FatalError::FatalError(const std::string& message): _message(message) {}
+
+Logger::FatalError::~FatalError() throw() {}
+
+/**
+ * @brief Returns the error `fatal_log` was called with.
+ */
+const char *Logger::FatalError::what(void) const throw() {
+	return (_message.c_str());
+}
+
@@ -0,0 +1,183 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OpenFileCache.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 23:58:40 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 23:58:40 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "OpenFileCache.hpp"
+#include "TimerWheel.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Takes ownership of an open descriptor.
+ */
+OpenFile::OpenFile(const std::string& file_path, int file_fd,
+				   const struct stat& info, uint64_t now):
+	CacheBlock(),
+	path(file_path),
+	fd(file_fd),
+	size(static_cast<size_t>(info.st_size)),
+	stamp(info),
+	validated(now) {}
+
+/**
+ * @brief Closes the descriptor. Reached through the last `release`.
+ */
+OpenFile::~OpenFile() {
+	close(fd);
+}
+
+/**
+ * @brief Constructs an empty cache.
+ *
+ * @param max Files kept open at most. `0` keeps none.
+ * @param valid Milliseconds an entry is trusted before it is checked again.
+ */
+OpenFileCache::OpenFileCache(size_t max, size_t valid):
+	_lru(),
+	_index(),
+	_max(max),
+	_valid(valid) {}
+
+/**
+ * @brief Destructor. Drops the cache references; files still in use stay open.
+ */
+OpenFileCache::~OpenFileCache() {
+	clear();
+}
+
+/**
+ * @brief Opens a regular file and takes its metadata from the descriptor.
+ *
+ * `O_NONBLOCK` keeps a FIFO from blocking the worker; it has no effect on
+ * regular files. When the process is out of descriptors, the cached ones are
+ * dropped and the open is tried once more.
+ *
+ * @return The file, with one reference for the caller, or NULL with `errno`
+ *         set (`EISDIR` for anything but a regular file).
+ */
+OpenFile* OpenFileCache::open_file(const std::string& path, uint64_t now) {
+	int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+	if (fd < 0 && (errno == EMFILE || errno == ENFILE) && !_lru.empty()) {
+		clear();
+		fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+	}
+	if (fd < 0) {
+		return (NULL);
+	}
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	struct stat info;
+	int error = 0;
+	if (fstat(fd, &info) != 0) {
+		error = errno;
+	} else if (!S_ISREG(info.st_mode)) {
+		error = EISDIR;
+	}
+	if (error != 0) {
+		close(fd);
+		errno = error;
+		return (NULL);
+	}
+	return (new OpenFile(path, fd, info, now));
+}
+
+/**
+ * @brief Removes an entry from the index, dropping the cache reference.
+ */
+void OpenFileCache::drop(t_index::iterator it) {
+	OpenFile* file = *it->second;
+	_lru.erase(it->second);
+	_index.erase(it);
+	file->release();
+}
+
+/**
+ * @brief Gets an open descriptor for a regular file.
+ *
+ * - A cached file younger than the validity is returned as is.
+ * - An older one is checked with `stat()`: unchanged, it is trusted again;
+ *   changed or gone, it is dropped and the path opened again.
+ * - A new file is opened, `fstat`ed and indexed, closing the least recently
+ *   used one past the limit.
+ *
+ * @param path Clean path of the file.
+ * @return The file with a reference for the caller, who must `release` it (or
+ *         hand it to an owner that does). NULL with `errno` set on failure.
+ */
+OpenFile* OpenFileCache::acquire(const std::string& path) {
+	uint64_t now = TimerWheel::now_msec();
+	t_index::iterator it = _index.find(path);
+	if (it != _index.end()) {
+		OpenFile* file = *it->second;
+		bool valid = now - file->validated < _valid;
+		if (!valid) {
+			struct stat info;
+			valid = stat(path.c_str(), &info) == 0 && FileStamp(info) == file->stamp;
+		}
+		if (valid) {
+			file->validated = now;
+			_lru.splice(_lru.begin(), _lru, it->second);
+			file->retain();
+			return (file);
+		}
+		drop(it);
+	}
+	OpenFile* file = open_file(path, now);
+	if (file == NULL || _max == 0) {
+		return (file);
+	}
+	_lru.push_front(file);
+	_index[path] = _lru.begin();
+	file->retain();
+	while (_index.size() > _max) {
+		drop(_index.find(_lru.back()->path));
+	}
+	return (file);
+}
+
+/**
+ * @brief Forgets a path, after it changed or was deleted.
+ */
+void OpenFileCache::remove(const std::string& path) {
+	t_index::iterator it = _index.find(path);
+	if (it != _index.end()) {
+		drop(it);
+	}
+}
+
+/**
+ * @brief Forgets every path.
+ */
+void OpenFileCache::clear() {
+	while (!_index.empty()) {
+		drop(_index.begin());
+	}
+}
+
+/**
+ * @brief Exchanges open files and limits with another cache.
+ *
+ * List iterators stay valid across `std::list::swap`, so each index keeps
+ * pointing into the list it moved with.
+ */
+void OpenFileCache::swap(OpenFileCache& other) {
+	_lru.swap(other._lru);
+	_index.swap(other._index);
+	std::swap(_max, other._max);
+	std::swap(_valid, other._valid);
+}
+
+/**
+ * @brief Number of files kept open by the cache.
+ */
+size_t OpenFileCache::size() const {
+	return (_index.size());
+}
@@ -0,0 +1,299 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OutputQueue.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 17:12:41 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 17:12:41 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "OutputQueue.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef __linux__
+# include <sys/sendfile.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+# define MSG_NOSIGNAL 0
+#endif
+
+/**
+ * @brief Constructs an empty queue.
+ */
+OutputQueue::OutputQueue():
+	_segments(),
+	_pending(0) {}
+
+/**
+ * @brief Destructor. Unsent bytes are discarded and queued files closed.
+ */
+OutputQueue::~OutputQueue() {
+	clear();
+}
+
+/**
+ * @brief Appends a copy of `data` to the queue. Empty buffers are ignored.
+ *
+ * @param data Bytes to send after everything already queued.
+ */
+void OutputQueue::enqueue(const std::string& data) {
+	if (data.empty()) {
+		return ;
+	}
+	_segments.push_back(t_out_segment());
+	_segments.back().data = data;
+	_pending += data.size();
+}
+
+/**
+ * @brief Appends `data` to the queue without copying it.
+ *
+ * The buffer is swapped into the queue, so `data` is left empty.
+ *
+ * @param data Bytes to send after everything already queued.
+ */
+void OutputQueue::enqueue_swap(std::string& data) {
+	if (data.empty()) {
+		return ;
+	}
+	_segments.push_back(t_out_segment());
+	_segments.back().data.swap(data);
+	_pending += _segments.back().data.size();
+}
+
+/**
+ * @brief Appends bytes owned by a cache block, without copying them.
+ *
+ * The queue retains `keep` until the bytes are sent or the queue is cleared,
+ * so the cache may evict or replace the entry meanwhile.
+ *
+ * @param data First byte to send. Must live as long as `keep`.
+ * @param size Bytes to send.
+ * @param keep Block owning `data`.
+ */
+void OutputQueue::enqueue_shared(const char* data, size_t size, CacheBlock* keep) {
+	if (size == 0) {
+		return ;
+	}
+	_segments.push_back(t_out_segment());
+	_segments.back().shared = data;
+	_segments.back().shared_size = size;
+	_segments.back().keep = keep;
+	keep->retain();
+	_pending += size;
+}
+
+/**
+ * @brief Appends bytes that outlive any connection (string literals), without copying them.
+ *
+ * @param data First byte to send. Must never be released.
+ * @param size Bytes to send.
+ */
+void OutputQueue::enqueue_static(const char* data, size_t size) {
+	if (size == 0) {
+		return ;
+	}
+	_segments.push_back(t_out_segment());
+	_segments.back().shared = data;
+	_segments.back().shared_size = size;
+	_pending += size;
+}
+
+/**
+ * @brief Appends a file range, to be sent without loading it in memory.
+ *
+ * The queue takes ownership of `file_fd` and closes it once the range is sent
+ * or the queue is cleared.
+ *
+ * @param file_fd Open, readable file descriptor.
+ * @param offset First byte of the range.
+ * @param length Bytes to send.
+ */
+void OutputQueue::enqueue_file(int file_fd, off_t offset, size_t length) {
+	if (length == 0) {
+		close(file_fd);
+		return ;
+	}
+	_segments.push_back(t_out_segment());
+	_segments.back().file_fd = file_fd;
+	_segments.back().file_offset = offset;
+	_segments.back().file_left = length;
+	_pending += length;
+}
+
+/**
+ * @brief Appends a range of a file owned by a cache block (`OpenFile`).
+ *
+ * The descriptor is shared: it is read with explicit offsets, never closed by
+ * the queue. `keep` is retained until the range is sent or the queue cleared.
+ *
+ * @param file_fd Open, readable file descriptor owned by `keep`.
+ * @param offset First byte of the range.
+ * @param length Bytes to send.
+ * @param keep Block owning `file_fd`.
+ */
+void OutputQueue::enqueue_shared_file(int file_fd, off_t offset, size_t length, CacheBlock* keep) {
+	if (length == 0) {
+		return ;
+	}
+	_segments.push_back(t_out_segment());
+	_segments.back().file_fd = file_fd;
+	_segments.back().file_offset = offset;
+	_segments.back().file_left = length;
+	_segments.back().keep = keep;
+	keep->retain();
+	_pending += length;
+}
+
+/**
+ * @brief Drops the first segment, closing its file or releasing its block.
+ */
+void OutputQueue::release_front() {
+	if (_segments.front().file_fd >= 0 && _segments.front().keep == NULL) {
+		close(_segments.front().file_fd);
+	}
+	if (_segments.front().keep) {
+		_segments.front().keep->release();
+	}
+	_segments.pop_front();
+}
+
+/**
+ * @brief Drops `bytes` from the front of the queue, after a write.
+ *
+ * Fully written segments are released, a partially written one keeps the
+ * offset where the next write has to start.
+ */
+void OutputQueue::consume(size_t bytes) {
+	_pending -= bytes;
+	while (bytes > 0 && !_segments.empty() && _segments.front().file_fd < 0) {
+		t_out_segment& front = _segments.front();
+		size_t left = front.size() - front.offset;
+		if (bytes < left) {
+			front.offset += bytes;
+			return ;
+		}
+		bytes -= left;
+		release_front();
+	}
+}
+
+/**
+ * @brief Sends a file segment until it is done or the socket is full.
+ *
+ * On Linux the bytes go from the page cache to the socket with `sendfile()`.
+ * Elsewhere, OQ_FILE_CHUNK bytes are read with `pread()` and sent, and only
+ * what was actually sent is consumed, so memory use stays bounded.
+ */
+t_flush_status OutputQueue::flush_file(int fd, t_out_segment& segment) {
+	while (segment.file_left > 0) {
+#ifdef __linux__
+		ssize_t sent = sendfile(fd, segment.file_fd, &segment.file_offset, segment.file_left);
+		if (sent == 0) {
+			return (FLUSH_ERROR);
+		}
+#else
+		char buffer[OQ_FILE_CHUNK];
+		size_t want = segment.file_left < sizeof(buffer) ? segment.file_left : sizeof(buffer);
+		ssize_t got = pread(segment.file_fd, buffer, want, segment.file_offset);
+		if (got <= 0) {
+			return (FLUSH_ERROR);
+		}
+		ssize_t sent = send(fd, buffer, got, MSG_NOSIGNAL);
+		if (sent > 0) {
+			segment.file_offset += sent;
+		}
+#endif
+		if (sent < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return (FLUSH_PENDING);
+			}
+			return (FLUSH_ERROR);
+		}
+		segment.file_left -= sent;
+		_pending -= sent;
+	}
+	return (FLUSH_DONE);
+}
+
+/**
+ * @brief Writes as much of the queue as the socket accepts, without waiting.
+ *
+ * Up to OQ_IOV_MAX memory segments are gathered in a single `sendmsg()`, so a
+ * header and its body leave in one system call without being concatenated
+ * first. File segments are sent with `flush_file`.
+ *
+ * @param fd Client socket (non-blocking).
+ * @return `FLUSH_DONE` when the queue is empty, `FLUSH_PENDING` when the socket
+ *         buffer is full, `FLUSH_ERROR` if the socket failed.
+ */
+t_flush_status OutputQueue::flush(int fd) {
+	while (!_segments.empty()) {
+		if (_segments.front().file_fd >= 0) {
+			t_flush_status status = flush_file(fd, _segments.front());
+			if (status != FLUSH_DONE) {
+				return (status);
+			}
+			release_front();
+			continue;
+		}
+		struct iovec iov[OQ_IOV_MAX];
+		size_t count = 0;
+		for (std::deque<t_out_segment>::iterator it = _segments.begin();
+			 it != _segments.end() && it->file_fd < 0 && count < OQ_IOV_MAX; ++it) {
+			iov[count].iov_base = const_cast<char*>(it->bytes() + it->offset);
+			iov[count].iov_len = it->size() - it->offset;
+			count++;
+		}
+		struct msghdr msg;
+		std::memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iov;
+		msg.msg_iovlen = count;
+		ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+		if (sent < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return (FLUSH_PENDING);
+			}
+			return (FLUSH_ERROR);
+		}
+		consume(static_cast<size_t>(sent));
+	}
+	return (FLUSH_DONE);
+}
+
+/**
+ * @brief Tells if there is nothing left to send.
+ */
+bool OutputQueue::empty() const {
+	return (_segments.empty());
+}
+
+/**
+ * @brief Bytes queued and not written yet.
+ */
+size_t OutputQueue::pending() const {
+	return (_pending);
+}
+
+/**
+ * @brief Discards every queued byte, closing queued files.
+ */
+void OutputQueue::clear() {
+	while (!_segments.empty()) {
+		release_front();
+	}
+	_pending = 0;
+}
@@ -0,0 +1,164 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PollBackend.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 11:14:02 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 11:14:02 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "PollBackend.hpp"
+#include "WebserverException.hpp"
+
+/**
+ * @brief Constructs a poll based backend.
+ *
+ * @param log Pointer to the Logger instance.
+ * @throws Logger::NoLoggerPointer If the logger pointer is null.
+ */
+PollBackend::PollBackend(const Logger* log):
+	_log(log) {
+	if (_log == NULL) {
+		throw Logger::NoLoggerPointer();
+	}
+	_poll_fds.reserve(2000);
+	_tags.reserve(2000);
+	_log->log_debug(PB_NAME, "poll backend ready.");
+}
+
+/**
+ * @brief Destructor. Registered fds belong to their owners and are not closed here.
+ */
+PollBackend::~PollBackend() {
+	_poll_fds.clear();
+	_tags.clear();
+	_slots.clear();
+}
+
+/**
+ * @brief Translates WS_EV_* interest flags to poll events.
+ */
+short PollBackend::to_poll(int events) {
+	short poll_events = 0;
+	if (events & WS_EV_READ)
+		poll_events |= POLLIN;
+	if (events & WS_EV_WRITE)
+		poll_events |= POLLOUT;
+	return (poll_events);
+}
+
+/**
+ * @brief Registers a file descriptor.
+ *
+ * @param fd File descriptor to monitor.
+ * @param events WS_EV_* interest flags.
+ * @param tag Owner data returned with every event of this fd.
+ * @return true on success, false if the fd is invalid or already registered.
+ */
+bool PollBackend::add(int fd, int events, t_event_tag* tag) {
+	if (fd < 0) {
+		_log->log_error(PB_NAME, "Invalid file descriptor.");
+		return (false);
+	}
+	if ((size_t)fd >= _slots.size()) {
+		_slots.resize(fd + 1, -1);
+	}
+	if (_slots[fd] != -1) {
+		_log->log_warning(PB_NAME, "fd already registered.");
+		return (false);
+	}
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = to_poll(events);
+	pfd.revents = 0;
+	_poll_fds.push_back(pfd);
+	_tags.push_back(tag);
+	_slots[fd] = (int)_poll_fds.size() - 1;
+	return (true);
+}
+
+/**
+ * @brief Changes the interest flags and owner data of a registered fd.
+ *
+ * @return true on success, false if the fd is not registered.
+ */
+bool PollBackend::modify(int fd, int events, t_event_tag* tag) {
+	if (fd < 0 || (size_t)fd >= _slots.size() || _slots[fd] == -1) {
+		return (false);
+	}
+	_poll_fds[_slots[fd]].events = to_poll(events);
+	_tags[_slots[fd]] = tag;
+	return (true);
+}
+
+/**
+ * @brief Stops monitoring a file descriptor.
+ *
+ * The last entry is moved into the freed slot to keep the array dense.
+ *
+ * @return true on success, false if the fd is not registered.
+ */
+bool PollBackend::remove(int fd) {
+	if (fd < 0 || (size_t)fd >= _slots.size() || _slots[fd] == -1) {
+		return (false);
+	}
+	size_t index = _slots[fd];
+	size_t last = _poll_fds.size() - 1;
+	if (index != last) {
+		_poll_fds[index] = _poll_fds[last];
+		_tags[index] = _tags[last];
+		_slots[_poll_fds[index].fd] = (int)index;
+	}
+	_poll_fds.pop_back();
+	_tags.pop_back();
+	_slots[fd] = -1;
+	return (true);
+}
+
+/**
+ * @brief Waits for events and fills `ready` with the descriptors that have any.
+ *
+ * @param ready Output vector. Cleared before being filled.
+ * @param timeout_ms Maximum wait in milliseconds, -1 to block.
+ * @return Number of ready descriptors, 0 on timeout, -1 on error (errno is kept).
+ */
+int PollBackend::wait(std::vector<t_event>& ready, int timeout_ms) {
+	ready.clear();
+	if (_poll_fds.empty()) {
+		return (poll(NULL, 0, timeout_ms));
+	}
+	int count = poll(&_poll_fds[0], _poll_fds.size(), timeout_ms);
+	if (count <= 0) {
+		return (count);
+	}
+	for (size_t i = 0; i < _poll_fds.size() && (int)ready.size() < count; ++i) {
+		short revents = _poll_fds[i].revents;
+		if (revents == 0)
+			continue;
+		t_event event;
+		event.events = 0;
+		if (revents & POLLIN)
+			event.events |= WS_EV_READ;
+		if (revents & POLLOUT)
+			event.events |= WS_EV_WRITE;
+		if (revents & POLLHUP)
+			event.events |= WS_EV_HUP;
+		if (revents & (POLLERR | POLLNVAL))
+			event.events |= WS_EV_ERROR;
+		event.tag = _tags[i];
+		_poll_fds[i].revents = 0;
+		ready.push_back(event);
+	}
+	return ((int)ready.size());
+}
+
+bool PollBackend::edge_triggered() const {
+	return (false);
+}
+
+const char* PollBackend::name() const {
+	return ("poll");
+}
@@ -0,0 +1,505 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ProcessSupervisor.cpp                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 16:20:14 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 16:20:14 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "ProcessSupervisor.hpp"
+#include <cerrno>
+#include <unistd.h>
+#include <sys/wait.h>
+#ifdef __linux__
+# include <sched.h>
+#endif
+
+/**
+ * @brief Opens every listener and prepares one slot per worker process.
+ *
+ * Binding happens here, before any worker exists, so a port in use is
+ * reported once and the server does not start.
+ *
+ * @param configs Parsed configuration. `ws_processes` tells the number of workers.
+ *        Each config receives the listener of its port (`listen_fd`).
+ * @param logger Pointer to the Logger instance.
+ *
+ * @throws Logger::NoLoggerPointer If the logger pointer is null.
+ * @throws WebServerException If configs are empty or a port can not be bound.
+ */
+ProcessSupervisor::ProcessSupervisor(std::vector<ServerConfig>& configs,
+									 const Logger* logger):
+	_configs(configs),
+	_log(logger),
+	_listeners(),
+	_slots(),
+	_retiring(),
+	_cluster(NULL),
+	_is_worker(false),
+	_stopping(0),
+	_reload(0) {
+	if (_log == NULL) {
+		throw Logger::NoLoggerPointer();
+	}
+	if (_configs.empty()) {
+		throw WebServerException("No configs available to create servers.");
+	}
+	size_t processes = _configs[0].ws_processes;
+	if (processes < 1) {
+		processes = 1;
+	}
+	open_listeners();
+	t_worker_slot empty = {-1, 0, 0, false};
+	_slots.resize(processes, empty);
+	_log->status(PS_NAME, "Listeners ready for " + int_to_string((int)processes)
+						  + " worker processes.");
+}
+
+/**
+ * @brief Stops and waits for the workers still running (master), then closes the listeners.
+ */
+ProcessSupervisor::~ProcessSupervisor() {
+	if (!_is_worker) {
+		stop();
+		while (running() > 0) {
+			int status;
+			pid_t pid = waitpid(-1, &status, 0);
+			if (pid < 0 && errno != EINTR) {
+				break ;
+			}
+			if (pid > 0) {
+				worker_ended(pid, status);
+			}
+		}
+	}
+	close_listeners();
+}
+
+/**
+ * @brief Binds one listener per configured port, and hands it to every config of that port.
+ *
+ * A listener inherited on a binary upgrade (`listen_fd` already set) is adopted
+ * instead of bound, and owned from then on.
+ *
+ * @throws WebServerException If a port can not be bound. Listeners opened are closed.
+ */
+void ProcessSupervisor::open_listeners() {
+	try {
+		for (size_t i = 0; i < _configs.size(); i++) {
+			int port = _configs[i].port;
+			if (_listeners.find(port) == _listeners.end()) {
+				if (_configs[i].listen_fd >= 0) {
+					_listeners[port] = _configs[i].listen_fd;
+				} else {
+					_listeners[port] = SocketHandler::open_listener(port, false);
+				}
+				_log->log_info(PS_NAME, "Listening on port " + int_to_string(port));
+			}
+			_configs[i].listen_fd = _listeners[port];
+		}
+	} catch (const WebServerException& e) {
+		close_listeners();
+		throw;
+	}
+}
+
+/**
+ * @brief Closes the listeners of this process.
+ */
+void ProcessSupervisor::close_listeners() {
+	for (std::map<int, int>::iterator it = _listeners.begin(); it != _listeners.end(); it++) {
+		close(it->second);
+	}
+	_listeners.clear();
+	for (size_t i = 0; i < _configs.size(); i++) {
+		_configs[i].listen_fd = -1;
+	}
+}
+
+/**
+ * @brief Starts every worker, then supervises them until the master is stopped.
+ *
+ * In the master, waits for the workers and starts again the ones that end
+ * without being asked to. A worker process returns from here too, once its
+ * cluster finished.
+ *
+ * Called again after a reload, it starts the workers of the new configuration
+ * in every free slot, then asks the ones of the previous configuration
+ * (`_retiring`) to drain.
+ *
+ * @return Exit status of the process: `0` when stopped on request, `1` when
+ *         every slot was retired (master) or the cluster failed (worker).
+ *         `PS_RELOAD` in the master after `request_reload`.
+ */
+int ProcessSupervisor::run() {
+	for (size_t i = 0; i < _slots.size() && !_stopping; i++) {
+		if (_slots[i].pid == -1 && !_slots[i].retired && spawn(i)) {
+			return (run_worker(i));
+		}
+	}
+	for (size_t i = 0; i < _retiring.size(); i++) {
+		kill(_retiring[i], SIGQUIT);
+	}
+	while (running() > 0) {
+		if (_reload && !_stopping) {
+			_reload = 0;
+			return (PS_RELOAD);
+		}
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0) {
+			if (errno == EINTR) {
+				continue ;
+			}
+			_log->log_error(PS_NAME, "Unable to wait for worker processes.");
+			break ;
+		}
+		worker_ended(pid, status);
+		for (size_t i = 0; i < _slots.size() && !_stopping; i++) {
+			if (_slots[i].pid != -1 || _slots[i].retired) {
+				continue ;
+			}
+			if (_slots[i].failed_starts > 0) {
+				usleep(PS_MIN_UPTIME_MS * 1000);
+				if (_stopping) {
+					break ;
+				}
+			}
+			if (spawn(i)) {
+				return (run_worker(i));
+			}
+		}
+	}
+	return (_stopping ? 0 : 1);
+}
+
+/**
+ * @brief Forks the worker of a slot.
+ *
+ * Signals are blocked until the pid is stored, so a `stop` arriving meanwhile
+ * reaches the new worker too.
+ *
+ * @param slot Slot to start.
+ * @return `true` in the new worker process, `false` in the master. A failed
+ *         fork retires the slot.
+ */
+bool ProcessSupervisor::spawn(size_t slot) {
+	sigset_t all;
+	sigset_t previous;
+	sigfillset(&all);
+	sigprocmask(SIG_BLOCK, &all, &previous);
+	pid_t pid = fork();
+	if (pid == 0) {
+		_is_worker = true;
+		_retiring.clear();
+		signal(SIGUSR2, SIG_IGN);
+		signal(SIGHUP, SIG_IGN);
+		sigprocmask(SIG_SETMASK, &previous, NULL);
+		return (true);
+	}
+	if (pid < 0) {
+		_slots[slot].retired = true;
+		_log->log_error(PS_NAME, "Unable to fork worker process " + int_to_string((int)slot));
+	} else {
+		_slots[slot].pid = pid;
+		_slots[slot].started = TimerWheel::now_msec();
+		_log->status(PS_NAME, "Worker process " + int_to_string((int)slot)
+							  + " started. pid: " + int_to_string((int)pid));
+	}
+	sigprocmask(SIG_SETMASK, &previous, NULL);
+	return (false);
+}
+
+/**
+ * @brief Body of a worker process: builds its cluster on the inherited listeners and runs it.
+ *
+ * @param slot Slot of the worker, used to choose its CPU.
+ * @return `0` once the cluster stopped, `1` if it failed.
+ */
+int ProcessSupervisor::run_worker(size_t slot) {
+	int status = 0;
+	pin_cpu(slot);
+	try {
+		_cluster = new ServerCluster(_configs, _log);
+		if (!_stopping) {
+			_cluster->run();
+		}
+	} catch (std::exception& e) {
+		_log->log_error(PS_NAME, "Worker process " + int_to_string((int)slot)
+								 + " failed: " + e.what());
+		status = 1;
+	}
+	ServerCluster* cluster = _cluster;
+	_cluster = NULL;
+	delete cluster;
+	return (status);
+}
+
+/**
+ * @brief Pins the calling worker process to one CPU, with `worker_cpu_affinity on`.
+ *
+ * Slot `i` takes the `i`-th CPU of the set the server may run on, modulo its
+ * size, so the pinning respects `taskset` and cgroup limits.
+ */
+void ProcessSupervisor::pin_cpu(size_t slot) {
+	if (!_configs[0].ws_cpu_affinity) {
+		return ;
+	}
+#ifdef __linux__
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) < 1) {
+		_log->log_warning(PS_NAME, "CPU set not available, worker not pinned.");
+		return ;
+	}
+	size_t target = slot % CPU_COUNT(&allowed);
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (!CPU_ISSET(cpu, &allowed) || target-- > 0) {
+			continue ;
+		}
+		cpu_set_t pinned;
+		CPU_ZERO(&pinned);
+		CPU_SET(cpu, &pinned);
+		if (sched_setaffinity(0, sizeof(pinned), &pinned) != 0) {
+			_log->log_warning(PS_NAME, "Unable to pin worker process to CPU " + int_to_string(cpu));
+		} else {
+			_log->log_info(PS_NAME, "Worker process " + int_to_string((int)slot)
+									+ " pinned to CPU " + int_to_string(cpu));
+		}
+		return ;
+	}
+#else
+	(void)slot;
+	_log->log_warning(PS_NAME, "worker_cpu_affinity is only available on Linux.");
+#endif
+}
+
+/**
+ * @brief Frees the slot of a worker that ended, and decides if it is started again.
+ *
+ * An end before `PS_MIN_UPTIME_MS` counts as a failed start; after
+ * `PS_MAX_FAILED_STARTS` of them in a row, the slot is retired. Processes
+ * that are not workers are ignored.
+ *
+ * @param pid Process that ended.
+ * @param status Status reported by `waitpid`.
+ */
+void ProcessSupervisor::worker_ended(pid_t pid, int status) {
+	for (size_t i = 0; i < _slots.size(); i++) {
+		t_worker_slot& slot = _slots[i];
+		if (slot.pid != pid) {
+			continue ;
+		}
+		slot.pid = -1;
+		std::string detail = "Worker process " + int_to_string((int)i) + " (pid "
+							 + int_to_string((int)pid) + ") ";
+		if (WIFSIGNALED(status)) {
+			detail += "killed by signal " + int_to_string(WTERMSIG(status));
+		} else {
+			detail += "exited with status " + int_to_string(WEXITSTATUS(status));
+		}
+		if (_stopping) {
+			_log->status(PS_NAME, detail + ".");
+			return ;
+		}
+		if (TimerWheel::now_msec() - slot.started < PS_MIN_UPTIME_MS) {
+			slot.failed_starts++;
+		} else {
+			slot.failed_starts = 0;
+		}
+		if (slot.failed_starts >= PS_MAX_FAILED_STARTS) {
+			slot.retired = true;
+			_log->log_error(PS_NAME, detail + ". Failed to start "
+									 + int_to_string((int)slot.failed_starts) + " times, not restarted.");
+		} else {
+			_log->log_warning(PS_NAME, detail + ". Restarting.");
+		}
+		return ;
+	}
+	for (size_t i = 0; i < _retiring.size(); i++) {
+		if (_retiring[i] == pid) {
+			sigset_t all;
+			sigset_t previous;
+			sigfillset(&all);
+			sigprocmask(SIG_BLOCK, &all, &previous);
+			_retiring.erase(_retiring.begin() + i);
+			sigprocmask(SIG_SETMASK, &previous, NULL);
+			_log->status(PS_NAME, "Worker process of the previous configuration (pid "
+								  + int_to_string((int)pid) + ") ended.");
+			return ;
+		}
+	}
+}
+
+/**
+ * @brief Worker processes currently running, the ones draining after a reload included.
+ */
+size_t ProcessSupervisor::running() const {
+	size_t count = _retiring.size();
+	for (size_t i = 0; i < _slots.size(); i++) {
+		if (_slots[i].pid > 0) {
+			count++;
+		}
+	}
+	return (count);
+}
+
+/**
+ * @brief Sends a signal to every running worker. Async-signal-safe.
+ */
+void ProcessSupervisor::signal_workers(int sig) {
+	for (size_t i = 0; i < _slots.size(); i++) {
+		if (_slots[i].pid > 0) {
+			kill(_slots[i].pid, sig);
+		}
+	}
+	for (size_t i = 0; i < _retiring.size(); i++) {
+		kill(_retiring[i], sig);
+	}
+}
+
+/**
+ * @brief Asks the master for a configuration reload: `run` returns `PS_RELOAD`. Async-signal-safe.
+ *
+ * The signal must interrupt `waitpid` (installed without `SA_RESTART`).
+ * Workers ignore it.
+ */
+void ProcessSupervisor::request_reload() {
+	if (!_is_worker) {
+		_reload = 1;
+	}
+}
+
+/**
+ * @brief Applies a configuration parsed again: listeners first, then a new generation of workers.
+ *
+ * The listeners of the ports kept are the same sockets, so no connection is
+ * refused; new ports are bound, and the ones removed are closed by the master
+ * (the previous workers keep their copy while they drain). The running
+ * workers are moved to `_retiring`: the next `run` starts their replacements
+ * first, then sends them `SIGQUIT`. A slot retired after failed starts gets
+ * a new chance.
+ *
+ * Every directive is read again by the new workers but `worker_processes`:
+ * the number of slots needs a restart.
+ *
+ * @param configs Configuration parsed again.
+ * @return `true` if applied; `false` if a new port can not be bound, and the
+ *         running configuration and workers are kept.
+ */
+bool ProcessSupervisor::reload(const std::vector<ServerConfig>& configs) {
+	std::vector<ServerConfig> next(configs);
+	if (!update_listeners(next)) {
+		return (false);
+	}
+	if (next[0].ws_processes != _configs[0].ws_processes) {
+		_log->log_warning(PS_NAME, "worker_processes needs a restart. Workers: "
+								   + int_to_string((int)_slots.size()));
+	}
+	_configs.swap(next);
+	sigset_t all;
+	sigset_t previous;
+	sigfillset(&all);
+	sigprocmask(SIG_BLOCK, &all, &previous);
+	for (size_t i = 0; i < _slots.size(); i++) {
+		if (_slots[i].pid > 0) {
+			_retiring.push_back(_slots[i].pid);
+		}
+		_slots[i].pid = -1;
+		_slots[i].failed_starts = 0;
+		_slots[i].retired = false;
+	}
+	sigprocmask(SIG_SETMASK, &previous, NULL);
+	_log->status(PS_NAME, "Configuration reloaded. Workers of the previous one draining: "
+						  + int_to_string((int)_retiring.size()));
+	return (true);
+}
+
+/**
+ * @brief Hands the listeners to a configuration parsed again, binding the new ports.
+ *
+ * @param configs Configuration parsed again. Each config receives the listener of its port.
+ * @return `false` if a port can not be bound. Nothing changed then.
+ */
+bool ProcessSupervisor::update_listeners(std::vector<ServerConfig>& configs) {
+	std::map<int, int> listeners;
+	std::map<int, int> opened;
+	for (size_t i = 0; i < configs.size(); i++) {
+		int port = configs[i].port;
+		if (listeners.find(port) == listeners.end()) {
+			std::map<int, int>::iterator running = _listeners.find(port);
+			if (running != _listeners.end()) {
+				listeners[port] = running->second;
+			} else {
+				try {
+					listeners[port] = SocketHandler::open_listener(port, false);
+				} catch (const WebServerException& e) {
+					_log->log_error(PS_NAME, "Port " + int_to_string(port) + " can not be bound: "
+											 + e.what() + " Configuration not reloaded.");
+					for (std::map<int, int>::iterator it = opened.begin(); it != opened.end(); it++) {
+						close(it->second);
+					}
+					return (false);
+				}
+				opened[port] = listeners[port];
+				_log->log_info(PS_NAME, "Listening on port " + int_to_string(port));
+			}
+		}
+		configs[i].listen_fd = listeners[port];
+	}
+	for (std::map<int, int>::iterator it = _listeners.begin(); it != _listeners.end(); it++) {
+		if (listeners.find(it->first) == listeners.end()) {
+			close(it->second);
+			_log->log_info(PS_NAME, "Port " + int_to_string(it->first) + " removed.");
+		}
+	}
+	_listeners.swap(listeners);
+	return (true);
+}
+
+/**
+ * @brief Listening sockets of the master, by port: the ones handed over on a binary upgrade.
+ *
+ * @param out Receives `port -> fd`.
+ */
+void ProcessSupervisor::listeners(std::map<int, int>& out) const {
+	out.insert(_listeners.begin(), _listeners.end());
+}
+
+/**
+ * @brief Asks the server to finish once its clients are served. Async-signal-safe.
+ *
+ * The master forwards `SIGQUIT` to its workers and stops restarting them; a
+ * worker drains its cluster (ServerCluster::drain).
+ */
+void ProcessSupervisor::drain() {
+	_stopping = 1;
+	if (_is_worker) {
+		if (_cluster != NULL) {
+			_cluster->drain();
+		}
+		return ;
+	}
+	signal_workers(SIGQUIT);
+}
+
+/**
+ * @brief Asks the server to finish. Async-signal-safe.
+ *
+ * The master forwards `SIGTERM` to its workers and stops restarting them; a
+ * worker stops its cluster.
+ */
+void ProcessSupervisor::stop() {
+	_stopping = 1;
+	if (_is_worker) {
+		if (_cluster != NULL) {
+			_cluster->stop();
+		}
+		return ;
+	}
+	signal_workers(SIGTERM);
+}
@@ -0,0 +1,266 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ServerCluster.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 13:10:44 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 13:10:44 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "ServerCluster.hpp"
+#include "http_scan.hpp"
+#include <csignal>
+
+/**
+ * @brief Builds one `ServerManager` per configured worker.
+ *
+ * Worker 0 uses the configs received; every other worker works on its own copy,
+ * taken before any `SocketHandler` post-processes them, so nothing reachable
+ * from a worker's request path is shared with another one.
+ * All listeners are bound here, before any thread starts, so a bind error is
+ * reported before the server starts serving.
+ *
+ * @param configs Parsed configuration. `ws_workers` tells the number of workers.
+ * @param logger Pointer to the Logger instance, shared by all workers.
+ *
+ * @throws Logger::NoLoggerPointer If the logger pointer is null.
+ * @throws WebServerException If configs are empty or a worker cannot be built.
+ */
+ServerCluster::ServerCluster(std::vector<ServerConfig>& configs,
+							 const Logger* logger):
+							 _log(logger),
+							 _draining(0),
+							 _stopping(0),
+							 _reload(0) {
+	if (_log == NULL) {
+		throw Logger::NoLoggerPointer();
+	}
+	if (configs.empty()) {
+		throw WebServerException("No configs available to create servers.");
+	}
+	_settings = configs[0];
+	size_t workers = configs[0].ws_workers;
+	if (workers < 1) {
+		workers = 1;
+	}
+	try {
+		for (size_t i = 1; i < workers; i++) {
+			_shards.push_back(new std::vector<ServerConfig>(configs));
+		}
+		_workers.push_back(new ServerManager(configs, _log));
+		for (size_t i = 0; i < _shards.size(); i++) {
+			_workers.push_back(new ServerManager(*_shards[i], _log));
+		}
+	} catch (std::exception& e) {
+		clear_workers();
+		throw WebServerException(std::string("Error creating workers: ") + e.what());
+	}
+	_log->status(SC_NAME, "Workers ready: " + int_to_string((int)_workers.size()));
+	_log->log_info(SC_NAME, std::string("Request scan kernel: ") + ws_scan_kernel());
+}
+
+/**
+ * @brief Stops and joins the workers still running, then releases them.
+ */
+ServerCluster::~ServerCluster() {
+	stop();
+	join_threads();
+	clear_workers();
+}
+
+/**
+ * @brief Deletes every worker and its configuration shard.
+ *
+ * Workers are deleted before their shards, as they keep references into them.
+ */
+void ServerCluster::clear_workers() {
+	for (size_t i = 0; i < _workers.size(); i++) {
+		delete _workers[i];
+	}
+	_workers.clear();
+	for (size_t i = 0; i < _shards.size(); i++) {
+		delete _shards[i];
+	}
+	_shards.clear();
+}
+
+/**
+ * @brief Thread entry point of workers 1..N-1.
+ *
+ * A worker whose loop fails releases its resources at once (`turn_off_server`)
+ * so its listening sockets are closed and the kernel stops routing new
+ * connections to it. The remaining workers keep serving.
+ *
+ * @param worker The `ServerManager` to run.
+ * @return Always NULL.
+ */
+void* ServerCluster::worker_routine(void* worker) {
+	ServerManager* manager = static_cast<ServerManager*>(worker);
+	try {
+		manager->run();
+	} catch (std::exception& e) {
+		manager->turn_off_server();
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Starts workers 1..N-1, each one on its own thread.
+ *
+ * Signals are blocked while threads are created, so they inherit a full mask
+ * and every signal is delivered to the main thread.
+ *
+ * @throws WebServerException If a thread cannot be created.
+ */
+void ServerCluster::start_threads() {
+	sigset_t all;
+	sigset_t previous;
+	sigfillset(&all);
+	pthread_sigmask(SIG_BLOCK, &all, &previous);
+	for (size_t i = 1; i < _workers.size(); i++) {
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, &ServerCluster::worker_routine, _workers[i]) != 0) {
+			pthread_sigmask(SIG_SETMASK, &previous, NULL);
+			throw WebServerException("Error creating worker thread.");
+		}
+		_threads.push_back(thread);
+	}
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+}
+
+/**
+ * @brief Waits for every worker thread to finish.
+ */
+void ServerCluster::join_threads() {
+	for (size_t i = 0; i < _threads.size(); i++) {
+		pthread_join(_threads[i], NULL);
+	}
+	_threads.clear();
+}
+
+/**
+ * @brief Runs all workers. Returns when worker 0 (main thread) finishes, or to reload.
+ *
+ * Once worker 0 returns, by `stop` or by an unrecoverable error, the rest of
+ * the workers are stopped and joined. An error of worker 0 is re-thrown after
+ * that. After a `drain`, the rest are joined without being stopped, so they
+ * finish serving their own clients.
+ *
+ * After `request_reload`, it returns `true` and every worker keeps running:
+ * the caller parses the configuration, hands it over with `reload`, and calls
+ * `run` again, which goes on with worker 0.
+ *
+ * @return `true` if it returned to reload the configuration, `false` once finished.
+ * @throws WebServerException If worker 0 ends with an unrecoverable error.
+ */
+bool ServerCluster::run() {
+	if (_threads.empty()) {
+		start_threads();
+	}
+	try {
+		_workers[0]->run();
+	} catch (std::exception& e) {
+		stop();
+		join_threads();
+		throw WebServerException(e.what());
+	}
+	if (_reload && !_stopping && !_draining) {
+		_reload = 0;
+		return (true);
+	}
+	if (!_draining) {
+		stop();
+	}
+	join_threads();
+	return (false);
+}
+
+/**
+ * @brief Asks for a configuration reload: `run` returns `true`. Async-signal-safe.
+ */
+void ServerCluster::request_reload() {
+	_reload = 1;
+	_workers[0]->interrupt();
+}
+
+/**
+ * @brief Hands a configuration parsed again to every worker.
+ *
+ * Each worker gets its own copy, as at start. Worker 0 (not running meanwhile)
+ * applies it at once, so `listeners` reports the new sockets on return; the
+ * others apply it at the start of their next loop pass
+ * (`ServerManager::post_reload`), without stopping.
+ *
+ * Directives read only when the process starts keep their running value, and
+ * a change to them is reported.
+ *
+ * @param configs Configuration parsed again.
+ */
+void ServerCluster::reload(const std::vector<ServerConfig>& configs) {
+	std::vector<ServerConfig> next(configs);
+	bool kept = false;
+	for (size_t i = 0; i < next.size(); i++) {
+		ServerConfig& config = next[i];
+		kept = kept || config.ws_workers != _settings.ws_workers
+			   || config.ws_processes != _settings.ws_processes
+			   || config.ws_cpu_affinity != _settings.ws_cpu_affinity
+			   || config.ws_event_backend != _settings.ws_event_backend
+			   || config.ws_io_threads != _settings.ws_io_threads
+			   || config.ws_file_watch != _settings.ws_file_watch;
+		config.ws_workers = _settings.ws_workers;
+		config.ws_processes = _settings.ws_processes;
+		config.ws_cpu_affinity = _settings.ws_cpu_affinity;
+		config.ws_event_backend = _settings.ws_event_backend;
+		config.ws_io_threads = _settings.ws_io_threads;
+		config.ws_file_watch = _settings.ws_file_watch;
+	}
+	if (kept) {
+		_log->log_warning(SC_NAME, "workers, worker_processes, worker_cpu_affinity, event_backend, "
+								   "io_threads and file_watch need a restart. Running values kept.");
+	}
+	_workers[0]->reload(new std::vector<ServerConfig>(next));
+	for (size_t i = 1; i < _workers.size(); i++) {
+		_workers[i]->post_reload(new std::vector<ServerConfig>(next));
+	}
+}
+
+/**
+ * @brief Asks every worker to finish. Async-signal-safe.
+ */
+void ServerCluster::stop() {
+	_stopping = 1;
+	for (size_t i = 0; i < _workers.size(); i++) {
+		_workers[i]->stop();
+	}
+}
+
+/**
+ * @brief Asks every worker to stop accepting and finish once its clients are served. Async-signal-safe.
+ *
+ * @see ServerManager::drain
+ */
+void ServerCluster::drain() {
+	_draining = 1;
+	for (size_t i = 0; i < _workers.size(); i++) {
+		_workers[i]->drain();
+	}
+}
+
+/**
+ * @brief Listening sockets of worker 0, by port: the ones handed over on a binary upgrade.
+ *
+ * @param out Receives `port -> fd`.
+ */
+void ServerCluster::listeners(std::map<int, int>& out) const {
+	_workers[0]->listeners(out);
+}
+
+/**
+ * @brief Number of workers of the cluster.
+ */
+size_t ServerCluster::size() const {
+	return (_workers.size());
+}
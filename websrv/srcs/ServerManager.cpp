@@ -26,34 +26,67 @@
  * @throws Logger::NoLoggerPointer If the logger pointer is null.
  * @throws WebServerException If no cache pointer is provided, if configs are empty, or if a SocketHandler exception is caught.
  *
- * This constructor sets up sockets for each configuration in `configs` using `add_server`.
+ * The event backend is created first, from the `event_backend` global directive (shared by
+ * every config, so the first one is used). Then it sets up sockets for each configuration in
+ * `configs` using `add_server`.
  * If any socket operation fails, it logs the error details and throws a `WebServerException`.
  * Once initialized successfully, the instance is marked as healthy and active.
  */
 ServerManager::ServerManager(std::vector<ServerConfig>& configs,
 							 const Logger* logger):
-							_log(logger) {
+							_events(NULL),
+							_log(logger),
+							_active(false),
+							_draining(false),
+							_accepting(true),
+							_healthy(false),
+							_wake_tag(EV_WAKEUP, this),
+							_watcher(logger),
+							_watch_tag(EV_WATCHER, this),
+							_io_pool(logger),
+							_io_tag(EV_IO, this),
+							_watch_ready(false),
+							_io_ready(false),
+							_interrupted(false),
+							_reload_next(NULL),
+							_reload_posted(false) {
+	_wake_pipe[0] = -1;
+	_wake_pipe[1] = -1;
+	pthread_mutex_init(&_reload_lock, NULL);
 	if (_log == NULL) {
 		throw Logger::NoLoggerPointer();
 	}
 	if (configs.empty()) {
 		throw WebServerException("No configs available to create servers.");
 	}
-	_poll_fds.reserve(2000);
+	_ready.reserve(1024);
+	_posted.reserve(64);
+	_posted_run.reserve(64);
+	_io_done.reserve(64);
 	_log->log_debug( SM_NAME,
 			  "Server Manager Instance init.");
 	std::ostringstream detail;
 	try {
+		_events = EventBackend::create(configs[0].ws_event_backend, _log);
+		_log->log_info( SM_NAME,
+				  std::string("Event backend: ") + _events->name());
+		add_wakeup_to_poll();
 		build_servers(configs);
+		start_file_watcher(configs[0].ws_file_watch);
+		start_io_pool(configs[0].ws_io_threads);
 	} catch (const WebServerException& e) {
 		detail << "Error Creating Servers: " << e.what();
 		_log->log_error( SM_NAME,
 				  detail.str());
+		clear_servers();
+		clear_poll();
 		throw WebServerException(detail.str());
 	} catch (const std::exception& e) {
 		detail << "Error Creating Servers: " << e.what();
 		_log->log_error( SM_NAME,
 		          detail.str());
+		clear_servers();
+		clear_poll();
 		throw WebServerException(detail.str());
 	}
 	_healthy = true;
@@ -67,7 +100,7 @@ ServerManager::ServerManager(std::vector<ServerConfig>& configs,
  * @brief Destructor for the ServerManager class, responsible for resource cleanup.
  *
  * This destructor ensures a proper cleanup of server resources managed by the ServerManager instance.
- * It deactivates and clears client connections, server instances, and poll file descriptors,
+ * It deactivates and clears client connections, server instances, and the event backend,
  * releasing any associated resources.
  *
  * The destructor also logs the cleanup process, marking the completion of resource cleanup for
@@ -75,6 +108,8 @@ ServerManager::ServerManager(std::vector<ServerConfig>& configs,
  */
 ServerManager::~ServerManager() {
 	turn_off_server();
+	delete _reload_next;
+	pthread_mutex_destroy(&_reload_lock);
 	_log->log_debug( SM_NAME,
 	          "Server Manager Resources Clean Up.");
 	_log->status(SM_NAME, "Server Resources Clean up.");
@@ -122,11 +157,11 @@ void ServerManager::build_servers(std::vector<ServerConfig> &configs) {
 }
 
 /**
-* @brief Adds a new server instance to the manager and its poll list.
+* @brief Adds a new server instance to the manager and its event backend.
 *
 * This method creates a new `SocketHandler` instance for the specified port and configuration
-* and adds it to the `_servers` vector. The method then attempts to add the server's
- * socket file descriptor to the poll list for monitoring. If this step fails, the server
+* and adds it to the `_servers` vector. The method then attempts to register the server's
+ * socket file descriptor in the event backend. If this step fails, the server
  * is removed from `_servers` and deleted to prevent memory leaks.
  *
  * @param port Port number for the server.
@@ -141,7 +176,7 @@ bool ServerManager::add_server(int port, ServerConfig& config) {
 	}
 	_log->log_debug( SM_NAME,
 	          "SocketHandler instance created and added to _servers.");
-	if (!add_server_to_poll(server->get_socket_fd())) {
+	if (!add_server_to_poll(server)) {
 		delete (server);
 		return (false);
 	}
@@ -151,41 +186,229 @@ bool ServerManager::add_server(int port, ServerConfig& config) {
 }
 
 /**
- * @brief Adds a server file descriptor to the poll list for monitoring.
+ * @brief Registers a listening socket in the event backend.
  *
- * This method verifies that the provided server file descriptor is valid and not
- * already present in the `_poll_fds` list. If valid, it creates a new `pollfd`
- * structure for the file descriptor, configures it to listen for incoming events,
- * and adds it to the `_poll_fds` list.
+ * The listener is registered for read readiness with its own event tag, so
+ * incoming connections are dispatched straight to the owning `SocketHandler`.
  *
- * @param server_fd The server file descriptor to be added to the poll list.
- * @return `true` if the server file descriptor was successfully added; `false` if it
- *         was invalid or already in the poll list.
- *
- * Logs an error if the file descriptor is invalid, a warning if it is already in `_poll_fds`,
- * and a debug message on successful addition.
+ * @param server The server whose listening fd has to be monitored.
+ * @return `true` if the fd was registered; `false` if it was invalid or
+ *         already registered.
  */
-bool ServerManager::add_server_to_poll(int server_fd) {
+bool ServerManager::add_server_to_poll(SocketHandler* server) {
+	int server_fd = server->get_socket_fd();
 	if (server_fd < 0) {
         _log->log_error( SM_NAME,
 			  "Invalid server file descriptor.");
         return (false);
     }
-	for (size_t i = 0; i < _poll_fds.size(); ++i) {
-		if (_poll_fds[i].fd == server_fd) {
-		  _log->log_warning( SM_NAME,
-					"Server fd already in _poll_fds.");
-		  return (false);
+	if (!_events->add(server_fd, WS_EV_READ, server->event_tag())) {
+		_log->log_warning( SM_NAME,
+				  "Server fd cannot be registered at event backend.");
+		return (false);
+	}
+	_log->log_debug( SM_NAME, "Server fd registered at event backend.");
+	return (true);
+}
+
+/**
+ * @brief Creates the wake-up pipe and registers its read end in the event backend.
+ *
+ * `stop` may be called from a signal handler or from another thread while this
+ * instance is blocked in `EventBackend::wait`. Writing a byte to the pipe makes
+ * the wait return at once, so the loop notices `_active` without depending on
+ * any wait timeout. Both ends are non-blocking and close-on-exec.
+ *
+ * @throws WebServerException If the pipe cannot be created or registered.
+ */
+void ServerManager::add_wakeup_to_poll() {
+	if (pipe(_wake_pipe) < 0) {
+		throw WebServerException("Error creating wake-up pipe.");
+	}
+	for (int i = 0; i < 2; i++) {
+		fcntl(_wake_pipe[i], F_SETFL, fcntl(_wake_pipe[i], F_GETFL, 0) | O_NONBLOCK);
+		fcntl(_wake_pipe[i], F_SETFD, FD_CLOEXEC);
+	}
+	if (!_events->add(_wake_pipe[0], WS_EV_READ, &_wake_tag)) {
+		throw WebServerException("Error registering wake-up pipe.");
+	}
+}
+
+/**
+ * @brief Makes a blocked `EventBackend::wait` return. Async-signal-safe.
+ */
+void ServerManager::wake() {
+	if (_wake_pipe[1] >= 0) {
+		ssize_t written = write(_wake_pipe[1], "", 1);
+		(void)written;
+	}
+}
+
+/**
+ * @brief Empties the wake-up pipe after it has been reported as readable.
+ */
+void ServerManager::drain_wakeup() {
+	char buffer[64];
+	while (read(_wake_pipe[0], buffer, sizeof(buffer)) > 0)
+		;
+}
+
+/**
+ * @brief Watches the trees this worker serves, and registers the watcher in the event backend.
+ *
+ * Every host root and location root of every listener is watched. The
+ * listeners get the watcher only once it is registered: until then, and when
+ * watching is off (`file_watch off`) or not available, cached entries rely on
+ * their validity time alone.
+ *
+ * @param enabled Value of the `file_watch` global directive.
+ */
+void ServerManager::start_file_watcher(bool enabled) {
+	if (!enabled || !_watcher.start()) {
+		return ;
+	}
+	for (std::map<int, SocketHandler*>::iterator it = _servers_map.begin(); it != _servers_map.end(); ++it) {
+		it->second->watch_roots(_watcher);
+	}
+	if (!_events->add(_watcher.get_fd(), WS_EV_READ, &_watch_tag)) {
+		_log->log_warning( SM_NAME,
+				  "File watcher cannot be registered at event backend.");
+		return ;
+	}
+	for (std::map<int, SocketHandler*>::iterator it = _servers_map.begin(); it != _servers_map.end(); ++it) {
+		it->second->set_watcher(&_watcher);
+	}
+	_watch_ready = true;
+	_log->log_info( SM_NAME,
+			  "Watching " + int_to_string(static_cast<int>(_watcher.size())) + " directories.");
+}
+
+/**
+ * @brief Drops the cached entries affected by the file changes the watcher reports.
+ *
+ * - Every changed path is removed from the file and open file caches of each listener.
+ * - Cached routes and misses need nothing here: the watcher renewed the
+ *   generation of their directory, and they fail their next lookup.
+ * - A reset (lost events, directory moved) empties the file and open file caches.
+ * - A CGI script created, deleted or moved (or a reset) maps the scripts of
+ *   every host again, and renews every generation, as mapped routes changed.
+ */
+void ServerManager::apply_file_changes() {
+	_file_events.clear();
+	if (!_watcher.read_events(_file_events)) {
+		return ;
+	}
+	bool reset = false;
+	bool remap = false;
+	for (size_t i = 0; i < _file_events.size(); i++) {
+		const t_file_event& event = _file_events[i];
+		if (event.change == CHANGE_RESET) {
+			reset = true;
+			continue ;
+		}
+		if (event.change == CHANGE_NAME && is_cgi(event.path)) {
+			remap = true;
+		}
+		for (std::map<int, SocketHandler*>::iterator it = _servers_map.begin(); it != _servers_map.end(); ++it) {
+			it->second->get_cache().remove(event.path);
+			it->second->get_open_files().remove(event.path);
 		}
 	}
-	struct pollfd pfd;
-	pfd.fd = server_fd;
-	pfd.events = POLLIN | POLLOUT;
-	pfd.revents = 0;
+	for (std::map<int, SocketHandler*>::iterator it = _servers_map.begin(); it != _servers_map.end(); ++it) {
+		if (reset) {
+			it->second->get_cache().clear();
+			it->second->get_open_files().clear();
+		}
+		if (reset || remap) {
+			it->second->remap_cgi();
+		}
+	}
+	if (reset || remap) {
+		_watcher.invalidate_all();
+	}
+	_log->log_debug( SM_NAME,
+			  "File changes applied: " + int_to_string(static_cast<int>(_file_events.size())));
+}
 
-	_poll_fds.push_back(pfd);
-	_log->log_debug( SM_NAME, "Server fd added to _poll_fds.");
-	return (true);
+/**
+ * @brief Starts the worker's I/O threads, and registers their notification descriptor.
+ *
+ * The listeners get the pool only once it is registered: until then, and with
+ * `io_threads 0`, response handlers run their blocking work inline.
+ *
+ * @param threads Value of the `io_threads` global directive.
+ */
+void ServerManager::start_io_pool(size_t threads) {
+	if (!_io_pool.start(threads)) {
+		return ;
+	}
+	if (!_events->add(_io_pool.get_fd(), WS_EV_READ, &_io_tag)) {
+		_log->log_warning( SM_NAME,
+				  "I/O pool cannot be registered at event backend.");
+		return ;
+	}
+	for (std::map<int, SocketHandler*>::iterator it = _servers_map.begin(); it != _servers_map.end(); ++it) {
+		it->second->set_io_pool(&_io_pool);
+	}
+	_io_ready = true;
+	_log->log_info( SM_NAME,
+			  "I/O threads: " + int_to_string(static_cast<int>(threads)));
+}
+
+/**
+ * @brief Resumes the clients whose I/O tasks completed.
+ *
+ * Each task is matched with the client that submitted it: a client removed
+ * meanwhile (timed out, peer gone), or whose descriptor now belongs to another
+ * client, is not waiting for it, and the task is just deleted. A matching
+ * client gets its response built from the task (`HttpRequestHandler::resume_request`),
+ * then written with `flush_client`, which also posts the requests pipelined
+ * behind it.
+ */
+void ServerManager::resume_clients() {
+	_io_done.clear();
+	_io_pool.collect(_io_done);
+	for (size_t i = 0; i < _io_done.size(); i++) {
+		IoTask* task = _io_done[i];
+		t_client_it it = _clients.find(task->client_fd);
+		if (it != _clients.end() && it->second->io_task() == task) {
+			ClientData* client = it->second;
+			client->resume();
+			try {
+				HttpRequestHandler request_handler(_log, client);
+				request_handler.resume_request(task);
+				if (!client->is_alive()) {
+					remove_client_from_poll(_clients.find(client->get_fd()));
+				} else {
+					flush_client(client);
+				}
+			} catch (std::exception& e) {
+				std::ostringstream detail;
+				detail << "Unknown Exception. Server Health can be compromised." << e.what()
+					   << "\n. Server is set to shut down safely.";
+				turn_off_sanity(detail.str());
+			}
+		}
+		delete task;
+	}
+	_io_done.clear();
+}
+
+/**
+ * @brief Parks a client whose response waits for an I/O task.
+ *
+ * The descriptor is watched for nothing (hang-ups are still reported), so
+ * input arriving meanwhile stays in the socket; going back to `WS_EV_READ`
+ * when the response is written reports it. The timer moves to the I/O
+ * deadline: a task stuck on a dead disk does not keep the connection forever.
+ *
+ * @param client Client with a pending `IoTask`.
+ */
+void ServerManager::suspend_client(ClientData* client) {
+	watch_client(client, 0);
+	arm_deadline(client, DEADLINE_IO);
+	_log->log_debug( SM_NAME,
+			  "Client waiting for I/O. fd: " + int_to_string(client->get_fd()));
 }
 
 /**
@@ -195,10 +418,10 @@ bool ServerManager::add_server_to_poll(int server_fd) {
 /**
  * @brief Cleans up invalid file descriptors from the poll list and associated clients.
  *
- * This method iterates through the `_poll_fds` vector, checking each file descriptor’s validity
+ * This method iterates through the `_clients` map, checking each file descriptor’s validity
  * using `fcntl`. If a file descriptor is invalid (with `errno` set to `EBADF`), it logs a warning
- * and removes the associated client and poll entry. For any other `fcntl` errors, an error message
- * is logged with the corresponding error details.
+ * and removes the associated client and its event registration. For any other `fcntl` errors, an
+ * error message is logged with the corresponding error details.
  *
  * This process helps maintain a clean and accurate poll list, removing any defunct or closed connections.
  */
@@ -210,9 +433,9 @@ void ServerManager::cleanup_invalid_fds() {
 			if (errno == EBADF) {
 				_log->log_warning( SM_NAME,
 				                   "Removing invalid file descriptor and its client.");
-				t_client_it next = it++;
-				remove_client_from_poll(it);
-				it = next;
+				t_client_it invalid = it++;
+				remove_client_from_poll(invalid);
+				continue;
 			} else {
 				std::ostringstream detail;
 				detail << "Unexpected error when checking fd." << strerror(errno);
@@ -227,67 +450,78 @@ void ServerManager::cleanup_invalid_fds() {
 }
 
 /**
- * @brief Removes clients whose connections have timed out.
- *
- * This method iterates over the `_timeout_index` map to identify clients
- * whose timestamps are earlier than or equal to the current time.
- * For each expired client, it removes the client’s file descriptor
- * from both `_clients` and the polling list.
+ * @brief Removes clients whose current deadline has passed.
  *
- * The method retrieves the current time in microseconds for precise
- * timeout calculations, and continues to remove timed-out clients until
- * it encounters a timestamp that is later than the current time or
- * exhausts the `_timeout_index`.
+ * Advances the timer wheel to the current monotonic time. Every timer that
+ * expired belongs to a client whose phase (header, body, keep-alive or send)
+ * took too long; the client is removed from `_clients` and the event backend.
  *
- * @note This function relies on `gettimeofday` to provide time
- *       in seconds and microseconds.
+ * @note Cost is proportional to the expired timers, not to the connected clients.
  */
 void ServerManager::timeout_clients() {
-	if (_clients.empty()) {
-		return;
-	}
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
-	time_t current_time = tv.tv_sec * 1000000 + tv.tv_usec;
-	t_timestamp_fd index_to;
-	while (true) {
-		index_to = _timeout_index.begin();
-		if (index_to == _timeout_index.end() || index_to->first > current_time) {
-			break;
-		}
-		int client_fd = index_to->second;
-		t_client_it it_clients = _clients.find(client_fd);
-		remove_client_from_poll(it_clients);
+	_expired.clear();
+	_timers.advance(TimerWheel::now_msec(), _expired);
+	for (size_t i = 0; i < _expired.size(); i++) {
+		ClientData* client = static_cast<ClientData*>(_expired[i]->owner);
+		_log->log_debug( SM_NAME,
+				  "Client timed out. Deadline: " + int_to_string(_expired[i]->kind));
+		remove_client_from_poll(_clients.find(client->get_fd()));
 	}
 }
 
+/**
+ * @brief Arms (or moves) a client's timer for the phase it enters.
+ *
+ * @param client Client whose deadline changes.
+ * @param kind Phase that starts now. Its span comes from `ClientData::deadline_span`.
+ */
+void ServerManager::arm_deadline(ClientData* client, t_deadline kind) {
+	t_timer_node* timer = client->timer();
+	timer->kind = kind;
+	_timers.schedule(timer, TimerWheel::now_msec() + ClientData::deadline_span(kind));
+}
+
 /**
  * @brief Starts and manages the main event loop for the server.
  *
  * This method runs the server's event loop, continuously monitoring file descriptors for
- * events using `poll()`. It handles incoming connections, client requests, and outgoing
- * responses. The loop also manages timeouts for inactive clients and ensures the server
+ * events through the configured `EventBackend`. It handles incoming connections, client
+ * requests, and outgoing responses. The loop also manages timeouts for inactive clients and ensures the server
  * remains operational unless a critical error occurs.
  *
  * @throws WebServerException If a fatal error occurs that prevents the server from continuing.
  *
  * @details
  * The main functionalities of the event loop are:
- * - **Timeout Management:** Inactive clients are detected and removed using `timeout_clients`.
- * - **Polling for Events:** The `poll()` function is used to monitor file descriptors
- *   for readiness to read (`POLLIN`) or write (`POLLOUT`).
- * - **Handling Events:**
- *   - For `POLLIN`: Accepts new connections or processes incoming client requests.
- *   - For `POLLOUT`: Sends responses to clients.
- * - **Error Handling:** Handles errors from `poll()` such as `EINTR` (interrupted by a signal)
+ * - **Timeout Management:** Each client has one timer in `_timers`, armed for the phase it is
+ *   in. The wait timeout is the time to the next expiry (or no timeout at all when no timer
+ *   is armed), and expired clients are removed by `timeout_clients` after each wake-up.
+ * - **Polling for Events:** `EventBackend::wait` reports the descriptors ready to read
+ *   (`WS_EV_READ`) or write (`WS_EV_WRITE`), each one with the tag registered for it.
+ * - **Handling Events:** The tag tells the owner of the descriptor:
+ *   - `EV_LISTENER`: Accepts every pending connection of that `SocketHandler`.
+ *   - `EV_CLIENT`: Processes the request of that `ClientData` and sends the response.
+ *   - `EV_WATCHER`: Drops the cached entries the file changes reported by `FileWatcher` affect.
+ *   - `EV_IO`: Notes that `IoTask`s completed on the I/O pool. The clients waiting for them
+ *     are resumed once the batch is dispatched (`resume_clients`): a resumed client may be
+ *     released, and an event of it later in the batch would reach a deleted `ClientData`.
+ * - **Pipelined Requests:** Clients left with buffered requests after their responses were
+ *   written are served by `serve_posted` at the end of the pass. The backend is not waited on
+ *   while any is posted.
+ * - **Error Handling:** Handles errors from the backend such as `EINTR` (interrupted by a signal)
  *   or `EBADF` (bad file descriptor), logging warnings and cleaning up resources as needed.
  * - **Graceful Shutdown:** The loop exits when `_active` is set to `false`, ensuring that
- *   resources are properly cleaned up.
+ *   resources are properly cleaned up. After a `drain`, it exits once the last client
+ *   is gone (`drain_clients`).
+ * - **Reload:** A configuration posted by another thread (`post_reload`) is applied at the
+ *   start of a pass. After `interrupt`, the loop returns at the start of a pass, leaving
+ *   everything in place for the next call.
  *
  * @note
  * - The method ensures robustness by catching and logging exceptions, and by cleaning up
  *   invalid file descriptors if detected.
- * - A short sleep (`usleep`) is included to avoid excessive CPU usage during idle periods.
+ * - There is no polling interval: the loop sleeps in the backend until an event, a deadline
+ *   or a `stop` (wake-up pipe).
  *
  */
 void ServerManager::run() {
@@ -295,14 +529,22 @@ void ServerManager::run() {
 	_healthy = true;
 	try {
 		while (_active) {
-			timeout_clients();
-			usleep(500);
-
-			int poll_count = poll(&_poll_fds[0], _poll_fds.size(), 200);
-			if (poll_count == 0) {
-				continue ;
+			if (_interrupted) {
+				_interrupted = false;
+				return ;
+			}
+			if (_reload_posted) {
+				apply_posted_reload();
 			}
-			if (poll_count < 0 && _active) {
+			int timeout = 0;
+			if (_posted.empty()) {
+				timeout = _timers.next_timeout(TimerWheel::now_msec());
+			}
+			int poll_count = _events->wait(_ready, timeout);
+			if (!_active) {
+				break ;
+			}
+			if (poll_count < 0) {
 				if (errno == EINTR) {
 					_log->log_warning( SM_NAME,
 					          "Poll interrupted by a signal, retrying.");
@@ -320,16 +562,37 @@ void ServerManager::run() {
 				}
 			}
 
-			for (size_t i = 0; i < _poll_fds.size(); ++i) {
-				if (_poll_fds[i].revents & (POLLIN | POLLOUT)) {
-					if (i < _servers_map.size()) {
-						std::map<int, SocketHandler *>::iterator server_it = _servers_map.find(_poll_fds[i].fd);
-						new_client(server_it->second);
-					} else {
-						process_request(i);
-					}
+			bool io_done = false;
+			for (size_t i = 0; i < _ready.size(); ++i) {
+				t_event_tag* tag = _ready[i].tag;
+				switch (tag->source) {
+					case EV_LISTENER:
+						accept_clients(static_cast<SocketHandler*>(tag->owner));
+						break;
+					case EV_CLIENT:
+						process_request(static_cast<ClientData*>(tag->owner), _ready[i].events);
+						break;
+					case EV_WAKEUP:
+						drain_wakeup();
+						break;
+					case EV_WATCHER:
+						apply_file_changes();
+						break;
+					case EV_IO:
+						io_done = true;
+						break;
 				}
 			}
+			if (io_done) {
+				resume_clients();
+			}
+			serve_posted();
+			timeout_clients();
+			if (_draining && drain_clients()) {
+				_log->status(SM_NAME, "Drain completed, no client left.");
+				clear_poll();
+				break ;
+			}
 		}
 	} catch (std::exception& e) {
 		std::ostringstream detail;
@@ -356,8 +619,8 @@ void ServerManager::run() {
  *
  * This method uses the `SocketHandler` instance to accept a new client connection. If the connection
  * is successfully established, a `ClientData` instance is created to manage the client’s data and
- * state. The new client’s file descriptor is then added to both `_clients` and `_poll_fds` for
- * tracking and polling purposes.
+ * state. The new client’s file descriptor is then added to `_clients` and registered in the
+ * event backend, with the client's own event tag, for read readiness.
  *
  * - Logs an error if the client file descriptor is invalid.
  * - Upon success, logs the acceptance of the new client, including the server port.
@@ -370,27 +633,42 @@ bool    ServerManager::new_client(SocketHandler *server) {
 		return (false);
 	}
 	ClientData* new_client = new ClientData(server, _log, client_fd);
+	if (!_events->add(client_fd, WS_EV_READ, new_client->event_tag())) {
+		delete new_client;
+		return (false);
+	}
 	_clients[client_fd] = new_client;
-	_poll_fds.push_back(new_client->get_fd());
-	_poll_index[client_fd] = _poll_fds.size() - 1;
-	time_t timestamp = timeout_timestamp();
-	_timeout_index[timestamp] = client_fd;
-	_index_timeout[client_fd] = timestamp;
+	arm_deadline(new_client, DEADLINE_HEADER);
 	_log->log_debug( SM_NAME,
 	          "New Client accepted on port: " + server->get_port());
 	return (true);
 }
 
 /**
- * @brief Processes a client request based on the state of the poll descriptor.
+ * @brief Accepts every pending connection of a listening socket.
+ *
+ * An edge-triggered backend reports a listener once per transition of its
+ * accept queue, so the queue must be drained until `accept` fails with
+ * EAGAIN. The level-triggered backend benefits from it as well, as a burst of
+ * connections is served in a single wake-up.
+ *
+ * @param server Listening socket reported as readable.
+ */
+void ServerManager::accept_clients(SocketHandler* server) {
+	while (_active && new_client(server))
+		;
+}
+
+/**
+ * @brief Processes a client request based on the events reported for its descriptor.
  *
  * This method is responsible for managing client interactions within the server.
  * It checks the readiness of a client socket for reading or writing, processes
  * the request using a handler, and updates the client state and server timeouts
  * accordingly. If an error occurs during processing, the server is safely shut down.
  *
- * @param poll_index [in, out] A reference to the index in the `_poll_fds` array.
- *        This index identifies the client socket to process within the poll descriptors.
+ * @param client Client owning the ready descriptor, taken from its event tag.
+ * @param events WS_EV_* flags reported by the backend.
  *
  * @return `true` if the request was successfully processed or the client connection
  *         was safely removed; otherwise, `false` if no meaningful work was performed.
@@ -402,73 +680,44 @@ bool    ServerManager::new_client(SocketHandler *server) {
  *
  * @details
  * The method performs the following steps:
- * 1. **Retrieve the Client**:
- *    - Obtains the file descriptor (fd) from `_poll_fds` at the specified `poll_index`.
- *    - Looks up the associated `ClientData` object in `_clients`.
+ * 0. **Waiting for I/O**:
+ *    - A client whose response waits for an `IoTask` is left alone, unless the peer is gone.
+ *
+ * 1. **Pending Output**:
+ *    - A client with a response still queued only waits for write readiness, which resumes
+ *      the write through `flush_client`.
  *
  * 2. **Validate Client Readiness**:
- *    - If the client's request is not ready and the poll event is only `POLLOUT`, skips processing.
+ *    - A write-only readiness with no request ready means there is nothing to do.
  *
  * 3. **Process the Request**:
- *    - Updates the client's state based on the poll events.
- *    - Uses an `HttpRequestHandler` to manage the client's request workflow.
- *
- * 4. **Handle Poll Events**:
- *    - Based on the event (`POLLIN`, `POLLOUT`, or both), adjusts the client's monitored events:
- *      - For `POLLIN`: Ensures readiness for writing if the client is alive.
- *      - For `POLLOUT`: Sets the client to monitor both reading and writing.
- *
- * 5. **Update Timeouts**:
- *    - Resets the client's timeout values in `_timeout_index` and `_index_timeout`.
+ *    - On read readiness (or hang-up/error, so `recv` reports them) the client state is set to
+ *      read and write, so the request is read and answered in the same pass (`serve_requests`).
  *
- * 6. **Error Handling**:
+ * 4. **Error Handling**:
  *    - Logs critical errors and shuts down the server safely in case of exceptions.
  */
-bool    ServerManager::process_request(size_t& poll_index) {
+bool    ServerManager::process_request(ClientData* client, int events) {
 	try {
-		int fd = _poll_fds[poll_index].fd;
-		std::map<int, ClientData*>::iterator it = _clients.find(fd);
-		if (it != _clients.end()) {
-			if (!it->second->client_request().request_ready && _poll_fds[poll_index].revents == POLLOUT) {
-				return (false);
+		if (client->io_task() != NULL) {
+			if (events & (WS_EV_HUP | WS_EV_ERROR)) {
+				remove_client_from_poll(_clients.find(client->get_fd()));
+				return (true);
 			}
-			it->second->set_state(_poll_fds[poll_index].revents);
-			HttpRequestHandler request_handler(_log, it->second);
-			request_handler.request_workflow();
-			switch (_poll_fds[poll_index].revents) {
-				case POLLIN:
-					if (!it->second->is_alive()) {
-						remove_client_from_poll(it);
-						--poll_index;
-						return (true);
-					}
-					_poll_fds[poll_index].events = POLLOUT;
-					break;
-
-				case POLLOUT:
-				case POLLIN | POLLOUT:
-				default:
-					_poll_fds[poll_index].events = POLLIN | POLLOUT;
-					if (!it->second->is_alive() || !it->second->is_active()) {
-						remove_client_from_poll(it);
-						--poll_index;
-						return (true);
-					}
-					it->second->client_request().clear_request();
+			return (false);
+		}
+		if (!client->output().empty()) {
+			if (!(events & (WS_EV_WRITE | WS_EV_HUP | WS_EV_ERROR))) {
+				return (false);
 			}
-			_poll_fds[poll_index].revents = 0;
-			time_t new_cycle = timeout_timestamp();
-			t_fd_timestamp index_timeout = _index_timeout.find(fd);
-			t_timestamp_fd timeout_index = _timeout_index.find(index_timeout->second);
-			_timeout_index.erase(timeout_index);
-			_timeout_index[new_cycle] = fd;
-			_index_timeout[fd] = new_cycle;
-			return (true);
-		} else {
-			_log->log_warning( SM_NAME,
-			          "No client was found at _client storage.");
+			return (flush_client(client));
+		}
+		if (!(events & (WS_EV_READ | WS_EV_HUP | WS_EV_ERROR))
+			&& !client->client_request().request_ready) {
 			return (false);
 		}
+		client->set_state(POLLIN | POLLOUT);
+		return (serve_requests(client));
 	} catch (WebServerException& e) {
 		std::ostringstream detail;
 		detail << "Error Building Request. Server Health can be compromised." << e.what()
@@ -488,33 +737,553 @@ bool    ServerManager::process_request(size_t& poll_index) {
 }
 
 /**
- * @brief Removes a client from the `_clients` map and `_poll_fds` vector, closes the client’s file descriptor, and deallocates client resources.
+ * @brief Answers the requests a client has sent, then writes the responses.
+ *
+ * Uses an `HttpRequestHandler` per request, response handlers only queue the response in
+ * the client's `OutputQueue`. Requests pipelined behind the first one are already in the
+ * read buffer: they are parsed from it at once (the client state drops `POLLIN`, so the
+ * socket is not read again), and their responses are queued behind the previous ones.
+ * The pass stops after SM_PIPELINE_DEPTH requests or SM_PIPELINE_BYTES queued bytes, when
+ * the connection is not kept, or when the buffer runs out of complete requests. The whole
+ * batch is then written with `flush_client`, in as few `sendmsg()` calls as it takes.
+ *
+ * - A request still being received keeps the connection, and its timer moves to the
+ *   header or body deadline the first time that phase is seen. If the read stopped
+ *   before the socket was empty (`ClientData::read_pending`), the client is posted to
+ *   `serve_posted` to read the rest: the backend will not report it again.
+ * - Clients that are not alive are removed.
+ * - A response waiting for an `IoTask` ends the pass: the client is suspended, and the
+ *   responses queued before it are written when it resumes (`resume_clients`).
+ *
+ * @param client Client with input to parse (state set by the caller).
+ * @return `true`, the event was handled.
+ */
+bool ServerManager::serve_requests(ClientData* client) {
+	size_t served = 0;
+
+	while (true) {
+		HttpRequestHandler request_handler(_log, client);
+		request_handler.request_workflow();
+		if (!client->is_alive()) {
+			remove_client_from_poll(_clients.find(client->get_fd()));
+			return (true);
+		}
+		if (client->io_task() != NULL) {
+			suspend_client(client);
+			return (true);
+		}
+		if (!client->client_request().request_ready) {
+			if (served > 0) {
+				break ;
+			}
+			t_deadline phase = DEADLINE_HEADER;
+			if (client->client_request().read_phase == READ_BODY) {
+				phase = DEADLINE_BODY;
+			}
+			if (client->deadline_kind() != phase
+				&& (phase == DEADLINE_BODY || !client->read_buffer().empty())) {
+				arm_deadline(client, phase);
+			}
+			if (client->read_pending()) {
+				_posted.push_back(client->get_fd());
+			}
+			return (true);
+		}
+		served++;
+		if (!client->is_active() || client->read_buffer().empty()
+			|| served >= SM_PIPELINE_DEPTH
+			|| client->output().pending() >= SM_PIPELINE_BYTES) {
+			break ;
+		}
+		client->client_request().clear_request();
+		client->set_state(POLLOUT);
+	}
+	return (flush_client(client));
+}
+
+/**
+ * @brief Serves the clients whose buffer still held requests after a response.
+ *
+ * An edge-triggered backend will not report those bytes again, they were already read.
+ * Clients posted by `finish_request` are served once per loop pass, after the ready
+ * descriptors, so a long pipeline does not starve the other connections. Clients removed
+ * meanwhile, or writing again, are skipped.
+ *
+ * The first request of each pass reads the socket as well: a read stops once the buffer
+ * holds more than a request can take, and the rest would not be reported again either.
+ * That is why a client whose read stopped early (`ClientData::read_pending`) is posted
+ * too, even with an empty buffer: its request is still incomplete, the bytes it needs
+ * are in the socket.
+ */
+void ServerManager::serve_posted() {
+	if (_posted.empty()) {
+		return ;
+	}
+	_posted_run.swap(_posted);
+	for (size_t i = 0; i < _posted_run.size() && _active; i++) {
+		t_client_it it = _clients.find(_posted_run[i]);
+		if (it == _clients.end() || !it->second->output().empty()
+			|| (it->second->read_buffer().empty() && !it->second->read_pending())
+			|| it->second->io_task() != NULL) {
+			continue ;
+		}
+		try {
+			it->second->set_state(POLLIN | POLLOUT);
+			serve_requests(it->second);
+		} catch (std::exception& e) {
+			std::ostringstream detail;
+			detail << "Unknown Exception. Server Health can be compromised." << e.what()
+				   << "\n. Server is set to shut down safely.";
+			turn_off_sanity(detail.str());
+		}
+	}
+	_posted_run.clear();
+}
+
+/**
+ * @brief Writes a client's queued response, without waiting for the socket.
+ *
+ * - **Done**: the request is finished (`finish_request`).
+ * - **Socket full**: the client is watched for write readiness only, and its timer
+ *   moves to the send deadline. The next write readiness calls this method again,
+ *   and the write resumes where it stopped.
+ * - **Error**: the peer is gone, the client is removed.
+ *
+ * @param client Client with a response in its `OutputQueue`.
+ * @return `true`, the event was handled.
+ */
+bool ServerManager::flush_client(ClientData* client) {
+	int fd = client->get_fd();
+	t_flush_status status = client->output().flush(fd);
+
+	if (status == FLUSH_ERROR) {
+		_log->log_debug( SM_NAME,
+				  "Client gone while sending response. fd: " + int_to_string(fd));
+		remove_client_from_poll(_clients.find(fd));
+		return (true);
+	}
+	if (status == FLUSH_PENDING) {
+		if (client->deadline_kind() != DEADLINE_SEND) {
+			watch_client(client, WS_EV_WRITE);
+			arm_deadline(client, DEADLINE_SEND);
+		}
+		return (true);
+	}
+	return (finish_request(client));
+}
+
+/**
+ * @brief Ends the requests whose responses have been fully written.
+ *
+ * Clients that did not ask for keep-alive (or whose connection cannot be reused) are
+ * removed, as are the ones with nothing buffered while the server drains. Kept clients are watched for read readiness again. An answered request is
+ * cleared for the next one; if the read buffer still holds bytes, they are the next
+ * pipelined request and the client is posted to `serve_posted`. A request already being
+ * parsed (the tail of a pipelined batch) is kept as it is, and posted if the last read
+ * left bytes in the socket (`ClientData::read_pending`).
+ *
+ * The timer moves to the keep-alive deadline, or to the header/body deadline of a
+ * request already started.
+ *
+ * @param client Client whose output queue is empty.
+ * @return `true`, the event was handled.
+ */
+bool ServerManager::finish_request(ClientData* client) {
+	if (!client->is_active() || (_draining && client->read_buffer().empty())) {
+		remove_client_from_poll(_clients.find(client->get_fd()));
+		return (true);
+	}
+	s_request& request = client->client_request();
+	bool answered = request.request_ready;
+	if (answered) {
+		request.clear_request();
+	}
+	if ((answered && !client->read_buffer().empty()) || client->read_pending()) {
+		_posted.push_back(client->get_fd());
+	}
+	watch_client(client, WS_EV_READ);
+	if (client->read_buffer().empty()) {
+		arm_deadline(client, DEADLINE_KEEPALIVE);
+	} else {
+		arm_deadline(client, request.read_phase == READ_BODY ? DEADLINE_BODY : DEADLINE_HEADER);
+	}
+	return (true);
+}
+
+/**
+ * @brief Changes the readiness a client fd is watched for, if it differs.
  *
- * This method locates the client data by its iterator `client_data` in the `_clients` map and removes it from both `_clients` and `_poll_fds`.
- * - Closes the client’s file descriptor by calling `ClientData::close_fd`.
- * - Deletes the `ClientData` instance, freeing resources.
- * - Decrements `poll_index` to maintain the correct index in `_poll_fds` after removal.
- * - Logs successful removal or an error if the client was not found.
+ * While a response is pending the client is watched for write readiness only, so a
+ * level-triggered backend does not keep reporting unread input. Going back to
+ * `WS_EV_READ` re-arms an edge-triggered backend, so input that arrived meanwhile is
+ * reported.
+ *
+ * @param client Client to update.
+ * @param events New WS_EV_* interest.
+ */
+void ServerManager::watch_client(ClientData* client, int events) {
+	if (client->interest() == events) {
+		return ;
+	}
+	if (!_events->modify(client->get_fd(), events, client->event_tag())) {
+		_log->log_warning( SM_NAME,
+				  "Unable to update client interest. fd: " + int_to_string(client->get_fd()));
+	}
+	client->set_interest(events);
+}
+
+/**
+ * @brief Removes a client from the `_clients` map and the event backend, closes the client’s file descriptor, and deallocates client resources.
+ *
+ * This method locates the client data by its iterator `client_data` in the `_clients` map and removes it from both `_clients` and the event backend.
+ * - Unregisters the descriptor before it is closed, so the backend never reports a stale tag.
+ * - Deletes the `ClientData` instance, which closes the client’s file descriptor.
+ * - Disarms the client's timer.
  *
  * @param client_data Iterator pointing to the client’s data in the `_clients` map.
  */
 void    ServerManager::remove_client_from_poll(t_client_it client_data) {
-	std::map<int, size_t>::iterator index_it = _poll_index.find(client_data->second->get_fd().fd);
-	size_t index = index_it->second;
-	std::map<int, time_t>::iterator index_to_it = _index_timeout.find(client_data->second->get_fd().fd);
-	std::map<time_t, int>::iterator to_index_it = _timeout_index.find(index_to_it->second);
-
-	if (index < _poll_fds.size() - 1) {
-		std::swap(_poll_fds[index], _poll_fds.back());
-		int swapped_fd = _poll_fds[index].fd;
-		_poll_index[swapped_fd] = index;
+	if (client_data == _clients.end()) {
+		_log->log_warning( SM_NAME,
+				  "No client was found at _client storage.");
+		return ;
 	}
-	_poll_fds.pop_back();
+	int fd = client_data->first;
+	SocketHandler* server = client_data->second->get_server();
+	_timers.cancel(client_data->second->timer());
+	_events->remove(fd);
 	delete client_data->second;
 	_clients.erase(client_data);
-	_poll_index.erase(index_it);
-	_timeout_index.erase(to_index_it);
-	_index_timeout.erase(index_to_it);
+	if (!_retired.empty()) {
+		release_retired(server);
+	}
+}
+
+/**
+ * @brief Tells whether a client is waiting for a new request, with nothing in progress.
+ */
+bool ServerManager::is_idle(ClientData* client) {
+	return (client->deadline_kind() == DEADLINE_KEEPALIVE && client->read_buffer().empty()
+			&& client->output().empty() && client->io_task() == NULL);
+}
+
+/**
+ @section Configuration Reload.
+ */
+
+/**
+ * @brief Hands a reloaded configuration to the thread running this instance.
+ *
+ * Thread-safe: the snapshot is stored under `_reload_lock` and the loop is
+ * woken up; `run` applies it (`reload`) at the start of its next pass. A
+ * snapshot not applied yet is replaced by the newer one.
+ *
+ * @param snapshot Configuration parsed again, owned by this instance from now on.
+ */
+void ServerManager::post_reload(std::vector<ServerConfig>* snapshot) {
+	pthread_mutex_lock(&_reload_lock);
+	delete _reload_next;
+	_reload_next = snapshot;
+	_reload_posted = true;
+	pthread_mutex_unlock(&_reload_lock);
+	wake();
+}
+
+/**
+ * @brief Applies the configuration posted by `post_reload`, if any.
+ */
+void ServerManager::apply_posted_reload() {
+	pthread_mutex_lock(&_reload_lock);
+	std::vector<ServerConfig>* snapshot = _reload_next;
+	_reload_next = NULL;
+	_reload_posted = false;
+	pthread_mutex_unlock(&_reload_lock);
+	if (snapshot != NULL) {
+		reload(snapshot);
+	}
+}
+
+/**
+ * @brief Swaps in a reloaded configuration. Called by the thread running this instance, between passes.
+ *
+ * The snapshot is never modified once in use (beyond the host set up every
+ * listener does), and it is compared with the running one port by port:
+ * - **Unchanged port**: every server block has the same `source`. Its
+ *   `SocketHandler`, its clients and its caches are kept as they are.
+ * - **Changed port**: a new `SocketHandler` takes over the listening socket and
+ *   the caches (`reload_port`). The running one is retired.
+ * - **New port**: it is bound (`open_port`). A port that can not be bound is
+ *   logged and left out; the rest of the configuration is applied.
+ * - **Removed port**: its connections already queued are accepted, then its
+ *   listener is closed and retired (`close_port`).
+ *
+ * Process wide directives (workers, event backend, I/O threads, file watch)
+ * are only read at start: `ServerCluster::reload` reports their changes.
+ * A draining instance ignores the reload.
+ *
+ * @param snapshot Configuration parsed again, owned by this instance from now on.
+ */
+void ServerManager::reload(std::vector<ServerConfig>* snapshot) {
+	if (_draining || _events == NULL) {
+		_log->log_warning(SM_NAME, "Draining, configuration reload ignored.");
+		delete snapshot;
+		return ;
+	}
+	_snapshots.push_back(snapshot);
+	std::map<int, std::vector<ServerConfig*> > ports;
+	for (size_t i = 0; i < snapshot->size(); i++) {
+		ports[(*snapshot)[i].port].push_back(&(*snapshot)[i]);
+	}
+	std::vector<int> removed;
+	for (std::map<int, int>::iterator it = _active_ports.begin(); it != _active_ports.end(); it++) {
+		if (ports.find(it->first) == ports.end()) {
+			removed.push_back(it->first);
+		}
+	}
+	for (size_t i = 0; i < removed.size(); i++) {
+		close_port(removed[i]);
+	}
+	for (std::map<int, std::vector<ServerConfig*> >::iterator it = ports.begin(); it != ports.end(); it++) {
+		std::map<int, int>::iterator listen_on = _active_ports.find(it->first);
+		if (listen_on == _active_ports.end()) {
+			open_port(it->second);
+		} else {
+			reload_port(listen_on->second, it->second);
+		}
+	}
+	release_snapshots();
+	_log->status(SM_NAME, "Configuration reloaded. Listeners: " + int_to_string((int)_servers_map.size())
+						  + ", retired: " + int_to_string((int)_retired.size()));
+}
+
+/**
+ * @brief Binds a port added by a reload, and sets its listener up as the others.
+ *
+ * @param hosts Server blocks of the port, in configuration order. The first one is its default.
+ */
+void ServerManager::open_port(std::vector<ServerConfig*>& hosts) {
+	int port = hosts[0]->port;
+	try {
+		if (!add_server(port, *hosts[0])) {
+			throw WebServerException("Server fd cannot be registered.");
+		}
+	} catch (const std::exception& e) {
+		_log->log_error(SM_NAME, "Port " + int_to_string(port) + " not opened: " + e.what());
+		return ;
+	}
+	SocketHandler* server = _servers_map[_active_ports[port]];
+	for (size_t i = 1; i < hosts.size(); i++) {
+		server->add_host(*hosts[i]);
+	}
+	if (_watch_ready) {
+		server->watch_roots(_watcher);
+		server->set_watcher(&_watcher);
+	}
+	if (_io_ready) {
+		server->set_io_pool(&_io_pool);
+	}
+	_log->log_info(SM_NAME, "Port " + int_to_string(port) + " added.");
+}
+
+/**
+ * @brief Replaces the listener of a port whose server blocks changed.
+ *
+ * Blocks left unchanged (same `source`) are not replaced by their new copy:
+ * the new listener serves the running object, so the routes cached for it
+ * stay valid. The new `SocketHandler` takes over the socket and the caches;
+ * the event backend reports the socket to it from now on, and the running
+ * one is retired.
+ *
+ * @param fd Listening socket of the port.
+ * @param hosts Server blocks of the port in the new configuration, default first.
+ */
+void ServerManager::reload_port(int fd, std::vector<ServerConfig*>& hosts) {
+	SocketHandler* current = _servers_map[fd];
+	const std::vector<ServerConfig*>& served = current->get_hosts();
+	std::vector<bool> reused(served.size(), false);
+	size_t unchanged = 0;
+	size_t in_place = 0;
+	for (size_t i = 0; i < hosts.size(); i++) {
+		for (size_t j = 0; j < served.size(); j++) {
+			if (!reused[j] && served[j]->source == hosts[i]->source) {
+				hosts[i] = served[j];
+				reused[j] = true;
+				unchanged++;
+				in_place += (i == j);
+				break ;
+			}
+		}
+	}
+	if (in_place == hosts.size() && hosts.size() == served.size()) {
+		return ;
+	}
+	SocketHandler* server;
+	try {
+		server = new SocketHandler(*current, hosts, _log);
+	} catch (const std::exception& e) {
+		_log->log_error(SM_NAME, "Port " + current->get_port() + " not reloaded: " + e.what());
+		return ;
+	}
+	if (!_events->modify(fd, WS_EV_READ, server->event_tag())) {
+		_log->log_warning(SM_NAME, "Unable to update listener event tag. fd: " + int_to_string(fd));
+	}
+	_servers_map[fd] = server;
+	if (_watch_ready) {
+		server->watch_roots(_watcher);
+	}
+	retire(current);
+	_log->log_info(SM_NAME, "Port " + server->get_port() + " reloaded. Unchanged hosts: "
+							+ int_to_string((int)unchanged));
+}
+
+/**
+ * @brief Stops listening on a port removed by a reload.
+ *
+ * As on a drain, the connections already queued are accepted first, so
+ * they are served rather than reset.
+ *
+ * @param port Port no longer configured.
+ */
+void ServerManager::close_port(int port) {
+	int fd = _active_ports[port];
+	SocketHandler* server = _servers_map[fd];
+	_events->remove(fd);
+	accept_clients(server);
+	server->stop_listening();
+	_servers_map.erase(fd);
+	_active_ports.erase(port);
+	retire(server);
+	_log->log_info(SM_NAME, "Port " + int_to_string(port) + " removed.");
+}
+
+/**
+ * @brief Keeps a replaced listener until its clients are served.
+ *
+ * It no longer listens, so its clients are answered with `Connection: close`
+ * (`ClientData::keep_active`), and the idle keep-alive ones are closed now:
+ * their next connection reaches the new listener. A listener with no client
+ * left is deleted at once; otherwise `remove_client_from_poll` deletes it
+ * with its last client (`release_retired`).
+ *
+ * @param server Listener no longer in `_servers_map`.
+ */
+void ServerManager::retire(SocketHandler* server) {
+	size_t clients = 0;
+	for (t_client_it it = _clients.begin(); it != _clients.end();) {
+		if (it->second->get_server() != server) {
+			it++;
+		} else if (is_idle(it->second)) {
+			t_client_it idle = it++;
+			remove_client_from_poll(idle);
+		} else {
+			clients++;
+			it++;
+		}
+	}
+	if (clients == 0) {
+		delete server;
+		return ;
+	}
+	_retired[server] = clients;
+}
+
+/**
+ * @brief Accounts for a client gone; deletes its listener if retired and now unused.
+ *
+ * The configurations no listener uses any more are released with it.
+ *
+ * @param server Listener the client was accepted on.
+ */
+void ServerManager::release_retired(SocketHandler* server) {
+	std::map<SocketHandler*, size_t>::iterator it = _retired.find(server);
+	if (it == _retired.end() || --it->second > 0) {
+		return ;
+	}
+	_retired.erase(it);
+	delete server;
+	release_snapshots();
+	_log->log_debug(SM_NAME, "Retired listener released.");
+}
+
+/**
+ * @brief Tells whether a listener, serving or retired, still uses a server block of `snapshot`.
+ */
+bool ServerManager::snapshot_in_use(const std::vector<ServerConfig>& snapshot) const {
+	std::less<const ServerConfig*> before;
+	const ServerConfig* first = &snapshot[0];
+	const ServerConfig* last = first + snapshot.size();
+	std::vector<const SocketHandler*> servers;
+	for (std::map<int, SocketHandler*>::const_iterator it = _servers_map.begin(); it != _servers_map.end(); it++) {
+		servers.push_back(it->second);
+	}
+	for (std::map<SocketHandler*, size_t>::const_iterator it = _retired.begin(); it != _retired.end(); it++) {
+		servers.push_back(it->first);
+	}
+	for (size_t i = 0; i < servers.size(); i++) {
+		const std::vector<ServerConfig*>& hosts = servers[i]->get_hosts();
+		for (size_t j = 0; j < hosts.size(); j++) {
+			if (!before(hosts[j], first) && before(hosts[j], last)) {
+				return (true);
+			}
+		}
+	}
+	return (false);
+}
+
+/**
+ * @brief Deletes the reloaded configurations no listener uses any more.
+ *
+ * The configuration the instance was built with belongs to its owner, and is
+ * never deleted here.
+ */
+void ServerManager::release_snapshots() {
+	for (size_t i = 0; i < _snapshots.size();) {
+		if (!_snapshots[i]->empty() && snapshot_in_use(*_snapshots[i])) {
+			i++;
+			continue ;
+		}
+		delete _snapshots[i];
+		_snapshots.erase(_snapshots.begin() + i);
+	}
+}
+
+/**
+ * @brief Drain step of the event loop: stops accepting once, then tells whether every client is gone.
+ *
+ * The first call removes the listeners from the event backend, accepts the
+ * connections already queued on them and closes them
+ * (`SocketHandler::stop_listening`): a socket not handed over to a new binary
+ * would reset its queue. Then it removes the idle keep-alive clients.
+ * The rest are served as usual: a new request is answered with
+ * `Connection: close`, and `finish_request` removes the client once its buffer
+ * holds no further request. Their deadlines bound the wait.
+ *
+ * Once it returns `true`, `run` releases the event backend at once: an armed
+ * io_uring poll keeps a closed listener alive, and the kernel would keep
+ * queueing connections on it until the cluster is torn down.
+ *
+ * @return `true` when no client is left and the loop can end.
+ */
+bool ServerManager::drain_clients() {
+	if (_accepting) {
+		_accepting = false;
+		for (std::map<int, SocketHandler*>::iterator it = _servers_map.begin();
+			 it != _servers_map.end(); it++) {
+			_events->remove(it->first);
+			accept_clients(it->second);
+			it->second->stop_listening();
+		}
+		for (t_client_it it = _clients.begin(); it != _clients.end();) {
+			if (is_idle(it->second)) {
+				t_client_it idle = it++;
+				remove_client_from_poll(idle);
+				continue ;
+			}
+			it++;
+		}
+		_log->status(SM_NAME, "Draining. Clients left: " + int_to_string((int)_clients.size()));
+	}
+	return (_clients.empty());
 }
 
 /**
@@ -541,10 +1310,61 @@ bool ServerManager::turn_off_sanity(const std::string &detail) {
  @section Functions to Clear resources.
  */
 
+/**
+ * @brief Asks the event loop to finish.
+ *
+ * Async-signal-safe and callable from any thread: it only clears `_active` and
+ * writes one byte to the wake-up pipe, so a blocked `run` returns right away.
+ * Resources are released later by `turn_off_server` (called by the destructor),
+ * from the thread that owns this instance.
+ */
+void ServerManager::stop() {
+	_active = false;
+	wake();
+}
+
+/**
+ * @brief Asks the event loop to stop accepting, serve the clients it has and finish.
+ *
+ * Async-signal-safe and callable from any thread, as `stop`: the work is done by
+ * `drain_clients`, on the next pass of `run`. A `stop` still ends the loop at once.
+ */
+void ServerManager::drain() {
+	_draining = true;
+	wake();
+}
+
+/**
+ * @brief Makes `run` return at the start of its next pass, without stopping anything.
+ *
+ * Async-signal-safe. Clients and listeners stay as they are, and a new call
+ * to `run` goes on serving them. `ServerCluster` uses it to reload the
+ * configuration from the thread running this instance.
+ */
+void ServerManager::interrupt() {
+	_interrupted = true;
+	wake();
+}
+
+/**
+ * @brief Listening sockets of this instance, by port.
+ *
+ * @param out Receives `port -> fd` for every socket still listening.
+ */
+void ServerManager::listeners(std::map<int, int>& out) const {
+	for (std::map<int, SocketHandler*>::const_iterator it = _servers_map.begin();
+		 it != _servers_map.end(); it++) {
+		if (it->second->is_listening()) {
+			out[it->second->get_config().port] = it->first;
+		}
+	}
+}
+
 /**
  * @brief Turn off server.
  *
- * This method is be used by signal handler.
+ * Releases clients, servers and the event backend. Used on destruction, and
+ * by a worker whose loop failed, so its listeners stop receiving connections.
  */
 void ServerManager::turn_off_server() {
 	_log->log_info( SM_NAME, "Server shutdown initiated.");
@@ -569,10 +1389,13 @@ void ServerManager::clear_clients() {
 	if (!_clients.empty()) {
 		try {
 			for (t_client_it it = _clients.begin(); it != _clients.end(); it++) {
-				ClientData* data = it->second;
-				_clients.erase(it);
-				delete data;
+				if (_events != NULL) {
+					_events->remove(it->first);
+				}
+				_timers.cancel(it->second->timer());
+				delete it->second;
 			}
+			_clients.clear();
 			_log->log_debug( SM_NAME,
 			          "ClientData Cleared.");
 		} catch (std::exception &e) {
@@ -591,16 +1414,29 @@ void ServerManager::clear_clients() {
  * to release associated resources and prevent memory leaks. Upon successful completion,
  * the method logs a message indicating that all servers were cleared.
  *
+ * Listeners retired by a reload go with them, then the configurations they used.
+ *
  * If an exception occurs during the deletion process, an error message is logged with
  * details to aid in debugging.
  */
 void ServerManager::clear_servers() {
 	try {
 		for (std::map<int, SocketHandler*>::iterator it = _servers_map.begin();it != _servers_map.end(); it++) {
+			if (_events != NULL && it->second->is_listening()) {
+				_events->remove(it->first);
+			}
 			delete it->second;
 		}
 		_servers_map.clear();
 		_active_ports.clear();
+		for (std::map<SocketHandler*, size_t>::iterator it = _retired.begin(); it != _retired.end(); it++) {
+			delete it->first;
+		}
+		_retired.clear();
+		for (size_t i = 0; i < _snapshots.size(); i++) {
+			delete _snapshots[i];
+		}
+		_snapshots.clear();
 		_log->log_debug( SM_NAME,
 						 "Servers cleared successfully.");
 	} catch (std::exception& e) {
@@ -610,48 +1446,24 @@ void ServerManager::clear_servers() {
 }
 
 /**
- * @brief Clears and closes all file descriptors in the `_poll_fds` vector.
- *
- * This method iterates through the `_poll_fds` vector, retrieving and checking each
- * file descriptor's flags to ensure validity. If the file descriptor is open and valid,
- * it closes the descriptor to release resources. Each file descriptor is then removed
- * from `_poll_fds`.
+ * @brief Releases the event backend and the wake-up pipe.
  *
- * If an exception occurs during the process, an error message is logged.
+ * Clients and servers own (and close) their descriptors, so they must be cleared
+ * before. Closing the backend just drops the kernel side of the registrations.
  */
 void ServerManager::clear_poll() {
 	try {
-		std::vector<struct pollfd>::iterator it = _poll_fds.begin();
-		while (it != _poll_fds.end()) {
-			int flags;
-			flags = fcntl(it->fd, F_GETFL);
-			if (flags != -1 && errno != EBADF) {
-				close(it->fd);
+		delete _events;
+		_events = NULL;
+		_ready.clear();
+		for (int i = 0; i < 2; i++) {
+			if (_wake_pipe[i] >= 0) {
+				close(_wake_pipe[i]);
+				_wake_pipe[i] = -1;
 			}
-			it++;
 		}
-		_poll_fds.clear();
 	} catch (std::exception& e) {
 		_log->log_error( SM_NAME,
 		          "Error clearing poll.");
 	}
 }
-
-/**
- * @brief Calculates a timeout timestamp with microsecond precision.
- *
- * This method retrieves the current time in microseconds and adds
- * a predefined client lifecycle duration to set an expiration time.
- *
- * @return The timeout timestamp in microseconds from the epoch,
- *         adjusted by CLIENT_LIFECYCLE.
- *
- * @note This function uses `gettimeofday`, which provides time
- *       in seconds and microseconds, making it suitable for precise
- *       timeout calculations.
- */
-time_t ServerManager::timeout_timestamp() {
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
-	return (tv.tv_sec * 1000000 + tv.tv_usec + CLIENT_LIFECYCLE);
-}
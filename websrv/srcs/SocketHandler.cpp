@@ -17,6 +17,8 @@
  *
  * This constructor initializes a socket, sets its options, binds it to a specific port, and sets it in listening mode.
  * Additionally, it configures the logger, manages server configurations, and performs initialization for cache instances.
+ * When the configuration carries a socket already listening (`listen_fd`, opened by the prefork master), a
+ * duplicate of it is used instead, and nothing is bound.
  *
  * @param port The port number on which the server will listen for incoming connections.
  * @param config A reference to the server configuration (ServerConfig) containing server settings.
@@ -28,13 +30,12 @@
  * @details
  * The constructor follows these steps to establish a socket:
  * 1. Checks if a valid logger pointer is provided, throws if null.
- * 2. Creates a socket using `socket()` function, throwing an exception if it fails.
- * 3. Sets the socket option `SO_REUSEADDR` to reuse local addresses.
- * 4. Binds the socket to the provided port using the `bind()` function.
- * 5. Sets the socket in listening mode to accept incoming connections.
- * 6. Sets the socket to non-blocking mode using `set_nonblocking()`.
- * 7. Logs relevant information at various stages to provide detailed flow insights.
- * 8. Maps CGI extensions (.py, .pl) to handle dynamic requests as part of initialization.
+ * 2. Opens the listening socket with `open_listener()`. With more than one worker, `SO_REUSEPORT`
+ *    is set, so every worker binds its own listener on the same port and the kernel balances
+ *    incoming connections between them. An inherited listener is duplicated (`F_DUPFD_CLOEXEC`):
+ *    every worker thread closes its own descriptor.
+ * 3. Logs relevant information at various stages to provide detailed flow insights.
+ * 4. Maps CGI extensions (.py, .pl) to handle dynamic requests as part of initialization.
  *
  * @note Throws an exception and properly closes the socket on any failure, preventing resource leaks.
  */
@@ -42,50 +43,182 @@ SocketHandler::SocketHandler(int port, ServerConfig& config, const Logger* logge
 		_socket_fd(-1),
         _config(config),
         _log(logger),
-		_cache(WebServerCache<CacheEntry>(100)),
-		_request_cache(WebServerCache<CacheRequest>(100)) {
+		_cache(WebServerCache<CacheEntry>(config.ws_file_cache_size)),
+		_request_cache(WebServerCache<CacheRequest>(WS_REQUEST_CACHE_BYTES)),
+		_missing_cache(WebServerCache<CacheMiss>(WS_NEGATIVE_CACHE_BYTES)),
+		_open_files(config.ws_open_file_cache, config.ws_file_cache_valid),
+		_watcher(NULL),
+		_io_pool(NULL),
+		_event_tag(EV_LISTENER, this) {
 	if (_log == NULL) {
 		throw Logger::NoLoggerPointer();
 	}
 	_log->log_info( SH_NAME,
 			  "Instance building start.");
-	_log->log_debug( SH_NAME,
-	          "Creating Sockets.");
-	_socket_fd = socket(AF_INET, SOCK_STREAM, 0);
-	if (_socket_fd < 0) {
+	if (config.listen_fd >= 0) {
+		_log->log_debug( SH_NAME,
+				  "Using inherited socket.");
+		_socket_fd = fcntl(config.listen_fd, F_DUPFD_CLOEXEC, 0);
+		if (_socket_fd < 0) {
+			throw WebServerException("Error duplicating inherited socket.");
+		}
+	} else {
+		_log->log_debug( SH_NAME,
+				  "Creating Sockets.");
+		_socket_fd = open_listener(port, config.ws_workers > 1);
+	}
+	_port_str = int_to_string(port);
+	_log->log_info( SH_NAME,
+					"Server listening. Port: " + int_to_string(port));
+	add_host(config);
+	_log->log_info( SH_NAME,
+	          "Instance built.");
+	_log->status(SH_NAME, "Socket Handler Instance is ready.");
+}
+
+/**
+ * @brief Builds the listener of a port again, for a reloaded configuration.
+ *
+ * The new instance takes over the listening socket of `previous`, so no
+ * connection is refused or reset, and its caches (see `adopt_caches`). Hosts
+ * are added as by the other constructor, from the new configuration.
+ * `previous` stops listening: its clients finish their request with it, with
+ * the configuration they started with, and are told to close the connection.
+ *
+ * @param previous Listener of the same port, built from the previous configuration.
+ * @param hosts Server blocks of the port in the new configuration, the default one first.
+ * @param logger A pointer to a logger instance (Logger) for logging purposes.
+ *
+ * @throws Logger::NoLoggerPointer If the provided logger pointer is null.
+ */
+SocketHandler::SocketHandler(SocketHandler& previous, const std::vector<ServerConfig*>& hosts,
+							 const Logger* logger):
+		_socket_fd(-1),
+		_config(*hosts[0]),
+		_log(logger),
+		_cache(WebServerCache<CacheEntry>(hosts[0]->ws_file_cache_size)),
+		_request_cache(WebServerCache<CacheRequest>(WS_REQUEST_CACHE_BYTES)),
+		_missing_cache(WebServerCache<CacheMiss>(WS_NEGATIVE_CACHE_BYTES)),
+		_open_files(hosts[0]->ws_open_file_cache, hosts[0]->ws_file_cache_valid),
+		_watcher(previous._watcher),
+		_io_pool(previous._io_pool),
+		_event_tag(EV_LISTENER, this) {
+	if (_log == NULL) {
+		throw Logger::NoLoggerPointer();
+	}
+	_port_str = previous._port_str;
+	for (size_t i = 0; i < hosts.size(); i++) {
+		add_host(*hosts[i]);
+	}
+	_socket_fd = previous._socket_fd;
+	previous._socket_fd = -1;
+	adopt_caches(previous);
+	_log->status(SH_NAME, "Listener of port " + _port_str + " reloaded.");
+}
+
+/**
+ * @brief Tells the route cache entries of a server block not served any more.
+ *
+ * The block is read from the key, where `HttpRequestHandler::route_key` puts
+ * its address, between the first two spaces.
+ */
+struct StaleHost {
+	const std::vector<ServerConfig*>&   hosts;
+
+	explicit StaleHost(const std::vector<ServerConfig*>& served): hosts(served) {}
+
+	template <typename T>
+	bool operator()(const std::string& key, const T&) const {
+		ServerConfig* host = NULL;
+		size_t space = key.find(' ');
+		if (space == std::string::npos || key.size() < space + 1 + sizeof(host)) {
+			return (true);
+		}
+		std::memcpy(&host, key.data() + space + 1, sizeof(host));
+		return (std::find(hosts.begin(), hosts.end(), host) == hosts.end());
+	}
+};
+
+/**
+ * @brief Moves the caches of the previous listener of the port to this one.
+ *
+ * - File and open file caches are keyed by path, whatever host asked for the
+ *   file, so they are moved as they are, unless their limits changed.
+ * - Routes and misses are keyed by server block (`route_key`). Blocks left
+ *   unchanged by the reload are the same objects (`ServerManager::reload`),
+ *   so their entries stay valid; the entries of any other block are dropped.
+ *
+ * @param previous Listener whose caches are taken. It gets empty ones.
+ */
+void SocketHandler::adopt_caches(SocketHandler& previous) {
+	if (_cache.budget() == previous._cache.budget()) {
+		_cache.swap(previous._cache);
+	}
+	if (_config.ws_open_file_cache == previous._config.ws_open_file_cache
+		&& _config.ws_file_cache_valid == previous._config.ws_file_cache_valid) {
+		_open_files.swap(previous._open_files);
+	}
+	_request_cache.swap(previous._request_cache);
+	_missing_cache.swap(previous._missing_cache);
+	StaleHost stale(_host_list);
+	size_t dropped = _request_cache.remove_if(stale) + _missing_cache.remove_if(stale);
+	_log->log_debug(SH_NAME, "Caches kept. Routes of changed hosts dropped: "
+							 + int_to_string(static_cast<int>(dropped)));
+}
+
+/**
+ * @brief Opens a non blocking, close-on-exec socket listening on a port.
+ *
+ * Used by every `SocketHandler` that does not inherit its listener, and by the
+ * prefork master (`ProcessSupervisor`), which binds once for all its workers.
+ *
+ * @param port Port to listen on, on every interface.
+ * @param reuse_port Sets `SO_REUSEPORT`, so other sockets can bind the same port.
+ * @return The listening descriptor.
+ *
+ * @throws WebServerException If any step fails. Nothing is left open then.
+ */
+int SocketHandler::open_listener(int port, bool reuse_port) {
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
 		throw WebServerException("Error Creating Socket.");
 	}
 	int opt = 1;
-	if (setsockopt(_socket_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-		close(_socket_fd);
+	if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+		close(fd);
 		throw WebServerException("Error setting socket options.");
 	}
+	if (reuse_port) {
+#ifdef SO_REUSEPORT
+		if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+			close(fd);
+			throw WebServerException("Error setting SO_REUSEPORT socket option.");
+		}
+#else
+		close(fd);
+		throw WebServerException("SO_REUSEPORT is not available. Set workers to 1.");
+#endif
+	}
 	sockaddr_in server_addr;
+	std::memset(&server_addr, 0, sizeof(server_addr));
 	server_addr.sin_family = AF_INET;
 	server_addr.sin_addr.s_addr = INADDR_ANY;
 	server_addr.sin_port = htons(port);
-	if (bind(_socket_fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-		close(_socket_fd);
+	if (bind(fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+		close(fd);
 		throw WebServerException("Error Linking Socket.");
 	}
-	_port_str = int_to_string(port);
-	_log->log_debug( SH_NAME, "Linking Socket.");
-	_log->log_debug( SH_NAME,
-			  "Socket to listening mode.");
-	if (listen(_socket_fd, SOCKET_BACKLOG_QUEUE) < 0) {
-		close_socket();
+	if (listen(fd, SOCKET_BACKLOG_QUEUE) < 0) {
+		close(fd);
 		throw WebServerException("Error Listening Socket.");
 	}
-	if (!set_nonblocking(_socket_fd)) {
-		close_socket();
+	int flags = fcntl(fd, F_GETFL, 0);
+	if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1
+		|| fcntl(fd, F_SETFD, FD_CLOEXEC) == -1) {
+		close(fd);
 		throw WebServerException("Error setting socket as non blocking.");
 	}
-	_log->log_info( SH_NAME,
-					"Server listening. Port: " + int_to_string(port));
-	add_host(config);
-	_log->log_info( SH_NAME,
-	          "Instance built.");
-	_log->status(SH_NAME, "Socket Handler Instance is ready.");
+	return (fd);
 }
 
 /**
@@ -108,35 +241,121 @@ SocketHandler::~SocketHandler() {
 /**
  * @brief Adds a host to the internal map of hosts if it doesn't already exist.
  *
- * This method takes a reference to a `ServerConfig` object and adds it to the internal map of hosts (`_hosts`) managed by `SocketHandler`.
- * If the host (identified by `server_name` in the `ServerConfig`) does not already exist in `_hosts`, it is added to the map and additional
+ * This method takes a reference to a `ServerConfig` object and adds it to the virtual host table (`_hosts`) managed by `SocketHandler`.
+ * If the host (identified by `server_name` in the `ServerConfig`) does not already exist in `_hosts`, it is added to the table and additional
  * configurations such as redirections and CGI mappings are performed.
  *
  * @param config A reference to the `ServerConfig` object representing the server configuration to be added.
  *
  * The method performs the following steps:
- * 1. Converts the `server_name` from the provided `ServerConfig` to lowercase for consistent key storage.
- * 2. Searches for the `server_name` in the `_hosts` map.
- * 3. If the host is not found (`_hosts.end()`), logs the addition of the new host, adds the configuration to the `_hosts` map, and then
- *    performs additional setup for redirections and CGI script mappings:
+ * 1. Registers the `server_name` in `_hosts`, normalized by `VirtualHostTable::normalize`. `*.domain` and `.domain`
+ *    names are registered as wildcards.
+ * 2. If the name was not taken yet, logs the addition of the new host and then
+ *    performs additional setup for routing, redirections and CGI script mappings:
+ *    - Compiles `config.location_router`, the radix trie used to match request paths to locations.
  *    - Calls `mapping_redir(config)` to handle redirection setup.
- *    - Calls `mapping_cgi_locations(config, ".py")` and `mapping_cgi_locations(config, ".pl")` to map CGI scripts for Python and Perl respectively.
+ *    - Calls `mapping_cgi(config)` to map the CGI scripts (Python and Perl) and compile the `cgi_router` of every location.
  *
- * @note This method does not add the host if it already exists in the `_hosts` map.
+ * @note This method does not add the host if it already exists in the `_hosts` table.
  *
  */
 void SocketHandler::add_host(ServerConfig &config) {
-	std::string host_name = to_lowercase(config.server_name);
-	std::map<std::string, ServerConfig*>::iterator it =  _hosts.find(host_name);
-	if (it == _hosts.end()) {
+	if (_hosts.add(config.server_name, &config)) {
 		_log->status(SH_NAME, "Append host to map.");
-		_hosts[host_name] = &config;
+		_host_list.push_back(&config);
+		config.location_router.compile(config.locations);
 		mapping_redir(config);
-		mapping_cgi_locations(config, ".py");
-		mapping_cgi_locations(config, ".pl");
+		mapping_cgi(config);
+	}
+}
+
+/**
+ * @brief Maps the CGI scripts of a host and compiles the `cgi_router` of every location.
+ *
+ * Scripts previously mapped are dropped first, so the mapping can be built again
+ * when scripts are added or removed (`remap_cgi`).
+ *
+ * @param host Host whose locations are mapped.
+ */
+void SocketHandler::mapping_cgi(ServerConfig& host) {
+	for (std::map<std::string, LocationConfig>::iterator it = host.locations.begin();
+		 it != host.locations.end(); ++it) {
+		it->second.cgi_locations.clear();
+	}
+	mapping_cgi_locations(host, ".py");
+	mapping_cgi_locations(host, ".pl");
+	for (std::map<std::string, LocationConfig>::iterator it = host.locations.begin();
+		 it != host.locations.end(); ++it) {
+		it->second.cgi_router.compile(it->second.cgi_locations);
+	}
+}
+
+/**
+ * @brief Maps the CGI scripts of every host again.
+ *
+ * Called by the event loop when `FileWatcher` reports a script created, deleted
+ * or moved. No request is in progress meanwhile: the worker runs one handler at a time.
+ */
+void SocketHandler::remap_cgi() {
+	_log->log_info(SH_NAME, "CGI scripts changed, mapping again.");
+	for (size_t i = 0; i < _host_list.size(); i++) {
+		mapping_cgi(*_host_list[i]);
+	}
+}
+
+/**
+ * @brief Watches the root of every host, and of every location, with `watcher`.
+ *
+ * @param watcher Watcher of the worker owning this socket.
+ */
+void SocketHandler::watch_roots(FileWatcher& watcher) const {
+	for (size_t i = 0; i < _host_list.size(); i++) {
+		const ServerConfig& host = *_host_list[i];
+		watcher.watch_tree(host.server_root);
+		for (std::map<std::string, LocationConfig>::const_iterator it = host.locations.begin();
+			 it != host.locations.end(); ++it) {
+			watcher.watch_tree(host.server_root + it->second.loc_root);
+		}
 	}
 }
 
+/**
+ * @brief Sets the file watcher of the worker, used to validate cached routes.
+ *
+ * @param watcher Watcher, or NULL when files are not watched.
+ */
+void SocketHandler::set_watcher(FileWatcher* watcher) {
+	_watcher = watcher;
+}
+
+/**
+ * @brief Gets the file watcher of the worker.
+ *
+ * @return The watcher, or NULL when files are not watched (cached entries then
+ *         rely on their validity time alone).
+ */
+const FileWatcher* SocketHandler::get_watcher() const {
+	return (_watcher);
+}
+
+/**
+ * @brief Sets the I/O pool of the worker, used by response handlers to offload blocking work.
+ *
+ * @param pool Pool, or NULL when blocking work runs inline (`io_threads 0`).
+ */
+void SocketHandler::set_io_pool(IoPool* pool) {
+	_io_pool = pool;
+}
+
+/**
+ * @brief Gets the I/O pool of the worker.
+ *
+ * @return The pool, or NULL when blocking work runs inline.
+ */
+IoPool* SocketHandler::get_io_pool() const {
+	return (_io_pool);
+}
+
 /**
  * @brief Closes the socket associated with the SocketHandler.
  *
@@ -155,6 +374,7 @@ void SocketHandler::close_socket() {
 		if (flags != -1 && errno != EBADF) {
 			close(_socket_fd);
 		}
+		_socket_fd = -1;
 	} catch (std::exception& e) {
 		std::ostringstream detail;
 		detail << "Error closing socket fd.: " << e.what();
@@ -163,6 +383,27 @@ void SocketHandler::close_socket() {
 	}
 }
 
+/**
+ * @brief Stops accepting connections: closes the listening socket, if still open.
+ *
+ * The instance stays alive, so the clients accepted on it keep their hosts and
+ * caches until they are served. Another process holding the same socket (after
+ * a binary upgrade) keeps accepting on it.
+ */
+void SocketHandler::stop_listening() {
+	if (_socket_fd >= 0) {
+		close_socket();
+		_log->log_info(SH_NAME, "Stopped listening on port " + _port_str);
+	}
+}
+
+/**
+ * @brief Tells whether the socket still accepts connections (see `stop_listening`).
+ */
+bool SocketHandler::is_listening() const {
+	return (_socket_fd >= 0);
+}
+
 /**
  * @brief Gets the port number as a string.
  *
@@ -179,16 +420,21 @@ std::string SocketHandler::get_port() const {
  *
  * This method accepts an incoming connection on the socket. If a client connection is accepted successfully, the client socket is set to non-blocking mode.
  * If there is an error while accepting the connection, a warning is logged.
+ * An empty backlog (EAGAIN/EWOULDBLOCK) is not an error: the listener is
+ * non-blocking, and edge-triggered backends accept until the queue is drained.
  *
- * @return The file descriptor for the accepted client connection, or -1 if an error occurs.
+ * @return The file descriptor for the accepted client connection, or -1 if an error occurs
+ *         or no connection is pending.
  */
 int SocketHandler::accept_connection() {
 	_log->log_debug( SH_NAME,
 					 "Accepting Connection.");
 	int client_fd = accept(_socket_fd, NULL, NULL);
 	if (client_fd < 0) {
-		_log->log_warning( SH_NAME,
-						   "Error accepting connection.");
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			_log->log_warning( SH_NAME,
+							   "Error accepting connection.");
+		}
 	} else {
 		set_nonblocking(client_fd);
 		_log->log_info( SH_NAME,
@@ -219,17 +465,30 @@ ServerConfig& SocketHandler::get_config() const {
 	return (_config);
 }
 
+/**
+ * @brief Gets the server blocks of this port, the default one first.
+ */
+const std::vector<ServerConfig*>& SocketHandler::get_hosts() const {
+	return (_host_list);
+}
+
+/**
+ * @brief Gets the server configuration serving a host.
+ *
+ * The host is looked up in the virtual host table: one hash probe for an
+ * exact name, then the wildcard names. A host no name covers is served by
+ * this socket's default configuration.
+ *
+ * @param host Host of the request, normalized with `VirtualHostTable::normalize`.
+ * @return Configuration serving `host`. Never NULL.
+ */
 ServerConfig* SocketHandler::get_config(const std::string &host) {
-	size_t find_host;
+	ServerConfig* config = _hosts.find(host);
 
-	for (std::map<std::string, ServerConfig*>::iterator it = _hosts.begin();
-												it != _hosts.end(); it++) {
-		find_host = host.find(it->first);
-		if (find_host != std::string::npos) {
-			return (it->second);
-		}
+	if (config == NULL) {
+		return (&_config);
 	}
-	return (&_config);
+	return (config);
 }
 
 /**
@@ -268,8 +527,8 @@ bool SocketHandler::set_nonblocking(int fd) {
 /**
  * @brief Checks if a given path belongs to a specific location.
  *
- * This method iterates over the configured locations and checks if the given path starts with any of the location keys.
- * It finds the longest matching key and compares its root with the provided location root.
+ * The location is the longest location key the path starts with, found by the host's
+ * `location_router` in O(path length). Its root is compared with the provided location root.
  *
  * @param path The path to check.
  * @param loc_root The root of the location to match.
@@ -277,19 +536,9 @@ bool SocketHandler::set_nonblocking(int fd) {
  * @return `true` if the path belongs to the specified location, `false` otherwise.
  */
 bool SocketHandler::belongs_to_location(ServerConfig& host, const std::string& path, const std::string& loc_root) {
-	std::string saved_key;
-	LocationConfig* result = NULL;
+	size_t key_length;
+	const LocationConfig* result = host.location_router.match(path, key_length);
 
-	for (std::map<std::string, LocationConfig>::iterator it = host.locations.begin();
-	     it != host.locations.end(); ++it) {
-		const std::string& key = it->first;
-		if (starts_with(path, key)) {
-			if (key.length() > saved_key.length()) {
-				result = &it->second;
-				saved_key = key;
-			}
-		}
-	}
 	if (result) {
 		return (result->loc_root == loc_root);
 	} else {
@@ -441,10 +690,44 @@ WebServerCache<CacheEntry>& SocketHandler::get_cache() {
  * @brief Gets the request cache.
  *
  * This method returns a reference to the request cache used by the SocketHandler.
- * The cache stores `CacheRequest` objects for managing requests to the server.
+ * The cache stores the routing outcome (`CacheRequest`) of GET and HEAD requests,
+ * keyed by method, server block and path.
  *
  * @return A reference to the `WebServerCache` object containing `CacheRequest` elements.
  */
 WebServerCache<CacheRequest>& SocketHandler::get_request_cache() {
 	return (_request_cache);
 }
+
+/**
+ * @brief Gets the negative cache.
+ *
+ * Paths of GET and HEAD requests found missing (`CacheMiss`), keyed like the
+ * request cache, so repeated 404s are answered without touching the file system.
+ *
+ * @return A reference to the `WebServerCache` object containing `CacheMiss` elements.
+ */
+WebServerCache<CacheMiss>& SocketHandler::get_missing_cache() {
+	return (_missing_cache);
+}
+
+/**
+ * @brief Gets the open file cache.
+ *
+ * Regular files kept open with their metadata (`OpenFile`), keyed by clean
+ * path, so static and range responses skip `open()`, `fstat()` and `close()`.
+ *
+ * @return A reference to the `OpenFileCache`.
+ */
+OpenFileCache& SocketHandler::get_open_files() {
+	return (_open_files);
+}
+
+/**
+ * @brief Gets the tag registered with the listening fd in the event backend.
+ *
+ * @return Pointer to the listener's event tag, which points back to this instance.
+ */
+t_event_tag* SocketHandler::event_tag() {
+	return (&_event_tag);
+}
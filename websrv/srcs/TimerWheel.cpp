@@ -0,0 +1,267 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 14:40:08 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 14:40:08 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "TimerWheel.hpp"
+#include <ctime>
+#include <climits>
+#include <sys/time.h>
+
+/**
+ * @brief Constructs an empty wheel, positioned at the current monotonic time.
+ *
+ * Each slot head is a sentinel node linked to itself.
+ */
+TimerWheel::TimerWheel():
+	_slots(),
+	_current(now_msec()),
+	_count(0) {
+	for (int level = 0; level < TW_LEVELS; level++) {
+		_level_count[level] = 0;
+		for (int slot = 0; slot < TW_SLOTS; slot++) {
+			_slots[level][slot].prev = &_slots[level][slot];
+			_slots[level][slot].next = &_slots[level][slot];
+		}
+	}
+}
+
+/**
+ * @brief Destructor. Detaches any timer still armed, nodes belong to their owners.
+ */
+TimerWheel::~TimerWheel() {
+	for (int level = 0; level < TW_LEVELS; level++) {
+		for (int slot = 0; slot < TW_SLOTS; slot++) {
+			t_timer_node* head = &_slots[level][slot];
+			while (!is_empty(head)) {
+				unlink(head->next);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Current monotonic time in milliseconds.
+ *
+ * Monotonic, so timeouts are not affected by wall clock changes.
+ */
+t_msec TimerWheel::now_msec() {
+	struct timespec ts;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+		return ((t_msec)ts.tv_sec * 1000 + (t_msec)ts.tv_nsec / 1000000);
+	}
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return ((t_msec)tv.tv_sec * 1000 + (t_msec)tv.tv_usec / 1000);
+}
+
+bool TimerWheel::is_empty(const t_timer_node* head) {
+	return (head->next == head);
+}
+
+/**
+ * @brief Tells if a node is currently linked in a wheel.
+ */
+bool TimerWheel::is_armed(const t_timer_node* node) {
+	return (node->next != NULL);
+}
+
+/**
+ * @brief Places a node in the slot matching its deadline. O(1).
+ *
+ * The level is the first one whose range covers the distance to the deadline;
+ * the slot is taken from the deadline's bits at that level. Deadlines beyond
+ * the last level are clamped to it, and placed again on cascade.
+ */
+void TimerWheel::link(t_timer_node* node) {
+	t_msec expires = node->expires;
+	if (expires <= _current) {
+		expires = _current + 1;
+	}
+	t_msec delta = expires - _current;
+	int level = 0;
+	while (level < TW_LEVELS - 1 && delta >= ((t_msec)1 << (TW_SLOT_BITS * (level + 1)))) {
+		level++;
+	}
+	t_msec max_delta = ((t_msec)1 << (TW_SLOT_BITS * TW_LEVELS)) - 1;
+	if (delta > max_delta) {
+		expires = _current + max_delta;
+	}
+	t_timer_node* head = &_slots[level][(expires >> (TW_SLOT_BITS * level)) & TW_SLOT_MASK];
+	node->level = level;
+	node->prev = head->prev;
+	node->next = head;
+	head->prev->next = node;
+	head->prev = node;
+	_level_count[level]++;
+	_count++;
+}
+
+/**
+ * @brief Detaches a node from its slot. O(1).
+ */
+void TimerWheel::unlink(t_timer_node* node) {
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->prev = NULL;
+	node->next = NULL;
+	_level_count[node->level]--;
+	_count--;
+}
+
+/**
+ * @brief Arms (or re-arms) a timer.
+ *
+ * @param node Timer to arm. If it was already armed, it is moved.
+ * @param expires Absolute deadline, in `now_msec` milliseconds.
+ */
+void TimerWheel::schedule(t_timer_node* node, t_msec expires) {
+	if (is_armed(node)) {
+		unlink(node);
+	}
+	node->expires = expires;
+	link(node);
+}
+
+/**
+ * @brief Disarms a timer. Harmless on a timer that is not armed.
+ */
+void TimerWheel::cancel(t_timer_node* node) {
+	if (is_armed(node)) {
+		unlink(node);
+	}
+}
+
+/**
+ * @brief Re-distributes the current slot of a level among the lower levels.
+ *
+ * Timers already due are handed to `expired` directly.
+ */
+void TimerWheel::cascade(int level, std::vector<t_timer_node*>& expired) {
+	t_timer_node* head = &_slots[level][(_current >> (TW_SLOT_BITS * level)) & TW_SLOT_MASK];
+	while (!is_empty(head)) {
+		t_timer_node* node = head->next;
+		unlink(node);
+		if (node->expires <= _current) {
+			expired.push_back(node);
+		} else {
+			link(node);
+		}
+	}
+}
+
+/**
+ * @brief Moves the wheel one millisecond forward.
+ *
+ * When the lower bits of the new time wrap around, the matching slots of the
+ * coarser levels are cascaded, highest first. Then every timer of the level 0
+ * slot is expired.
+ */
+void TimerWheel::tick(std::vector<t_timer_node*>& expired) {
+	_current++;
+	int top = 0;
+	while (top + 1 < TW_LEVELS
+		   && (_current & (((t_msec)1 << (TW_SLOT_BITS * (top + 1))) - 1)) == 0) {
+		top++;
+	}
+	for (int level = top; level > 0; level--) {
+		cascade(level, expired);
+	}
+	t_timer_node* head = &_slots[0][_current & TW_SLOT_MASK];
+	while (!is_empty(head)) {
+		t_timer_node* node = head->next;
+		unlink(node);
+		expired.push_back(node);
+	}
+}
+
+/**
+ * @brief Advances the wheel to `now` and collects the timers that expired.
+ *
+ * Stretches where the finer levels are empty are skipped up to the next
+ * boundary of the first non-empty level, so a long idle period costs a few
+ * cascades instead of one step per millisecond.
+ *
+ * @param now Current time, from `now_msec`.
+ * @param expired Output. Expired nodes are appended, already disarmed.
+ */
+void TimerWheel::advance(t_msec now, std::vector<t_timer_node*>& expired) {
+	while (_current < now) {
+		if (_count == 0) {
+			_current = now;
+			break;
+		}
+		int level = 0;
+		while (level < TW_LEVELS && _level_count[level] == 0) {
+			level++;
+		}
+		if (level > 0) {
+			t_msec span = (t_msec)1 << (TW_SLOT_BITS * level);
+			t_msec boundary = (_current | (span - 1)) + 1;
+			if (boundary > now) {
+				_current = now;
+				break;
+			}
+			_current = boundary - 1;
+		}
+		tick(expired);
+	}
+}
+
+/**
+ * @brief Milliseconds the event loop may wait before calling `advance`.
+ *
+ * A coarser timer is only placed in level 0 when its slot is cascaded, so the
+ * wait is also bounded by the next cascade of the finest level holding timers:
+ * a level 0 expiry further away never hides a coarser timer due before it.
+ *
+ * @param now Current time, from `now_msec`.
+ * @return -1 if no timer is armed (wait without timeout), otherwise the time to
+ *         the next level 0 expiry or to the next cascade, whichever comes first.
+ */
+int TimerWheel::next_timeout(t_msec now) const {
+	if (_count == 0) {
+		return (-1);
+	}
+	t_msec target = 0;
+	if (_level_count[0] > 0) {
+		for (t_msec step = 1; step <= TW_SLOTS; step++) {
+			if (!is_empty(&_slots[0][(_current + step) & TW_SLOT_MASK])) {
+				target = _current + step;
+				break;
+			}
+		}
+	}
+	int level = 1;
+	while (level < TW_LEVELS && _level_count[level] == 0) {
+		level++;
+	}
+	if (level < TW_LEVELS || target == 0) {
+		t_msec span = (t_msec)1 << (TW_SLOT_BITS * (level < TW_LEVELS ? level : TW_LEVELS - 1));
+		t_msec cascade = (_current | (span - 1)) + 1;
+		if (target == 0 || cascade < target) {
+			target = cascade;
+		}
+	}
+	if (target <= now) {
+		return (0);
+	}
+	if (target - now > (t_msec)INT_MAX) {
+		return (INT_MAX);
+	}
+	return ((int)(target - now));
+}
+
+/**
+ * @brief Number of armed timers.
+ */
+size_t TimerWheel::size() const {
+	return (_count);
+}
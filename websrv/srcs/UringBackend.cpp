@@ -0,0 +1,463 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   UringBackend.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 14:02:51 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 14:02:51 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "UringBackend.hpp"
+
+#ifdef WS_HAS_URING
+#include <unistd.h>
+#include <poll.h>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include "WebserverException.hpp"
+
+// user_data of cancellations, whose completions are dropped.
+#define UR_CANCEL_DATA (~static_cast<uint64_t>(0))
+
+/**
+ * @brief Creates the ring and maps its queues.
+ *
+ * @param log Pointer to the Logger instance.
+ * @throws Logger::NoLoggerPointer If the logger pointer is null.
+ * @throws WebServerException If io_uring is not available, or lacks a feature the
+ *         backend relies on.
+ */
+UringBackend::UringBackend(const Logger* log):
+	_ring_fd(-1),
+	_sq_map(MAP_FAILED),
+	_sq_map_size(0),
+	_cq_map(MAP_FAILED),
+	_cq_map_size(0),
+	_sqes(NULL),
+	_sqes_size(0),
+	_sq_head(NULL),
+	_sq_tail(NULL),
+	_sq_array(NULL),
+	_sq_mask(0),
+	_sq_entries(0),
+	_sq_local_tail(0),
+	_cq_head(NULL),
+	_cq_tail(NULL),
+	_cq_mask(0),
+	_cqes(NULL),
+	_log(log) {
+	if (_log == NULL) {
+		throw Logger::NoLoggerPointer();
+	}
+	struct io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+	params.flags = IORING_SETUP_CQSIZE;
+	params.cq_entries = UR_CQ_ENTRIES;
+	_ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, UR_SQ_ENTRIES, &params));
+	if (_ring_fd < 0) {
+		throw WebServerException("io_uring is not available: " + std::string(strerror(errno)));
+	}
+	if (!(params.features & IORING_FEAT_NODROP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+		close(_ring_fd);
+		throw WebServerException("io_uring lacks required features (kernel 5.11 or later).");
+	}
+	try {
+		map_rings(params);
+	} catch (const WebServerException&) {
+		unmap_rings();
+		close(_ring_fd);
+		throw;
+	}
+	_pending.reserve(UR_SQ_ENTRIES);
+	_log->log_debug(UR_NAME, "io_uring backend ready.");
+}
+
+/**
+ * @brief Destructor. Releases the ring, not the registered fds.
+ *
+ * Polls still in flight are cancelled by the kernel with the ring.
+ */
+UringBackend::~UringBackend() {
+	unmap_rings();
+	if (_ring_fd >= 0) {
+		close(_ring_fd);
+	}
+}
+
+/**
+ * @brief Maps the submission and completion queues and the submission entries.
+ *
+ * With `IORING_FEAT_SINGLE_MMAP` both queues share one mapping.
+ *
+ * @throws WebServerException If a mapping fails.
+ */
+void UringBackend::map_rings(const struct io_uring_params& params) {
+	_sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	_cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (single && _cq_map_size > _sq_map_size) {
+		_sq_map_size = _cq_map_size;
+	}
+	_sq_map = mmap(NULL, _sq_map_size, PROT_READ | PROT_WRITE,
+				   MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQ_RING);
+	if (_sq_map == MAP_FAILED) {
+		throw WebServerException("io_uring queues can not be mapped: " + std::string(strerror(errno)));
+	}
+	if (!single) {
+		_cq_map = mmap(NULL, _cq_map_size, PROT_READ | PROT_WRITE,
+					   MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_CQ_RING);
+		if (_cq_map == MAP_FAILED) {
+			throw WebServerException("io_uring queues can not be mapped: " + std::string(strerror(errno)));
+		}
+	}
+	_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	void* sqes = mmap(NULL, _sqes_size, PROT_READ | PROT_WRITE,
+					  MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED) {
+		throw WebServerException("io_uring entries can not be mapped: " + std::string(strerror(errno)));
+	}
+	_sqes = static_cast<struct io_uring_sqe*>(sqes);
+	char* sq = static_cast<char*>(_sq_map);
+	char* cq = static_cast<char*>(single ? _sq_map : _cq_map);
+	_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+	_sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	_sq_entries = params.sq_entries;
+	_sq_local_tail = *_sq_tail;
+	_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	_cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	_cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+}
+
+/**
+ * @brief Unmaps whatever `map_rings` mapped.
+ */
+void UringBackend::unmap_rings() {
+	if (_sqes != NULL) {
+		munmap(_sqes, _sqes_size);
+		_sqes = NULL;
+	}
+	if (_cq_map != MAP_FAILED) {
+		munmap(_cq_map, _cq_map_size);
+		_cq_map = MAP_FAILED;
+	}
+	if (_sq_map != MAP_FAILED) {
+		munmap(_sq_map, _sq_map_size);
+		_sq_map = MAP_FAILED;
+	}
+}
+
+/**
+ * @brief Builds the `user_data` of a poll: generation in the high half, fd in the low one.
+ */
+uint64_t UringBackend::user_data(int fd, uint32_t generation) {
+	return ((static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd));
+}
+
+/**
+ * @brief Translates WS_EV_* interest flags to poll events.
+ */
+short UringBackend::to_poll(int events) {
+	short poll_events = 0;
+	if (events & WS_EV_READ)
+		poll_events |= POLLIN;
+	if (events & WS_EV_WRITE)
+		poll_events |= POLLOUT;
+	return (poll_events);
+}
+
+/**
+ * @brief Submission entries filled but not yet taken by the kernel.
+ */
+unsigned UringBackend::unsubmitted() const {
+	return (_sq_local_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE));
+}
+
+/**
+ * @brief Takes the next free submission entry, cleared.
+ *
+ * A full queue is submitted first, without waiting.
+ *
+ * @return The entry, or NULL if the queue could not be emptied.
+ */
+struct io_uring_sqe* UringBackend::next_sqe() {
+	if (unsubmitted() >= _sq_entries && (!submit(0, 0, NULL, 0) || unsubmitted() >= _sq_entries)) {
+		_log->log_warning(UR_NAME, "io_uring submission queue is full.");
+		return (NULL);
+	}
+	unsigned index = _sq_local_tail & _sq_mask;
+	struct io_uring_sqe* sqe = &_sqes[index];
+	std::memset(sqe, 0, sizeof(*sqe));
+	_sq_array[index] = index;
+	_sq_local_tail++;
+	return (sqe);
+}
+
+/**
+ * @brief Publishes the filled entries and enters the kernel.
+ *
+ * @param min_complete Completions to wait for.
+ * @param flags `IORING_ENTER_*` flags.
+ * @param arg Extended argument (`IORING_ENTER_EXT_ARG`), or NULL.
+ * @param arg_size Size of `arg`.
+ * @return `false` on error, `errno` kept. A timeout (`ETIME`) is not an error.
+ */
+bool UringBackend::submit(unsigned min_complete, unsigned flags, void* arg, size_t arg_size) {
+	__atomic_store_n(_sq_tail, _sq_local_tail, __ATOMIC_RELEASE);
+	long result = syscall(__NR_io_uring_enter, _ring_fd, unsubmitted(),
+						  min_complete, flags, arg, arg_size);
+	if (result < 0 && errno != ETIME) {
+		return (false);
+	}
+	return (true);
+}
+
+/**
+ * @brief Marks a fd to be armed on the next `wait`, once.
+ */
+void UringBackend::queue_arm(int fd) {
+	if (!_slots[fd].queued) {
+		_slots[fd].queued = true;
+		_pending.push_back(fd);
+	}
+}
+
+/**
+ * @brief Fills one poll request for every fd waiting to be armed.
+ *
+ * Fds removed meanwhile, or already armed, are skipped.
+ *
+ * @return `false` if the submission queue could not take every request. The
+ *         fds left stay queued.
+ */
+bool UringBackend::arm_pending() {
+	size_t i = 0;
+	for (; i < _pending.size(); ++i) {
+		t_uring_slot& slot = _slots[_pending[i]];
+		if (slot.tag == NULL || slot.armed) {
+			slot.queued = false;
+			continue ;
+		}
+		struct io_uring_sqe* sqe = next_sqe();
+		if (sqe == NULL) {
+			break ;
+		}
+		sqe->opcode = IORING_OP_POLL_ADD;
+		sqe->fd = _pending[i];
+		uint32_t mask = static_cast<unsigned short>(to_poll(slot.events));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		mask = (mask << 16) | (mask >> 16);
+#endif
+		sqe->poll32_events = mask;
+		sqe->user_data = user_data(_pending[i], slot.generation);
+		slot.armed = true;
+		slot.queued = false;
+	}
+	_pending.erase(_pending.begin(), _pending.begin() + i);
+	return (_pending.empty());
+}
+
+/**
+ * @brief Cancels the poll in flight for a fd, and retires its generation.
+ *
+ * Its completion, if any, carries the old generation and is dropped.
+ *
+ * @return `false` if the cancellation could not be queued: the poll is
+ *         retired all the same, and ends with its next completion.
+ */
+bool UringBackend::cancel(int fd) {
+	t_uring_slot& slot = _slots[fd];
+	uint64_t armed = user_data(fd, slot.generation);
+	bool was_armed = slot.armed;
+	slot.armed = false;
+	slot.generation++;
+	if (!was_armed) {
+		return (true);
+	}
+	struct io_uring_sqe* sqe = next_sqe();
+	if (sqe == NULL) {
+		return (false);
+	}
+	sqe->opcode = IORING_OP_POLL_REMOVE;
+	sqe->fd = -1;
+	sqe->addr = armed;
+	sqe->user_data = UR_CANCEL_DATA;
+	return (true);
+}
+
+/**
+ * @brief Registers a file descriptor. It is armed on the next `wait`.
+ *
+ * @param fd File descriptor to monitor.
+ * @param events WS_EV_* interest flags.
+ * @param tag Owner data returned with every event of this fd.
+ * @return true on success, false if the fd is invalid or already registered.
+ */
+bool UringBackend::add(int fd, int events, t_event_tag* tag) {
+	if (fd < 0) {
+		_log->log_error(UR_NAME, "Invalid file descriptor.");
+		return (false);
+	}
+	if (static_cast<size_t>(fd) >= _slots.size()) {
+		t_uring_slot empty = {NULL, 0, 0, false, false};
+		_slots.resize(fd + 1, empty);
+	}
+	t_uring_slot& slot = _slots[fd];
+	if (slot.tag != NULL) {
+		_log->log_warning(UR_NAME, "fd already registered.");
+		return (false);
+	}
+	slot.tag = tag;
+	slot.events = events;
+	slot.armed = false;
+	queue_arm(fd);
+	return (true);
+}
+
+/**
+ * @brief Changes the interest flags and owner data of a registered fd.
+ *
+ * A poll in flight with other flags is cancelled, and the fd armed again
+ * with the new ones on the next `wait`.
+ *
+ * @return true on success, false if the fd is not registered.
+ */
+bool UringBackend::modify(int fd, int events, t_event_tag* tag) {
+	if (fd < 0 || static_cast<size_t>(fd) >= _slots.size() || _slots[fd].tag == NULL) {
+		return (false);
+	}
+	t_uring_slot& slot = _slots[fd];
+	slot.tag = tag;
+	if (slot.events == events) {
+		return (true);
+	}
+	slot.events = events;
+	if (slot.armed) {
+		cancel(fd);
+	}
+	queue_arm(fd);
+	return (true);
+}
+
+/**
+ * @brief Stops monitoring a file descriptor.
+ *
+ * The cancellation is submitted with the next `wait`; the fd may be closed
+ * right away.
+ *
+ * @return true on success, false if the fd is not registered.
+ */
+bool UringBackend::remove(int fd) {
+	if (fd < 0 || static_cast<size_t>(fd) >= _slots.size() || _slots[fd].tag == NULL) {
+		return (false);
+	}
+	cancel(fd);
+	_slots[fd].tag = NULL;
+	return (true);
+}
+
+/**
+ * @brief Moves the available completions to `ready`.
+ *
+ * Stale completions (cancelled polls, cancellations) are dropped. Every
+ * reported fd is queued to be armed again.
+ */
+void UringBackend::reap(std::vector<t_event>& ready) {
+	unsigned head = *_cq_head;
+	unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+	for (; head != tail; ++head) {
+		const struct io_uring_cqe& cqe = _cqes[head & _cq_mask];
+		if (cqe.user_data == UR_CANCEL_DATA) {
+			continue ;
+		}
+		int fd = static_cast<int>(cqe.user_data & 0xffffffffu);
+		uint32_t generation = static_cast<uint32_t>(cqe.user_data >> 32);
+		if (static_cast<size_t>(fd) >= _slots.size()) {
+			continue ;
+		}
+		t_uring_slot& slot = _slots[fd];
+		if (slot.tag == NULL || slot.generation != generation || !slot.armed) {
+			continue ;
+		}
+		slot.armed = false;
+		queue_arm(fd);
+		if (cqe.res == -ECANCELED) {
+			continue ;
+		}
+		t_event event;
+		event.events = 0;
+		if (cqe.res < 0) {
+			event.events |= WS_EV_ERROR;
+		} else {
+			if (cqe.res & POLLIN)
+				event.events |= WS_EV_READ;
+			if (cqe.res & POLLOUT)
+				event.events |= WS_EV_WRITE;
+			if (cqe.res & POLLHUP)
+				event.events |= WS_EV_HUP;
+			if (cqe.res & (POLLERR | POLLNVAL))
+				event.events |= WS_EV_ERROR;
+		}
+		event.tag = slot.tag;
+		ready.push_back(event);
+	}
+	__atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Submits the queued changes, waits for events and fills `ready` with them.
+ *
+ * Submission and wait are a single `io_uring_enter`. Completions already
+ * available are returned without waiting.
+ *
+ * @param ready Output vector. Cleared before being filled.
+ * @param timeout_ms Maximum wait in milliseconds, -1 to block.
+ * @return Number of ready descriptors, 0 on timeout, -1 on error (errno is kept).
+ */
+int UringBackend::wait(std::vector<t_event>& ready, int timeout_ms) {
+	ready.clear();
+	arm_pending();
+	bool completed = *_cq_head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+	unsigned min_complete = 0;
+	unsigned flags = IORING_ENTER_GETEVENTS;
+	struct io_uring_getevents_arg arg;
+	struct __kernel_timespec timeout;
+	void* extra = NULL;
+	size_t extra_size = 0;
+	if (!completed && timeout_ms != 0) {
+		min_complete = 1;
+		if (timeout_ms > 0) {
+			timeout.tv_sec = timeout_ms / 1000;
+			timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+			std::memset(&arg, 0, sizeof(arg));
+			arg.ts = reinterpret_cast<uintptr_t>(&timeout);
+			flags |= IORING_ENTER_EXT_ARG;
+			extra = &arg;
+			extra_size = sizeof(arg);
+		}
+	}
+	if (unsubmitted() > 0 || min_complete > 0) {
+		if (!submit(min_complete, flags, extra, extra_size)
+			&& *_cq_head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+			return (-1);
+		}
+	}
+	reap(ready);
+	return (static_cast<int>(ready.size()));
+}
+
+bool UringBackend::edge_triggered() const {
+	return (false);
+}
+
+const char* UringBackend::name() const {
+	return ("io_uring");
+}
+
+#endif
@@ -0,0 +1,232 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   VirtualHostTable.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 21:14:36 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 21:14:36 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "VirtualHostTable.hpp"
+
+/**
+ * @brief Constructs an empty table: no exact name, a trie with its root only.
+ */
+VirtualHostTable::VirtualHostTable():
+	_slots(VH_MIN_SLOTS),
+	_count(0),
+	_suffixes(1),
+	_wildcards(0) {}
+
+/**
+ * @brief Canonical form of a host name, as it is stored and looked up.
+ *
+ * Lowercase, without port and without the trailing dot of a fully qualified
+ * name. An IPv6 literal keeps its brackets: `[::1]:8080` gives `[::1]`.
+ *
+ * @param host Raw value, from a `Host` header or a `server_name` directive.
+ * @return The normalized host.
+ */
+std::string VirtualHostTable::normalize(const std::string& host) {
+	size_t end = host.size();
+	if (!host.empty() && host[0] == '[') {
+		size_t close = host.find(']');
+		if (close != std::string::npos) {
+			end = close + 1;
+		}
+	} else {
+		size_t colon = host.find(':');
+		if (colon != std::string::npos) {
+			end = colon;
+		}
+	}
+	while (end > 0 && host[end - 1] == '.') {
+		end--;
+	}
+	std::string result(host, 0, end);
+	for (size_t i = 0; i < result.size(); i++) {
+		if (result[i] >= 'A' && result[i] <= 'Z') {
+			result[i] = static_cast<char>(result[i] + ('a' - 'A'));
+		}
+	}
+	return (result);
+}
+
+/**
+ * @brief FNV-1a hash of a normalized name.
+ */
+uint32_t VirtualHostTable::hash_name(const std::string& name) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < name.size(); i++) {
+		hash ^= static_cast<unsigned char>(name[i]);
+		hash *= 16777619u;
+	}
+	return (hash);
+}
+
+/**
+ * @brief Slot holding `name`, or the empty slot where it would go.
+ *
+ * The table is never more than half full, so the probe always ends.
+ */
+size_t VirtualHostTable::probe(const std::string& name, uint32_t hash) const {
+	size_t mask = _slots.size() - 1;
+	size_t index = hash & mask;
+	while (_slots[index].config != NULL) {
+		if (_slots[index].hash == hash && _slots[index].name == name) {
+			break ;
+		}
+		index = (index + 1) & mask;
+	}
+	return (index);
+}
+
+/**
+ * @brief Doubles the exact name table and places every entry again.
+ */
+void VirtualHostTable::grow() {
+	std::vector<t_vhost_slot> previous(_slots.size() * 2);
+	previous.swap(_slots);
+	for (size_t i = 0; i < previous.size(); i++) {
+		if (previous[i].config != NULL) {
+			t_vhost_slot& slot = _slots[probe(previous[i].name, previous[i].hash)];
+			slot.hash = previous[i].hash;
+			slot.name.swap(previous[i].name);
+			slot.config = previous[i].config;
+		}
+	}
+}
+
+/**
+ * @brief Adds an exact name. Returns `false` if it is already taken.
+ */
+bool VirtualHostTable::add_exact(const std::string& name, ServerConfig* config) {
+	if ((_count + 1) * 2 > _slots.size()) {
+		grow();
+	}
+	uint32_t hash = hash_name(name);
+	t_vhost_slot& slot = _slots[probe(name, hash)];
+	if (slot.config != NULL) {
+		return (false);
+	}
+	slot.hash = hash;
+	slot.name = name;
+	slot.config = config;
+	_count++;
+	return (true);
+}
+
+/**
+ * @brief Adds a wildcard for the subdomains of `domain`. Returns `false` if it is already taken.
+ *
+ * The labels of `domain` are inserted from the right: `example.com` is the
+ * path `com` -> `example`, and the wildcard is set on its last node.
+ */
+bool VirtualHostTable::add_suffix(const std::string& domain, ServerConfig* config) {
+	size_t node = 0;
+	size_t end = domain.size();
+	while (end > 0) {
+		size_t dot = domain.rfind('.', end - 1);
+		size_t start = (dot == std::string::npos) ? 0 : dot + 1;
+		std::string label(domain, start, end - start);
+		std::map<std::string, size_t>::iterator it = _suffixes[node].children.find(label);
+		if (it == _suffixes[node].children.end()) {
+			_suffixes.push_back(t_vhost_node());
+			_suffixes[node].children[label] = _suffixes.size() - 1;
+			node = _suffixes.size() - 1;
+		} else {
+			node = it->second;
+		}
+		end = (dot == std::string::npos) ? 0 : dot;
+	}
+	if (node == 0 || _suffixes[node].wildcard != NULL) {
+		return (false);
+	}
+	_suffixes[node].wildcard = config;
+	_wildcards++;
+	return (true);
+}
+
+/**
+ * @brief Registers a server block under its `server_name`.
+ *
+ * `*.domain` adds a wildcard for the subdomains of `domain`, `.domain` adds
+ * `domain` itself and the wildcard. Any other name is exact.
+ *
+ * @param server_name Name from the configuration, normalized here.
+ * @param config Server block serving that name.
+ * @return `false` if the name (or, for `.domain`, both of its parts) was
+ *         already registered: the first server block keeps it.
+ */
+bool VirtualHostTable::add(const std::string& server_name, ServerConfig* config) {
+	std::string name = normalize(server_name);
+	if (name.size() > 2 && name[0] == '*' && name[1] == '.') {
+		return (add_suffix(name.substr(2), config));
+	}
+	if (name.size() > 1 && name[0] == '.') {
+		bool exact = add_exact(name.substr(1), config);
+		bool suffix = add_suffix(name.substr(1), config);
+		return (exact || suffix);
+	}
+	return (add_exact(name, config));
+}
+
+/**
+ * @brief Deepest wildcard covering `host`, walking its labels from the right.
+ *
+ * A node's wildcard only applies while labels are left on the left of the
+ * matched suffix: `*.example.com` serves `a.example.com`, not `example.com`.
+ */
+ServerConfig* VirtualHostTable::find_suffix(const std::string& host) const {
+	ServerConfig* best = NULL;
+	size_t node = 0;
+	size_t end = host.size();
+	while (end > 0 && !_suffixes[node].children.empty()) {
+		size_t dot = host.rfind('.', end - 1);
+		if (dot == std::string::npos) {
+			break ;
+		}
+		std::map<std::string, size_t>::const_iterator it =
+			_suffixes[node].children.find(host.substr(dot + 1, end - dot - 1));
+		if (it == _suffixes[node].children.end()) {
+			break ;
+		}
+		node = it->second;
+		if (_suffixes[node].wildcard != NULL) {
+			best = _suffixes[node].wildcard;
+		}
+		end = dot;
+	}
+	return (best);
+}
+
+/**
+ * @brief Server block serving a host.
+ *
+ * One probe of the exact table; the wildcard trie is only walked on a miss,
+ * and only if wildcards were registered.
+ *
+ * @param host Host, already normalized (see `normalize`).
+ * @return The server block, or NULL if no name covers `host`.
+ */
+ServerConfig* VirtualHostTable::find(const std::string& host) const {
+	uint32_t hash = hash_name(host);
+	const t_vhost_slot& slot = _slots[probe(host, hash)];
+	if (slot.config != NULL) {
+		return (slot.config);
+	}
+	if (_wildcards == 0) {
+		return (NULL);
+	}
+	return (find_suffix(host));
+}
+
+/**
+ * @brief Number of names registered, exact and wildcard.
+ */
+size_t VirtualHostTable::size() const {
+	return (_count + _wildcards);
+}
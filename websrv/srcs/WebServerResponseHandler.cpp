@@ -13,6 +13,7 @@
 
 
 #include "WebServerResponseHandler.hpp"
+#include <cerrno>
 
 /**
  * @brief Constructs a `WsResponseHandler` to manage web server responses.
@@ -135,7 +136,8 @@ bool WsResponseHandler::handle_get() {
  *
  * This method processes POST requests by checking if the client has write access to the location.
  * If access is allowed, it validates the payload and resets the client timeout.
- * Upon successful validation, the request body is saved to the specified path, and a success response is sent.
+ * Upon successful validation, the request body is moved to an `IoSaveFiles` task and
+ * offloaded; `resume_save` sends the response once it is written.
  * If any step fails, an error response is sent to the client.
  *
  * @returns `true` if the POST request is successfully handled and the data is saved;
@@ -152,19 +154,18 @@ bool WsResponseHandler::handle_post() {
 	if (!_request.sanity) {
 		return (send_error_response());
 	}
-	if (!save_file(_request.normalized_path, _request.body)) {
-		return (send_error_response());
-	}
-	send_response("Created", _request.normalized_path);
-	return (true);
+	IoSaveFiles* task = new IoSaveFiles();
+	task->add(_request.normalized_path, _request.body);
+	return (offload(task));
 }
 
 /**
  * @brief Handles HTTP DELETE requests by checking permissions and deleting the specified resource.
  *
  * This method processes DELETE requests by verifying that the client has sufficient permissions.
- * If permissions are adequate, it checks the existence of the resource, deletes it,
- * and sends a success response. If any step fails, an error response is sent to the client.
+ * If permissions are adequate, the existence check and the removal are offloaded as an
+ * `IoRemoveFile` task, and `resume_delete` sends the response. If any step fails, an error
+ * response is sent to the client.
  *
  * @returns `true` if the resource is successfully deleted and a success response is sent;
  *          `false` if an error occurs, such as insufficient permissions, resource not found,
@@ -177,27 +178,112 @@ bool WsResponseHandler::handle_delete() {
 		return (send_error_response());
 	}
 
-	std::string delete_path = _request.normalized_path;
+	return (offload(new IoRemoveFile(_request.normalized_path)));
+}
+
+/**
+ @section Offloaded I/O
+ */
+
+/**
+ * @brief Runs a blocking task away from the event loop, or inline.
+ *
+ * With an I/O pool, the task is submitted and the client suspended: the
+ * handler returns with nothing queued, and the event loop resumes the request
+ * when the task completes. Without a pool, or with its queue full, the task
+ * runs here and the response is built at once. Either way it is built by
+ * `resume`.
+ *
+ * @param task Task to run. Owned by the pool once submitted, deleted here otherwise.
+ * @returns `true` if the task was offloaded, or the result of `resume`.
+ */
+bool WsResponseHandler::offload(IoTask* task) {
+	IoPool* pool = _client_data->get_server()->get_io_pool();
+	if (pool != NULL && pool->submit(task)) {
+		_client_data->suspend(task);
+		_log->log_debug( RSP_NAME,
+				  "Blocking I/O offloaded.");
+		return (true);
+	}
+	task->run();
+	bool result = resume(task);
+	delete task;
+	return (result);
+}
+
+/**
+ * @brief Builds the response of a request whose `IoTask` completed.
+ *
+ * Called on the event loop, on a handler built for the same request. Derived
+ * handlers answer their own tasks and defer the rest here.
+ *
+ * @param task Completed task. Owned by the caller.
+ * @returns `true` if a response was queued without error.
+ */
+bool WsResponseHandler::resume(IoTask* task) {
+	switch (task->kind) {
+		case IO_SAVE_FILES:
+			return (resume_save(static_cast<IoSaveFiles&>(*task)));
+		case IO_REMOVE_FILE:
+			return (resume_delete(static_cast<IoRemoveFile&>(*task)));
+		default:
+			turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
+							"Unexpected I/O task for this response.");
+			return (send_error_response());
+	}
+}
+
+/**
+ * @brief Answers a POST once its body was written.
+ */
+bool WsResponseHandler::resume_save(IoSaveFiles& task) {
+	if (task.saved < task.paths.size()) {
+		save_failed(task.error);
+		return (send_error_response());
+	}
+	send_response("Created", _request.normalized_path);
+	return (true);
+}
 
-	if (!std::ifstream(delete_path.c_str()).good()) {
+/**
+ * @brief Answers a DELETE once the file was removed, dropping it from the caches.
+ */
+bool WsResponseHandler::resume_delete(IoRemoveFile& task) {
+	if (!task.found) {
 		turn_off_sanity(HTTP_NOT_FOUND,
 		                "Resource not found for deletion.");
 		return (send_error_response());
 	}
-
-	if (std::remove(delete_path.c_str()) != 0) {
+	if (task.error != 0) {
 		turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
 		                "Failed to delete the resource.");
 		return (send_error_response());
 	}
+	_client_data->get_server()->get_cache().remove(clean_path(task.path));
+	_client_data->get_server()->get_open_files().remove(clean_path(task.path));
 
 	_request.status = HTTP_NO_CONTENT;
 	_log->log_debug( RSP_NAME,
-	          "Resource deleted successfully: " + delete_path);
-	send_response("Resource Deleted.", delete_path);
+	          "Resource deleted successfully: " + task.path);
+	send_response("Resource Deleted.", task.path);
 	return (true);
 }
 
+/**
+ * @brief Sets the error status of a file that could not be written.
+ *
+ * @param error `errno` left by `IoSaveFiles`: `EEXIST` for an existing file.
+ */
+void WsResponseHandler::save_failed(int error) {
+	if (error == EEXIST) {
+		turn_off_sanity(HTTP_CONFLICT,
+		                "File already exists and cannot be overwritten.");
+	} else {
+		turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
+		                "Unable to open file to write.");
+	}
+}
+
 /**
  * @brief Validates the payload of an HTTP request to ensure it meets requirements.
  *
@@ -243,7 +329,7 @@ bool WsResponseHandler::validate_payload(){
 }
 
 /**
- @section I/O Methods: read - save file content
+ @section I/O Methods: read file content
  */
 
 /**
@@ -308,46 +394,6 @@ void WsResponseHandler::get_file_content(std::string& path) {
 	_response_data.status = true;
 }
 
-/**
- * @brief Saves the provided content to a specified file path.
- *
- * This method attempts to save the given content to a file at the specified path.
- * If the file already exists, an error response is set, as overwriting is not permitted.
- * If the file does not exist, it is created, and the content is written to it.
- * Any errors encountered during file operations will log an error, update the HTTP status,
- * and mark the request as failed.
- *
- * @param save_path The path where the content should be saved.
- * @param content The content to be written to the file.
- * @returns `true` if the file is saved successfully; `false` if an error occurs.
- */
-bool WsResponseHandler::save_file(const std::string &save_path, const std::string& content) {
-	try {
-		std::ifstream check_file(save_path.c_str());
-		if (check_file.good()) {
-			turn_off_sanity(HTTP_CONFLICT,
-			                "File already exists and cannot be overwritten.");
-			check_file.close();
-			return (false);
-		}
-		std::ofstream file(save_path.c_str());
-		if (!file.is_open()) {
-			turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-			                "Unable to open file to write.");
-			return (false);
-		}
-		file << content;
-		file.close();
-		return (true);
-	} catch (std::exception& e) {
-		std::ostringstream detail;
-		detail << "Unable to open file to write due to unexpected error: " << e.what();
-		turn_off_sanity(HTTP_INTERNAL_SERVER_ERROR,
-		                detail.str());
-		return (false);
-	}
-}
-
 /**
  @section Response Builders
  */
@@ -359,6 +405,8 @@ bool WsResponseHandler::save_file(const std::string &save_path, const std::strin
  * content type, connection type, and range support, if applicable. The method supports
  * connection keep-alive if the client is active and the request is valid (`sanity` is true).
  * For ranged responses, the `Content-Range` and `Accept-Ranges` headers are included.
+ * When the handler set validators (`_response_data.etag`), `ETag` and `Last-Modified`
+ * are included too.
  *
  * @param code HTTP status code for the response.
  * @param content_size Size of the response content in bytes.
@@ -380,12 +428,18 @@ std::string WsResponseHandler::header(int code, size_t content_size, std::string
 				<< "/" << _response_data.filesize << "\r\n"
 				<< "Accept-Ranges: bytes\r\n";
 	}
+	std::ostringstream validators;
+	if (!_response_data.etag.empty() && _request.sanity) {
+		validators << "ETag: " << _response_data.etag << "\r\n"
+				   << "Last-Modified: " << _response_data.last_modified << "\r\n";
+	}
 	header << "HTTP/1.1 " << code << " " << http_status_description((e_http_sts)code) << "\r\n"
 	       << "Host: " << _request.host << "\r\n"
 		   << "Content-Length: " << content_size << "\r\n"
 		   << "Content-Type: " <<  mime << "\r\n"
 		   << connection.str()
 		   << ranged.str()
+		   << validators.str()
 		   << "\r\n";
 	return (header.str());
 }
@@ -411,51 +465,27 @@ bool WsResponseHandler::send_response(const std::string &body, const std::string
 	}
 	_headers = header(_request.status,
 					  _response_data.content.length(), mime_type);
-	return(sender(body));
+	return(enqueue(body));
 }
 
 /**
- * @brief Sends the HTTP response to the client through the socket file descriptor.
+ * @brief Queues the HTTP response for the client, without writing to the socket.
  *
- * This function sends the complete response, including headers and body, to the client.
- * It handles partial writes and ensures that all data is sent correctly by using a loop.
- *
- * The flow of the function is as follows:
- * 1. Concatenate the response headers and body into a single response string.
- * 2. Attempt to send the response data using `send()`.
- * 3. If `send()` returns `-1`, retry sending up to a predefined maximum number of times without checking `errno`.
- * 4. Introduce a small delay between retries to avoid a busy-wait loop.
- * 5. Accumulate the number of bytes successfully sent and continue until the entire response is sent.
- * 6. If the response is sent successfully, log the details and return true. If it fails after maximum retries, return false.
+ * The headers and the body are appended to the client's `OutputQueue` as two
+ * segments, so they are not concatenated into a new string. The event loop
+ * writes them when the socket is writable, resuming partial writes, so a slow
+ * reader never blocks the server.
  *
  * @param body The body content of the HTTP response to be sent.
- * @return True if the response is sent successfully, false otherwise.
+ * @return True if the response was queued, false otherwise.
  */
-bool WsResponseHandler::sender(const std::string& body) {
-	std::string response = _headers + body;
-	int total_sent = 0;
-	int to_send = static_cast<int>(response.length());
-	int retry_count = 0;
+bool WsResponseHandler::enqueue(const std::string& body) {
 	try {
-		while (total_sent < to_send) {
-			int sent_bytes = static_cast<int>(send(_fd, response.c_str() + total_sent, to_send - total_sent, 0));
-			if (sent_bytes == -1) {
-				retry_count++;
-				if (retry_count >= WS_MAX_RETRIES) {
-					_log->log_warning( RSP_NAME,
-							  "Max retries exceeded while sending response.");
-					return false;
-				}
-				_log->log_info( RSP_NAME,
-						  "Send failed, retrying...");
-				usleep(WS_RETRY_DELAY_MICROSECONDS);
-				continue;
-			}
-			retry_count = 0;
-			total_sent += sent_bytes;
-		}
+		OutputQueue& output = _client_data->output();
+		output.enqueue_swap(_headers);
+		output.enqueue(body);
 		std::ostringstream detail;
-		detail << "Response was sent. Status: " << _request.status << " Sent: " << response.length();
+		detail << "Response queued. Status: " << _request.status << " Pending: " << output.pending();
 		_log->log_debug( RSP_NAME, detail.str());
 		return (true);
 	} catch (const std::exception& e) {
@@ -558,7 +588,7 @@ bool WsResponseHandler::send_error_response() {
 	_headers = header(_request.status,
 					  _response_data.content.length(),
 					  get_mime_type(file_path));
-	return (sender(_response_data.content));
+	return (enqueue(_response_data.content));
 }
 
 /**
@@ -588,7 +618,7 @@ bool WsResponseHandler::send_error_response() {
  *
  * 3. **Send Response**:
  *    - Sets `_headers` to the constructed redirection header.
- *    - Calls `sender()` to send the response to the client, passing an empty string as the body since there is no content.
+ *    - Calls `enqueue()` to queue the response for the client, passing an empty string as the body since there is no content.
  *
  * @note
  * - This method assumes that the redirection configuration (`_location->redirections`) is not empty. It uses `begin()` to access the first redirection entry.
@@ -604,7 +634,7 @@ bool WsResponseHandler::redirection() {
 	       << "\r\n";
 	_headers = header.str();
 
-	return (sender(""));
+	return (enqueue(""));
 }
 
 /**
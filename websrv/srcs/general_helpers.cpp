@@ -18,6 +18,7 @@
 #include <sstream>
 #include <sys/stat.h>
 #include <cstring>
+#include <ctime>
 
 /**
  * @brief Converts an integer to a string.
@@ -68,6 +69,42 @@ bool is_file(const std::string& path) {
 	return (false);
 }
 
+/**
+ * @brief Collapses repeated slashes and `.` segments of a path.
+ *
+ * Gives one spelling to the paths naming the same file (`/a//b/./c` and
+ * `/a/b/c`), so they share cache keys and match the paths `FileWatcher`
+ * reports. A trailing slash is dropped, except for the root.
+ *
+ * @param path The path to clean.
+ * @return The cleaned path.
+ */
+std::string clean_path(const std::string& path) {
+	std::string result;
+	result.reserve(path.size());
+	size_t i = 0;
+	while (i < path.size()) {
+		if (path[i] == '/') {
+			while (i < path.size() && path[i] == '/') {
+				i++;
+			}
+			if (i < path.size() && path[i] == '.'
+				&& (i + 1 == path.size() || path[i + 1] == '/')) {
+				i++;
+				continue ;
+			}
+			result += '/';
+			continue ;
+		}
+		result += path[i];
+		i++;
+	}
+	if (result.size() > 1 && result[result.size() - 1] == '/') {
+		result.erase(result.size() - 1);
+	}
+	return (result);
+}
+
 ///**
 // * @brief Converts an integer to a string.
 // *
@@ -658,3 +695,43 @@ size_t end_of_header_system(std::string& header)
 	return (pos);
 }
 
+
+/**
+ * @brief Formats a time as an HTTP date (IMF-fixdate), e.g. `Sun, 06 Nov 1994 08:49:37 GMT`.
+ *
+ * @param when Seconds since the epoch.
+ * @return The formatted date, always in GMT.
+ */
+std::string http_date(time_t when) {
+	struct tm gmt;
+	char buffer[64];
+
+	if (gmtime_r(&when, &gmt) == NULL
+		|| strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &gmt) == 0) {
+		return ("");
+	}
+	return (std::string(buffer));
+}
+
+/**
+ * @brief Parses an HTTP date in IMF-fixdate format.
+ *
+ * The obsolete RFC 850 and asctime formats are not accepted: a date that can
+ * not be parsed must be ignored by the caller, as RFC 9110 requires for
+ * conditional headers.
+ *
+ * @param date Header value.
+ * @param when Output. Seconds since the epoch.
+ * @return `true` if `date` is a valid IMF-fixdate.
+ */
+bool parse_http_date(const std::string& date, time_t& when) {
+	struct tm gmt;
+
+	std::memset(&gmt, 0, sizeof(gmt));
+	const char* end = strptime(date.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+	if (end == NULL || *end != '\0') {
+		return (false);
+	}
+	when = timegm(&gmt);
+	return (when != (time_t)-1);
+}
@@ -0,0 +1,241 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   http_scan.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 21:02:47 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 21:02:47 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "http_scan.hpp"
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+# define WS_SCAN_X86 1
+# include <immintrin.h>
+#endif
+
+/**
+ * @brief Delimiter scanning kernels for the request parser.
+ *
+ * `ws_scan` returns the first byte of a buffer equal to any byte of a
+ * `t_scan_set`, `ws_find_header_end` the first "\r\n\r\n". Three kernels
+ * implement them, the best one the CPU supports is chosen once, at program
+ * start:
+ * - `avx2`: 32 bytes per step (x86, when the CPU reports AVX2).
+ * - `sse2`: 16 bytes per step (every x86_64 CPU).
+ * - `scalar`: one byte per step, everywhere else.
+ *
+ * The vector kernels compare a block with the four delimiters, merge the
+ * results into a bit mask and take its lowest set bit, so the cost per byte
+ * does not depend on how many delimiters are searched. The header delimiter
+ * is matched the same way, with the block loaded at four consecutive offsets
+ * and compared with '\r', '\n', '\r', '\n'.
+ */
+
+typedef size_t (*t_scan_fn)(const char*, size_t, const t_scan_set&);
+typedef size_t (*t_crlf_fn)(const char*, size_t);
+
+static size_t scan_scalar(const char* data, size_t length, const t_scan_set& set) {
+	for (size_t i = 0; i < length; i++) {
+		char c = data[i];
+		if (c == set.bytes[0] || c == set.bytes[1]
+			|| c == set.bytes[2] || c == set.bytes[3]) {
+			return (i);
+		}
+	}
+	return (length);
+}
+
+static size_t crlf_scalar(const char* data, size_t length) {
+	for (size_t i = 0; i + 4 <= length; i++) {
+		if (data[i] == '\r' && data[i + 1] == '\n' && data[i + 2] == '\r' && data[i + 3] == '\n') {
+			return (i);
+		}
+	}
+	return (std::string::npos);
+}
+
+#ifdef WS_SCAN_X86
+
+static size_t crlf_sse2(const char* data, size_t length) {
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+	size_t i = 0;
+	for (; i + 16 + 3 <= length; i += 16) {
+		const char* p = data + i;
+		__m128i hits = _mm_and_si128(
+			_mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), cr),
+						  _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1)), lf)),
+			_mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2)), cr),
+						  _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 3)), lf)));
+		int mask = _mm_movemask_epi8(hits);
+		if (mask != 0) {
+			return (i + __builtin_ctz(static_cast<unsigned int>(mask)));
+		}
+	}
+	size_t tail = crlf_scalar(data + i, length - i);
+	return (tail == std::string::npos ? tail : i + tail);
+}
+
+__attribute__((target("avx2")))
+static size_t crlf_avx2(const char* data, size_t length) {
+	const __m256i cr = _mm256_set1_epi8('\r');
+	const __m256i lf = _mm256_set1_epi8('\n');
+	size_t i = 0;
+	for (; i + 32 + 3 <= length; i += 32) {
+		const char* p = data + i;
+		__m256i hits = _mm256_and_si256(
+			_mm256_and_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), cr),
+							 _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1)), lf)),
+			_mm256_and_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 2)), cr),
+							 _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 3)), lf)));
+		unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hits));
+		if (mask != 0) {
+			return (i + __builtin_ctz(mask));
+		}
+	}
+	size_t tail = crlf_sse2(data + i, length - i);
+	return (tail == std::string::npos ? tail : i + tail);
+}
+
+static size_t scan_sse2(const char* data, size_t length, const t_scan_set& set) {
+	const __m128i d0 = _mm_set1_epi8(set.bytes[0]);
+	const __m128i d1 = _mm_set1_epi8(set.bytes[1]);
+	const __m128i d2 = _mm_set1_epi8(set.bytes[2]);
+	const __m128i d3 = _mm_set1_epi8(set.bytes[3]);
+	size_t i = 0;
+	for (; i + 16 <= length; i += 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		__m128i hits = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(block, d0), _mm_cmpeq_epi8(block, d1)),
+			_mm_or_si128(_mm_cmpeq_epi8(block, d2), _mm_cmpeq_epi8(block, d3)));
+		int mask = _mm_movemask_epi8(hits);
+		if (mask != 0) {
+			return (i + __builtin_ctz(static_cast<unsigned int>(mask)));
+		}
+	}
+	return (i + scan_scalar(data + i, length - i, set));
+}
+
+__attribute__((target("avx2")))
+static size_t scan_avx2(const char* data, size_t length, const t_scan_set& set) {
+	const __m256i d0 = _mm256_set1_epi8(set.bytes[0]);
+	const __m256i d1 = _mm256_set1_epi8(set.bytes[1]);
+	const __m256i d2 = _mm256_set1_epi8(set.bytes[2]);
+	const __m256i d3 = _mm256_set1_epi8(set.bytes[3]);
+	size_t i = 0;
+	for (; i + 32 <= length; i += 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+		__m256i hits = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(block, d0), _mm256_cmpeq_epi8(block, d1)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(block, d2), _mm256_cmpeq_epi8(block, d3)));
+		unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hits));
+		if (mask != 0) {
+			return (i + __builtin_ctz(mask));
+		}
+	}
+	return (i + scan_sse2(data + i, length - i, set));
+}
+
+#endif
+
+struct s_scan_kernel {
+	t_scan_fn   scan;
+	t_crlf_fn   crlf;
+	const char* name;
+};
+
+/**
+ * @brief Picks the widest kernel the running CPU supports.
+ */
+static s_scan_kernel select_kernel() {
+	s_scan_kernel kernel;
+#ifdef WS_SCAN_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		kernel.scan = scan_avx2;
+		kernel.crlf = crlf_avx2;
+		kernel.name = "avx2";
+		return (kernel);
+	}
+	kernel.scan = scan_sse2;
+	kernel.crlf = crlf_sse2;
+	kernel.name = "sse2";
+	return (kernel);
+#else
+	kernel.scan = scan_scalar;
+	kernel.crlf = crlf_scalar;
+	kernel.name = "scalar";
+	return (kernel);
+#endif
+}
+
+// Selected during static initialization, before any worker thread exists.
+static const s_scan_kernel g_kernel = select_kernel();
+
+/**
+ * @brief Builds a delimiter set from a string of one to four bytes.
+ */
+t_scan_set ws_scan_set(const char* delimiters) {
+	t_scan_set set;
+	size_t count = 0;
+	while (count < 4 && delimiters[count] != '\0') {
+		set.bytes[count] = delimiters[count];
+		count++;
+	}
+	for (size_t i = count; i < 4; i++) {
+		set.bytes[i] = count ? set.bytes[count - 1] : '\0';
+	}
+	return (set);
+}
+
+/**
+ * @brief Finds the first byte of `data` that belongs to `set`.
+ *
+ * @param data Bytes to scan.
+ * @param length Bytes in `data`.
+ * @param set Delimiters.
+ * @return Offset of the first delimiter, or `length` if there is none.
+ */
+size_t ws_scan(const char* data, size_t length, const t_scan_set& set) {
+	return (g_kernel.scan(data, length, set));
+}
+
+/**
+ * @brief Finds the "\r\n\r\n" header delimiter, resuming a previous scan.
+ *
+ * Only the bytes from `resume` on are scanned, so a header that arrives in
+ * many reads is scanned once in total instead of once per read. The last
+ * three bytes are scanned again by the next call, in case the delimiter is
+ * split between two reads.
+ *
+ * @param data Read buffer.
+ * @param length Bytes in the buffer.
+ * @param resume In: first offset not scanned yet (0 for a new request).
+ *               Out: where the next call has to start.
+ * @return Offset of the delimiter's first byte, or `std::string::npos`.
+ */
+size_t ws_find_header_end(const char* data, size_t length, size_t& resume) {
+	if (resume >= length) {
+		return (std::string::npos);
+	}
+	size_t found = g_kernel.crlf(data + resume, length - resume);
+	if (found != std::string::npos) {
+		return (resume + found);
+	}
+	if (length > resume + 3) {
+		resume = length - 3;
+	}
+	return (std::string::npos);
+}
+
+/**
+ * @brief Name of the kernel in use: `avx2`, `sse2` or `scalar`.
+ */
+const char* ws_scan_kernel() {
+	return (g_kernel.name);
+}
@@ -17,32 +17,134 @@
 #include <sys/stat.h>
 #include <map>
 #include "webserver.hpp"
-#include "ServerManager.hpp"
+#include "ServerCluster.hpp"
+#include "ProcessSupervisor.hpp"
+#include "BinaryUpgrade.hpp"
 #include <signal.h>
 
-ServerManager* running_server = NULL;
+ServerCluster* running_server = NULL;
+ProcessSupervisor* running_supervisor = NULL;
+BinaryUpgrade* running_upgrade = NULL;
 
 /**
  * @brief Signal handler to end webserver execution
  *
  * Due to webserver execution is an endless loop, a handler to close it properly
- * is needed. SIGINT, SIGTERM and SIGTSTP are allowed.
+ * is needed. SIGINT, SIGTERM and SIGTSTP are allowed. The handler only asks
+ * the workers to stop; resources are released once their loops return. With
+ * worker processes, the supervisor forwards the request (see ProcessSupervisor::stop).
  *
  * @param sig Received signal.
  */
 void signal_handler(int sig) {
-	if (running_server != NULL) {
+	if (running_supervisor != NULL) {
+		running_supervisor->stop();
+	} else if (running_server != NULL) {
 		std::cout << "\nReceived signal " << sig << ". Shutting down server..." << std::endl;
-		running_server->turn_off_server();
+		running_server->stop();
 	}
 }
 
+/**
+ * @brief Signal handler of the graceful shutdown (SIGQUIT).
+ *
+ * The server stops accepting, serves the clients it has and exits. A new
+ * binary sends it once it took over the listeners (see BinaryUpgrade).
+ *
+ * @param sig Received signal.
+ */
+void drain_handler(int sig) {
+	(void)sig;
+	if (running_upgrade != NULL) {
+		running_upgrade->disable();
+	}
+	if (running_supervisor != NULL) {
+		running_supervisor->drain();
+	} else if (running_server != NULL) {
+		running_server->drain();
+	}
+}
+
+/**
+ * @brief Signal handler of the binary upgrade (SIGUSR2): starts the new binary.
+ *
+ * @param sig Received signal.
+ */
+void upgrade_handler(int sig) {
+	(void)sig;
+	if (running_upgrade != NULL) {
+		running_upgrade->start();
+	}
+}
+
+/**
+ * @brief Signal handler of the configuration reload (SIGHUP).
+ *
+ * Only flags the request: the configuration is parsed again by `main`, out
+ * of the handler, once the running loop returned.
+ *
+ * @param sig Received signal.
+ */
+void reload_handler(int sig) {
+	(void)sig;
+	if (running_supervisor != NULL) {
+		running_supervisor->request_reload();
+	} else if (running_server != NULL) {
+		running_server->request_reload();
+	}
+}
+
+/**
+ * @brief Installs the signal handlers of the server.
+ *
+ * SIGHUP is installed without `SA_RESTART`, so it interrupts the master
+ * waiting for its workers (see ProcessSupervisor::run).
+ */
+void set_signal_handlers() {
+	struct sigaction reload;
+	std::memset(&reload, 0, sizeof(reload));
+	reload.sa_handler = reload_handler;
+	sigemptyset(&reload.sa_mask);
+	reload.sa_flags = 0;
+	sigaction(SIGHUP, &reload, NULL);
+	signal(SIGINT, signal_handler);
+	signal(SIGTERM, signal_handler);
+	signal(SIGTSTP, signal_handler);
+	signal(SIGQUIT, drain_handler);
+	signal(SIGUSR2, upgrade_handler);
+	signal(SIGPIPE, SIG_IGN);
+}
+
+/**
+ * @brief Hands the listeners of a reloaded configuration to the binary upgrade.
+ *
+ * SIGUSR2 is blocked meanwhile, as `start` reads what `prepare` builds.
+ *
+ * @param upgrade Binary upgrade of the process.
+ * @param listeners Listening sockets after the reload, `port -> fd`.
+ */
+void refresh_upgrade(BinaryUpgrade& upgrade, const std::map<int, int>& listeners) {
+	sigset_t usr2;
+	sigset_t previous;
+	sigemptyset(&usr2);
+	sigaddset(&usr2, SIGUSR2);
+	sigprocmask(SIG_BLOCK, &usr2, &previous);
+	upgrade.prepare(listeners);
+	sigprocmask(SIG_SETMASK, &previous, NULL);
+}
+
 /**
  * @brief Main function - Entry point.
  *
  * @param argc count of arguments.
  * @param argv arguments of exec.
  *
+ * A SIGHUP makes the running server return: the configuration file is parsed
+ * again (see reload_file) and, if valid, handed over before running again.
+ *
+ * @see BinaryUpgrade: Listeners inherited from, and handed over to, another binary (SIGUSR2).
+ * @see ProcessSupervisor: With `worker_processes`, binds once and supervises worker processes.
+ * @see ServerCluster: Runs one ServerManager per configured worker.
  * @see ServerManager: That control all the workflow.
  */
 int main(int argc, char **argv) {
@@ -56,13 +158,50 @@ int main(int argc, char **argv) {
 		exit(1);
 	configs = parse_file(argv[1], &logger);
 
+	int status = 0;
 	try {
-		ServerManager server_manager(configs, &logger);
-		signal(SIGINT, signal_handler);
-		signal(SIGTERM, signal_handler);
-		signal(SIGTSTP, signal_handler);
-		running_server = &server_manager;
-		server_manager.run();
+		BinaryUpgrade upgrade(argc, argv, &logger);
+		std::map<int, int> listeners;
+		upgrade.inherit(configs);
+		if (configs[0].ws_processes > 0) {
+			ProcessSupervisor supervisor(configs, &logger);
+			supervisor.listeners(listeners);
+			upgrade.prepare(listeners);
+			running_supervisor = &supervisor;
+			running_upgrade = &upgrade;
+			set_signal_handlers();
+			upgrade.notify_parent();
+			while ((status = supervisor.run()) == PS_RELOAD) {
+				std::vector<ServerConfig> next;
+				if (reload_file(argv[1], &logger, next) && supervisor.reload(next)) {
+					listeners.clear();
+					supervisor.listeners(listeners);
+					refresh_upgrade(upgrade, listeners);
+				}
+			}
+			running_upgrade = NULL;
+			running_supervisor = NULL;
+		} else {
+			ServerCluster server_cluster(configs, &logger);
+			upgrade.release_inherited(configs);
+			server_cluster.listeners(listeners);
+			upgrade.prepare(listeners);
+			running_server = &server_cluster;
+			running_upgrade = &upgrade;
+			set_signal_handlers();
+			upgrade.notify_parent();
+			while (server_cluster.run()) {
+				std::vector<ServerConfig> next;
+				if (reload_file(argv[1], &logger, next)) {
+					server_cluster.reload(next);
+					listeners.clear();
+					server_cluster.listeners(listeners);
+					refresh_upgrade(upgrade, listeners);
+				}
+			}
+			running_upgrade = NULL;
+			running_server = NULL;
+		}
 	} catch (Logger::NoLoggerPointer& e) {
 		std::cerr << "ERROR: " << e.what() << std::endl;
 	} catch (WebServerException& e){
@@ -70,5 +209,5 @@ int main(int argc, char **argv) {
 	} catch (std::exception& e) {
 		std::cerr << "ERROR: " << e.what() << std::endl;
 	}
-	return (0);
+	return (status);
 }
@@ -200,10 +200,46 @@ ServerConfig parse_server_block(std::vector<std::string>::iterator start, std::v
     return server;
 }
 
+/**
+ * @brief Joins the lines in [start, end), one per line.
+ */
+static std::string join_lines(std::vector<std::string>::iterator start, std::vector<std::string>::iterator end)
+{
+    std::string joined;
+    for (std::vector<std::string>::iterator it = start; it != end; ++it)
+        joined += *it + "\n";
+    return joined;
+}
+
+/**
+ * @brief Lines of the configuration outside every server block: the global directives.
+ *
+ * @param rawLines Vector of configuration file lines.
+ * @return The global lines, joined.
+ */
+static std::string global_source(std::vector<std::string>& rawLines)
+{
+    std::string source;
+    for (std::vector<std::string>::iterator it = rawLines.begin(); it != rawLines.end(); it++)
+    {
+        if (find_exact_string(*it, "server"))
+        {
+            it = skip_block(it, find_block_end(it, rawLines.end()));
+            if (it == rawLines.end())
+                break;
+            continue;
+        }
+        source += *it + "\n";
+    }
+    return source;
+}
+
 /**
  * @brief Parses all server configurations from the raw configuration lines.
  *
  * Processes the entire configuration file and extracts all server blocks.
+ * Each server keeps the lines it was parsed from (`source`): its block and the
+ * global directives. A reload (`reload_file`) tells unchanged servers by it.
  *
  * @param rawLines Vector of configuration file lines.
  * @param logger Pointer to the logger instance.
@@ -215,10 +251,13 @@ std::vector<ServerConfig> parse_servers(std::vector<std::string> rawLines, Logge
     std::vector<std::string>::iterator start;
     std::vector<std::string>::iterator end;
     std::vector<ServerConfig> servers;
+    ServerConfig global;
 
     logger->log(LOG_DEBUG, "parse_servers", "Checking brackets");
     if (!check_brackets(rawLines.begin(), rawLines.end()))  
         logger->fatal_log("parse_servers", "Brackets are not closed");
+    parse_global_directives(rawLines, logger, global);
+    std::string globals = global_source(rawLines);
     for (std::vector<std::string>::iterator it = rawLines.begin(); it != rawLines.end(); it++)
     {
         if (find_exact_string(*it, "server"))
@@ -228,7 +267,9 @@ std::vector<ServerConfig> parse_servers(std::vector<std::string> rawLines, Logge
             start = it;
             end =   find_block_end(start, rawLines.end());
             servers.push_back(parse_server_block(start, end, logger));
+            inherit_global_config(global, servers.back());
             it = skip_block(start, end);
+            servers.back().source = globals + join_lines(start, it);
         }
     }
 
@@ -259,3 +300,29 @@ std::vector<ServerConfig> parse_file(std::string path, Logger* logger)
         logger->fatal_log("parse_file", "No servers foundss");
     return servers;
 }
+
+/**
+ * @brief Parses a configuration file again, on a running server.
+ *
+ * Same parsing as `parse_file`, but an invalid file is reported instead of
+ * ending the process: `fatal_log` throws while it runs, so the server keeps
+ * the configuration it is serving.
+ *
+ * @param path Path to the configuration file.
+ * @param logger Pointer to the logger instance.
+ * @param servers Output. Receives the parsed configurations on success.
+ * @return `true` if the file was parsed, `false` if it is not valid.
+ */
+bool reload_file(const std::string& path, Logger* logger, std::vector<ServerConfig>& servers)
+{
+    logger->throw_on_fatal(true);
+    try {
+        servers = parse_file(path, logger);
+    } catch (const Logger::FatalError& e) {
+        logger->throw_on_fatal(false);
+        logger->log_error("reload_file", "Invalid configuration " + path + " " + e.what());
+        return false;
+    }
+    logger->throw_on_fatal(false);
+    return true;
+}
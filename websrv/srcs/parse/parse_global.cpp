@@ -0,0 +1,321 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   parse_global.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mporras- <manon42bcn@yahoo.com>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:12:41 by mporras-          #+#    #+#             */
+/*   Updated: 2026/10/18 10:12:41 by mporras-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "webserver.hpp"
+
+/**
+ * @brief Parses the directives placed outside of any server block.
+ *
+ * Global directives tune the web server process itself (event loop, workers...)
+ * rather than a single virtual host. They are collected into a template
+ * ServerConfig and later copied into each parsed server through
+ * inherit_global_config, following the `ws_` "general config" convention.
+ *
+ * Server blocks are skipped; unknown top-level lines are ignored, as they
+ * were before global directives existed.
+ *
+ * @param rawLines Vector of configuration file lines.
+ * @param logger Pointer to the logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if a global directive is invalid.
+ */
+void parse_global_directives(std::vector<std::string>& rawLines, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing global directives");
+    for (std::vector<std::string>::iterator it = rawLines.begin(); it != rawLines.end(); it++)
+    {
+        if (find_exact_string(*it, "server"))
+            it = skip_block(it, find_block_end(it, rawLines.end()));
+        else if (find_exact_string(*it, "event_backend"))
+            parse_event_backend(it, logger, global);
+        else if (find_exact_string(*it, "workers"))
+            parse_workers(it, logger, global);
+        else if (find_exact_string(*it, "worker_processes"))
+            parse_worker_processes(it, logger, global);
+        else if (find_exact_string(*it, "worker_cpu_affinity"))
+            parse_worker_cpu_affinity(it, logger, global);
+        else if (find_exact_string(*it, "io_threads"))
+            parse_io_threads(it, logger, global);
+        else if (find_exact_string(*it, "file_cache_size"))
+            parse_file_cache_size(it, logger, global);
+        else if (find_exact_string(*it, "file_cache_valid"))
+            parse_file_cache_valid(it, logger, global);
+        else if (find_exact_string(*it, "open_file_cache"))
+            parse_open_file_cache(it, logger, global);
+        else if (find_exact_string(*it, "negative_cache_valid"))
+            parse_negative_cache_valid(it, logger, global);
+        else if (find_exact_string(*it, "negative_cache_check_dir"))
+            parse_negative_cache_check_dir(it, logger, global);
+        else if (find_exact_string(*it, "file_watch"))
+            parse_file_watch(it, logger, global);
+        if (it == rawLines.end())
+            break;
+    }
+}
+
+/**
+ * @brief Copies the global (`ws_`) values into a parsed server configuration.
+ *
+ * @param global ServerConfig holding the global values.
+ * @param server Server configuration that receives them.
+ */
+void inherit_global_config(const ServerConfig& global, ServerConfig& server) {
+    server.ws_event_backend = global.ws_event_backend;
+    server.ws_workers = global.ws_workers;
+    server.ws_processes = global.ws_processes;
+    server.ws_cpu_affinity = global.ws_cpu_affinity;
+    server.ws_io_threads = global.ws_io_threads;
+    server.ws_file_cache_size = global.ws_file_cache_size;
+    server.ws_file_cache_valid = global.ws_file_cache_valid;
+    server.ws_open_file_cache = global.ws_open_file_cache;
+    server.ws_negative_cache_valid = global.ws_negative_cache_valid;
+    server.ws_negative_cache_check_dir = global.ws_negative_cache_check_dir;
+    server.ws_file_watch = global.ws_file_watch;
+}
+
+/**
+ * @brief Parses an event_backend directive.
+ *
+ * Accepted values are `auto`, `poll`, `epoll` and `io_uring`.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the backend is not valid.
+ */
+void parse_event_backend(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing event backend");
+    std::string backend = get_value(*it, "event_backend");
+    if (check_event_backend(backend))
+        global.ws_event_backend = string_to_event_backend(backend);
+    else
+        logger->fatal_log("parse_global", "Event backend " + backend + " is not valid.");
+}
+
+/**
+ * @brief Parses a workers directive.
+ *
+ * Sets how many event loops (ServerManager instances) run in parallel, each one
+ * on its own thread. `auto` uses one worker per online CPU.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the value is not `auto` or a number in [1, WS_MAX_WORKERS].
+ */
+void parse_workers(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing workers");
+    std::string workers = get_value(*it, "workers");
+    if (!check_workers(workers))
+        logger->fatal_log("parse_global", "Workers " + workers + " is not valid.");
+    if (workers == "auto") {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (cpus < 1)
+            cpus = 1;
+        if (cpus > WS_MAX_WORKERS)
+            cpus = WS_MAX_WORKERS;
+        global.ws_workers = (size_t)cpus;
+    } else {
+        global.ws_workers = (size_t)atoi(workers.c_str());
+    }
+}
+
+/**
+ * @brief Parses a worker_processes directive.
+ *
+ * With a value above `0`, a master process binds the listeners and supervises
+ * that many worker processes, each one running `workers` event loops. `auto`
+ * uses one process per online CPU. `0` (default) serves from a single process.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the value is not `auto` or a number in [0, WS_MAX_WORKERS].
+ */
+void parse_worker_processes(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing worker processes");
+    std::string processes = get_value(*it, "worker_processes");
+    if (!check_worker_processes(processes))
+        logger->fatal_log("parse_global", "Worker processes " + processes + " is not valid.");
+    if (processes == "auto") {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (cpus < 1)
+            cpus = 1;
+        if (cpus > WS_MAX_WORKERS)
+            cpus = WS_MAX_WORKERS;
+        global.ws_processes = (size_t)cpus;
+    } else {
+        global.ws_processes = (size_t)atoi(processes.c_str());
+    }
+}
+
+/**
+ * @brief Parses a worker_cpu_affinity directive.
+ *
+ * `on` pins each worker process to one of the CPUs the server may run on
+ * (Linux). `off` (default) leaves scheduling to the system.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the value is not `on` or `off`.
+ */
+void parse_worker_cpu_affinity(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing worker cpu affinity");
+    std::string affinity = get_value(*it, "worker_cpu_affinity");
+    if (check_on_off(affinity))
+        global.ws_cpu_affinity = (affinity == "on");
+    else
+        logger->fatal_log("parse_global", "Worker cpu affinity " + affinity + " is not valid.");
+}
+
+/**
+ * @brief Parses an io_threads directive.
+ *
+ * Threads each worker runs for blocking file system work (directory listings,
+ * uploads, deletions), so a slow disk does not stall its event loop. `0` runs
+ * that work inline, on the event loop.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the value is not a number in [0, IO_POOL_MAX_THREADS].
+ */
+void parse_io_threads(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing io threads");
+    std::string threads = get_value(*it, "io_threads");
+    if (check_io_threads(threads))
+        global.ws_io_threads = (size_t)atoi(threads.c_str());
+    else
+        logger->fatal_log("parse_global", "IO threads " + threads + " is not valid.");
+}
+
+/**
+ * @brief Parses a file_cache_size directive.
+ *
+ * Byte budget of the static file cache of each worker, with a K/M/G suffix
+ * (`0k` disables the cache). Files bigger than an eighth of it are not cached.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the size is not valid.
+ */
+void parse_file_cache_size(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing file cache size");
+    std::string size = get_value(*it, "file_cache_size");
+    if (check_client_max_body_size(size))
+        global.ws_file_cache_size = string_to_bytes(size);
+    else
+        logger->fatal_log("parse_global", "File cache size " + size + " is not valid.");
+}
+
+/**
+ * @brief Parses a file_cache_valid directive.
+ *
+ * Milliseconds a cached file is served without checking it against the file
+ * system. `0` checks the file on every hit.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the value is not a number of milliseconds.
+ */
+void parse_file_cache_valid(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing file cache validity");
+    std::string valid = get_value(*it, "file_cache_valid");
+    if (check_milliseconds(valid))
+        global.ws_file_cache_valid = (size_t)atol(valid.c_str());
+    else
+        logger->fatal_log("parse_global", "File cache validity " + valid + " is not valid.");
+}
+
+/**
+ * @brief Parses an open_file_cache directive.
+ *
+ * Files each listener keeps open, with their metadata, to serve them without
+ * opening and `stat()`ing them again. `0` opens files on each request.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the value is not a number of files.
+ */
+void parse_open_file_cache(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing open file cache");
+    std::string files = get_value(*it, "open_file_cache");
+    if (check_open_file_cache(files))
+        global.ws_open_file_cache = (size_t)atol(files.c_str());
+    else
+        logger->fatal_log("parse_global", "Open file cache " + files + " is not valid.");
+}
+
+/**
+ * @brief Parses a negative_cache_valid directive.
+ *
+ * Milliseconds a path found missing is answered with a 404 without resolving
+ * it again. `0` disables the negative cache.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the value is not a number of milliseconds.
+ */
+void parse_negative_cache_valid(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing negative cache validity");
+    std::string valid = get_value(*it, "negative_cache_valid");
+    if (check_milliseconds(valid))
+        global.ws_negative_cache_valid = (size_t)atol(valid.c_str());
+    else
+        logger->fatal_log("parse_global", "Negative cache validity " + valid + " is not valid.");
+}
+
+/**
+ * @brief Parses a negative_cache_check_dir directive.
+ *
+ * `on` checks, on each negative cache hit, the deepest existing directory of
+ * the missing path: a file created below it ends the entry at once, for the
+ * cost of one `stat()`. `off` (default) relies on the validity alone.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the value is not `on` or `off`.
+ */
+void parse_negative_cache_check_dir(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing negative cache directory check");
+    std::string check = get_value(*it, "negative_cache_check_dir");
+    if (check_on_off(check))
+        global.ws_negative_cache_check_dir = (check == "on");
+    else
+        logger->fatal_log("parse_global", "Negative cache directory check " + check + " is not valid.");
+}
+
+/**
+ * @brief Parses a file_watch directive.
+ *
+ * `on` (default) watches the served trees with inotify, where available: the
+ * caches drop what a change affects as soon as it happens, so their validity
+ * times may be long. `off` relies on the validity times alone.
+ *
+ * @param it Current iterator position in configuration.
+ * @param logger Pointer to logger instance.
+ * @param global ServerConfig used as holder of the global values.
+ * @throw Logger::fatal_log if the value is not `on` or `off`.
+ */
+void parse_file_watch(std::vector<std::string>::iterator& it, Logger* logger, ServerConfig& global) {
+    logger->log(LOG_DEBUG, "parse_global", "Parsing file watch");
+    std::string watch = get_value(*it, "file_watch");
+    if (check_on_off(watch))
+        global.ws_file_watch = (watch == "on");
+    else
+        logger->fatal_log("parse_global", "File watch " + watch + " is not valid.");
+}
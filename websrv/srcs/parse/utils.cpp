@@ -314,6 +314,24 @@ t_mode string_to_error_mode(std::string error_mode) {
     return INVALID_ERROR_MODE;
 }
 
+/**
+ * @brief Converts an event backend string to its enumerated type.
+ *
+ * @param backend The event backend as string.
+ * @return The corresponding t_event_backend enum value.
+ */
+t_event_backend string_to_event_backend(std::string backend) {
+    if (backend == "auto")
+        return BACKEND_AUTO;
+    if (backend == "poll")
+        return BACKEND_POLL;
+    if (backend == "epoll")
+        return BACKEND_EPOLL;
+    if (backend == "io_uring")
+        return BACKEND_URING;
+    return INVALID_BACKEND;
+}
+
 /**
  * @brief Joins two paths together, handling slashes appropriately.
  *
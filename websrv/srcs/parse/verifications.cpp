@@ -298,6 +298,56 @@ bool check_error_mode(std::string error_mode)
     return (error_mode == "literal" || error_mode == "template");
 }
 
+bool check_event_backend(std::string backend)
+{
+    return (string_to_event_backend(backend) != INVALID_BACKEND);
+}
+
+bool check_workers(std::string workers)
+{
+    if (workers == "auto")
+        return true;
+    if (workers.empty() || workers.find_first_not_of("0123456789") != std::string::npos
+        || workers.size() > 3)
+        return false;
+    int count = atoi(workers.c_str());
+    return (count >= 1 && count <= WS_MAX_WORKERS);
+}
+
+bool check_worker_processes(std::string processes)
+{
+    if (processes == "auto")
+        return true;
+    if (processes.empty() || processes.find_first_not_of("0123456789") != std::string::npos
+        || processes.size() > 3)
+        return false;
+    return (atoi(processes.c_str()) <= WS_MAX_WORKERS);
+}
+
+bool check_io_threads(std::string threads)
+{
+    if (threads.empty() || threads.find_first_not_of("0123456789") != std::string::npos
+        || threads.size() > 2)
+        return false;
+    return (atoi(threads.c_str()) <= IO_POOL_MAX_THREADS);
+}
+
+bool check_milliseconds(std::string milliseconds)
+{
+    if (milliseconds.empty() || milliseconds.size() > 9
+        || milliseconds.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+    return true;
+}
+
+bool check_open_file_cache(std::string files)
+{
+    if (files.empty() || files.size() > 5
+        || files.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+    return true;
+}
+
 bool check_duplicate_servers(std::vector<ServerConfig> servers)
 {
     for (size_t i = 0; i < servers.size(); i++)
@@ -317,6 +367,11 @@ bool check_cgi(std::string cgi)
     return (cgi == "on" || cgi == "off");
 }
 
+bool check_on_off(std::string value)
+{
+    return (value == "on" || value == "off");
+}
+
 bool check_obligatory_params(ServerConfig& server, Logger* logger)
 {
     logger->log(LOG_DEBUG, "check_obligatory_params", "Checking obligatory parameters");